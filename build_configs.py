@@ -2,6 +2,8 @@ release = ["-DCMAKE_BUILD_TYPE=Release"]
 debug = ["-DCMAKE_BUILD_TYPE=Debug"]
 # USE_GLIBCXX_DEBUG is not compatible with USE_LP (see issue983).
 glibcxx_debug = ["-DCMAKE_BUILD_TYPE=Debug", "-DUSE_LP=NO", "-DUSE_GLIBCXX_DEBUG=YES"]
+# Time the profiling scopes (see src/search/utils/profiling.h).
+release_profiling = ["-DCMAKE_BUILD_TYPE=Release", "-DUSE_PROFILING=YES"]
 minimal = ["-DCMAKE_BUILD_TYPE=Release", "-DDISABLE_PLUGINS_BY_DEFAULT=YES"]
 
 DEFAULT = "release"
@@ -4,6 +4,7 @@ import re
 import sys
 
 from . import aliases
+from . import cache
 from . import returncodes
 from . import util
 
@@ -276,6 +277,9 @@ def _set_translator_output_options(parser, args):
 
     args.search_input = args.sas_file
     args.translate_options += ["--sas-file", args.search_input]
+    if args.translate_workers is not None:
+        args.translate_options += [
+            "--grounding-workers", str(args.translate_workers)]
 
 
 def _get_time_limit_in_seconds(limit, parser):
@@ -391,6 +395,11 @@ def parse_args():
     driver_other.add_argument(
         "--transform-task",
         help='path to or name of external program that transforms output.sas (e.g. h2-mutexes)')
+    driver_other.add_argument(
+        "--translate-workers", metavar="N", type=int,
+        help="ground the task with N processes (passes --grounding-workers "
+            "to the translator; 0: one per CPU). The translator output is "
+            "the same for all N.")
     driver_other.add_argument(
         "--validate", action="store_true",
         help='validate plans (implied by --debug); needs "validate" (VAL) on PATH')
@@ -412,6 +421,19 @@ def parse_args():
         help="keep translator output file (implied by --sas-file, default: "
             "delete file if translator and search component are active)")
 
+    driver_other.add_argument(
+        "--cache-dir", metavar="DIR", default=os.environ.get("FD_CACHE_DIR"),
+        help="reuse the output of the translator and the task transformation "
+            "for identical tasks and options from a cache in DIR. Search "
+            "options can store further files for the task in the directory "
+            "{} (default: value of the environment variable FD_CACHE_DIR, "
+            "no cache if unset)".format(cache.CACHE_DIR_PLACEHOLDER))
+    driver_other.add_argument(
+        "--cache-size-limit", metavar="SIZE", default="1G",
+        help="remove the least recently used cache entries when the cache "
+            "is larger than SIZE (same units as memory limits, default: "
+            "%(default)s)")
+
     driver_other.add_argument(
         "--portfolio", metavar="FILE",
         help="run a portfolio specified in FILE")
@@ -464,6 +486,8 @@ def parse_args():
     _set_translator_output_options(parser, args)
 
     _convert_limits_to_ints(parser, args)
+    args.cache_size_limit = _get_memory_limit_in_bytes(
+        args.cache_size_limit, parser)
 
     if args.alias:
         try:
@@ -0,0 +1,200 @@
+"""Content-addressed cache for the output of the preprocessing components.
+
+Each cache entry is a directory named after the fingerprint of a task.
+For PDDL input, the fingerprint covers the normalized domain and problem
+files, the translator options, the translator sources and the task
+transformation executable. For translated input, it covers the content
+of the input file. An entry holds the translator (or transformation)
+output as "output.sas" and may hold arbitrary other files written by
+the search component, e.g., symmetry generators or abstractions. Search
+options can refer to the entry directory with TASK_CACHE_DIR.
+
+The total size of the cache is bounded. When an entry is added and the
+cache is too large, the least recently used entries are removed. Entries
+are created atomically by renaming a temporary directory, so several
+planner runs can share a cache directory.
+"""
+
+import hashlib
+import logging
+import os
+import re
+import shutil
+import tempfile
+
+CACHE_FORMAT_VERSION = "1"
+CACHE_DIR_PLACEHOLDER = "TASK_CACHE_DIR"
+CACHED_SAS_FILE = "output.sas"
+TEMPORARY_PREFIX = "tmp-"
+
+_PDDL_COMMENT = re.compile(r";[^\n]*")
+_PDDL_WHITESPACE = re.compile(r"\s+")
+_PDDL_PARENTHESES = re.compile(r"\s*([()])\s*")
+
+
+def normalize_pddl(text):
+    """Remove comments and redundant whitespace from a PDDL file. PDDL
+    is case-insensitive and the translator lower-cases all names, so
+    files that only differ in case have the same normal form."""
+    text = _PDDL_COMMENT.sub(" ", text.lower())
+    text = _PDDL_WHITESPACE.sub(" ", text)
+    return _PDDL_PARENTHESES.sub(r"\1", text).strip()
+
+
+def _update_with_string(digest, label, text):
+    data = text.encode("utf-8")
+    digest.update(label.encode("utf-8"))
+    digest.update(str(len(data)).encode("ascii"))
+    digest.update(b":")
+    digest.update(data)
+
+
+def _update_with_file(digest, label, filename):
+    digest.update(label.encode("utf-8"))
+    with open(filename, "rb") as f:
+        for block in iter(lambda: f.read(1 << 20), b""):
+            digest.update(block)
+    digest.update(b"\0")
+
+
+def _update_with_sources(digest, directory):
+    for dirpath, dirnames, filenames in os.walk(directory):
+        dirnames.sort()
+        for filename in sorted(filenames):
+            if filename.endswith(".py"):
+                path = os.path.join(dirpath, filename)
+                _update_with_file(
+                    digest, os.path.relpath(path, directory), path)
+
+
+# Translator options with one argument that do not influence the output.
+IGNORED_TRANSLATE_OPTIONS = ["--sas-file", "--grounding-workers"]
+
+
+def _get_translate_options(translate_options):
+    """Return the translator options that influence the translator
+    output."""
+    options = []
+    skip_next = False
+    for option in translate_options:
+        if skip_next:
+            skip_next = False
+        elif option in IGNORED_TRANSLATE_OPTIONS:
+            skip_next = True
+        else:
+            options.append(option)
+    return options
+
+
+def compute_pddl_fingerprint(translate_inputs, translate_options,
+                             translator, transform_executable):
+    digest = hashlib.sha256()
+    _update_with_string(digest, "version", CACHE_FORMAT_VERSION)
+    for filename in translate_inputs:
+        with open(filename) as f:
+            _update_with_string(digest, "pddl", normalize_pddl(f.read()))
+    for option in _get_translate_options(translate_options):
+        _update_with_string(digest, "option", option)
+    _update_with_sources(digest, os.path.dirname(translator))
+    if transform_executable is not None:
+        _update_with_file(digest, "transform", transform_executable)
+    return digest.hexdigest()
+
+
+def compute_search_input_fingerprint(search_input):
+    digest = hashlib.sha256()
+    _update_with_string(digest, "version", CACHE_FORMAT_VERSION)
+    _update_with_file(digest, "input", search_input)
+    return digest.hexdigest()
+
+
+def _get_size(path):
+    size = 0
+    for dirpath, _, filenames in os.walk(path):
+        for filename in filenames:
+            try:
+                size += os.path.getsize(os.path.join(dirpath, filename))
+            except OSError:
+                # Removed concurrently by another planner run.
+                pass
+    return size
+
+
+class TaskCache:
+    def __init__(self, directory, size_limit):
+        self.directory = os.path.abspath(directory)
+        self.size_limit = size_limit
+        os.makedirs(self.directory, exist_ok=True)
+
+    def get_entry_dir(self, fingerprint):
+        return os.path.join(self.directory, fingerprint)
+
+    def lookup(self, fingerprint):
+        """Return the directory of the entry with the given fingerprint
+        and mark it as recently used, or None if there is no entry."""
+        entry_dir = self.get_entry_dir(fingerprint)
+        try:
+            os.utime(entry_dir)
+        except OSError:
+            return None
+        return entry_dir
+
+    def restore_sas_file(self, fingerprint, sas_file):
+        """Copy the cached translator output to sas_file. Return False if
+        the entry does not exist or does not contain translator output."""
+        entry_dir = self.lookup(fingerprint)
+        if entry_dir is None:
+            return False
+        try:
+            shutil.copyfile(os.path.join(entry_dir, CACHED_SAS_FILE), sas_file)
+        except OSError:
+            return False
+        return True
+
+    def add(self, fingerprint, sas_file=None):
+        """Create the entry with the given fingerprint, holding a copy of
+        sas_file if given, and return its directory. If the entry already
+        exists, it is kept as it is."""
+        entry_dir = self.get_entry_dir(fingerprint)
+        if self.lookup(fingerprint) is not None:
+            return entry_dir
+        tmp_dir = tempfile.mkdtemp(prefix=TEMPORARY_PREFIX, dir=self.directory)
+        try:
+            if sas_file is not None:
+                shutil.copyfile(sas_file, os.path.join(tmp_dir, CACHED_SAS_FILE))
+            os.rename(tmp_dir, entry_dir)
+        except OSError:
+            # Another planner run created the entry in the meantime.
+            shutil.rmtree(tmp_dir, ignore_errors=True)
+        self.evict(keep=fingerprint)
+        return entry_dir
+
+    def evict(self, keep=None):
+        """Remove least recently used entries until the cache fits into
+        the size limit. The entry with fingerprint keep is not removed."""
+        entries = []
+        total_size = 0
+        for name in os.listdir(self.directory):
+            path = os.path.join(self.directory, name)
+            if name.startswith(TEMPORARY_PREFIX) or not os.path.isdir(path):
+                continue
+            try:
+                last_use = os.path.getmtime(path)
+            except OSError:
+                continue
+            size = _get_size(path)
+            total_size += size
+            if name != keep:
+                entries.append((last_use, name, size))
+        entries.sort()
+        for _, name, size in entries:
+            if total_size <= self.size_limit:
+                break
+            logging.info("Removing cache entry {}".format(name))
+            shutil.rmtree(os.path.join(self.directory, name), ignore_errors=True)
+            total_size -= size
+
+
+def substitute_cache_dir(options, entry_dir):
+    return [option.replace(CACHE_DIR_PLACEHOLDER, entry_dir)
+            for option in options]
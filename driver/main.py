@@ -5,12 +5,17 @@ import shutil
 
 from . import aliases
 from . import arguments
+from . import cache
 from . import cleanup
 from . import limits
+from . import returncodes
 from . import run_components
 from . import util
 from . import __version__
 
+PREPROCESSING_COMPONENTS = ["translate", "transform_task"]
+
+
 def remove_plan_folder():
     plan_dir = "found_plans" 
     if os.path.exists(plan_dir):
@@ -41,22 +46,53 @@ def main():
     limits.print_limits("planner", args.overall_time_limit, args.overall_memory_limit)
     print()
 
+    components = args.components
+    task_cache, fingerprint = run_components.open_task_cache(args)
+    if task_cache and components[0] == "translate" and \
+            task_cache.restore_sas_file(fingerprint, args.sas_file):
+        print("Reusing translator output from cache entry {}".format(fingerprint))
+        print()
+        components = [component for component in components
+                      if component not in PREPROCESSING_COMPONENTS]
+    preprocessing = [component for component in components
+                     if component in PREPROCESSING_COMPONENTS]
+    if args.search_options and not args.portfolio:
+        if task_cache:
+            entry_dir = task_cache.get_entry_dir(fingerprint)
+            args.search_options = cache.substitute_cache_dir(
+                args.search_options, entry_dir)
+        elif any(cache.CACHE_DIR_PLACEHOLDER in option
+                 for option in args.search_options):
+            returncodes.exit_with_driver_input_error(
+                "{} may only be used with --cache-dir".format(
+                    cache.CACHE_DIR_PLACEHOLDER))
+
     exitcode = None
-    for component in args.components:
+    for component in components:
         if component == "translate":
-            (exitcode, continue_execution) = run_components.run_translate(args)
+            (component_exitcode, continue_execution) = run_components.run_translate(args)
         elif component == "transform_task":
-            (exitcode, continue_execution) = run_components.transform_task(args)
+            (component_exitcode, continue_execution) = run_components.transform_task(args)
         elif component == "search":
-            (exitcode, continue_execution) = run_components.run_search(args)
+            if task_cache:
+                # Create the entry for search input that is not cached.
+                task_cache.add(fingerprint)
+            (component_exitcode, continue_execution) = run_components.run_search(args)
             if not args.keep_sas_file:
                 print("Remove intermediate file {}".format(args.sas_file))
                 os.remove(args.sas_file)
         elif component == "validate":
-            (exitcode, continue_execution) = run_components.run_validate(args)
+            (component_exitcode, continue_execution) = run_components.run_validate(args)
         else:
             assert False, "Error: unhandled component: {}".format(component)
-        print("{component} exit code: {exitcode}".format(**locals()))
+        # Valid plans keep the exit code of the search, e.g.,
+        # SEARCH_PLAN_FOUND_AND_OUT_OF_MEMORY.
+        if component != "validate" or component_exitcode != returncodes.SUCCESS:
+            exitcode = component_exitcode
+        if (task_cache and continue_execution and preprocessing and
+                component == preprocessing[-1]):
+            task_cache.add(fingerprint, args.sas_file)
+        print("{component} exit code: {component_exitcode}".format(**locals()))
         print()
         if not continue_execution:
             print("Driver aborting after {}".format(component))
@@ -70,7 +106,8 @@ def main():
 
     # Exit with the exit code of the last component that ran successfully.
     # This means for example that if no plan was found, validate is not run,
-    # and therefore the return code is that of the search.
+    # and therefore the return code is that of the search. Successful
+    # validation also keeps the return code of the search.
     sys.exit(exitcode)
 
 
@@ -69,6 +69,11 @@ def generate_portfolio_exitcode(exitcodes):
     """
     print("Exit codes: {}".format(exitcodes))
     exitcodes = set(exitcodes)
+    # A configuration that found a plan and then reached the memory limit
+    # counts as both.
+    if SEARCH_PLAN_FOUND_AND_OUT_OF_MEMORY in exitcodes:
+        exitcodes.remove(SEARCH_PLAN_FOUND_AND_OUT_OF_MEMORY)
+        exitcodes.update([SUCCESS, SEARCH_OUT_OF_MEMORY])
     unrecoverable_codes = [code for code in exitcodes if is_unrecoverable(code)]
 
     # There are unrecoverable exit codes.
@@ -4,6 +4,7 @@ import os.path
 import subprocess
 import sys
 
+from . import cache
 from . import call
 from . import limits
 from . import portfolio_runner
@@ -47,6 +48,28 @@ def get_executable(build, rel_path):
     return abs_path
 
 
+def open_task_cache(args):
+    """Return the task cache and the fingerprint of the task if a cache
+    directory is given and the input can be fingerprinted, otherwise
+    (None, None)."""
+    if not args.cache_dir:
+        return (None, None)
+    if args.components[0] == "translate":
+        if not args.translate_inputs:
+            return (None, None)
+        translate = get_executable(args.build, REL_TRANSLATE_PATH)
+        transform = None
+        if "transform_task" in args.components:
+            transform = get_executable(args.build, args.transform_task)
+        fingerprint = cache.compute_pddl_fingerprint(
+            args.translate_inputs, args.translate_options, translate, transform)
+    else:
+        if args.search_input is None:
+            return (None, None)
+        fingerprint = cache.compute_search_input_fingerprint(args.search_input)
+    return (cache.TaskCache(args.cache_dir, args.cache_size_limit), fingerprint)
+
+
 def run_translate(args):
     logging.info("Running translator.")
     time_limit = limits.get_time_limit(
@@ -150,12 +173,12 @@ def run_search(args):
                 time_limit=time_limit,
                 memory_limit=memory_limit)
         except subprocess.CalledProcessError as err:
-            # TODO: if we ever add support for SEARCH_PLAN_FOUND_AND_* directly
-            # in the planner, this assertion no longer holds. Furthermore, we
-            # would need to return (err.returncode, True) if the returncode is
-            # in [0..10].
+            # The planner reports SEARCH_PLAN_FOUND_AND_OUT_OF_MEMORY if it
+            # stopped at the memory limit after writing the plans found so
+            # far, which can still be validated.
+            if 0 < err.returncode < 10:
+                return (err.returncode, True)
             # Negative exit codes are allowed for passing out signals.
-            assert err.returncode >= 10 or err.returncode < 0, "got returncode < 10: {}".format(err.returncode)
             return (err.returncode, False)
         else:
             return (0, True)
@@ -190,5 +213,8 @@ def run_validate(args):
             returncodes.exit_with_driver_input_error("Error: {} not found. Is it on the PATH?".format(VALIDATE))
         else:
             returncodes.exit_with_driver_critical_error(err)
+    except subprocess.CalledProcessError as err:
+        print(err)
+        return (returncodes.DRIVER_CRITICAL_ERROR, False)
     else:
         return (0, True)
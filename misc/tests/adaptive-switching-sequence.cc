@@ -0,0 +1,44 @@
+/*
+  Prints the A* phase lengths that kstar::AdaptiveSwitching chooses for a
+  synthetic run of K*. Used by test-adaptive-switching.py.
+
+  Usage: adaptive-switching-sequence missing_plans fallback_length
+             expansions_per_second switch_time plans_per_phase num_phases
+
+  Every A* phase expands exactly the chosen number of states, every switch
+  to Eppstein's algorithm takes switch_time seconds and every Eppstein
+  phase finds plans_per_phase plans.
+*/
+
+#include "kstar/adaptive_switching.h"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    if (argc != 7) {
+        cerr << "usage: " << argv[0] << " missing_plans fallback_length "
+             << "expansions_per_second switch_time plans_per_phase num_phases"
+             << endl;
+        return 2;
+    }
+    int missing_plans = atoi(argv[1]);
+    int fallback_length = atoi(argv[2]);
+    double expansions_per_second = atof(argv[3]);
+    double switch_time = atof(argv[4]);
+    int plans_per_phase = atoi(argv[5]);
+    int num_phases = atoi(argv[6]);
+
+    kstar::AdaptiveSwitching adaptive_switching;
+    for (int phase = 0; phase < num_phases && missing_plans > 0; ++phase) {
+        int length = adaptive_switching.get_astar_phase_length(
+            missing_plans, fallback_length);
+        cout << length << endl;
+        adaptive_switching.report_astar_phase(
+            length, length / expansions_per_second);
+        adaptive_switching.report_eppstein_phase(plans_per_phase, switch_time);
+        missing_plans -= plans_per_phase;
+    }
+}
@@ -0,0 +1,58 @@
+"""
+Check the A* phase lengths of the adaptive switching policy of K*. Run with
+
+    py.test misc/tests/test-adaptive-switching.py
+
+The times are powers of two, so the expected lengths are exact.
+"""
+
+import os
+import subprocess
+
+import pytest
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO_BASE = os.path.dirname(os.path.dirname(DIR))
+SEARCH_DIR = os.path.join(REPO_BASE, "src", "search")
+SEQUENCE_SOURCE = os.path.join(DIR, "adaptive-switching-sequence.cc")
+CXX = os.environ.get("CXX", "c++")
+
+EXPANSIONS_PER_SECOND = 2 ** 20
+
+# (missing plans, fallback length, switch time, plans per phase, phases,
+#  expected phase lengths)
+SEQUENCES = [
+    # Without plans, each phase expands twice as many states as the last.
+    (1000, 256, 2 ** -17, 0, 4, [256, 512, 1024, 2048]),
+    # The yield predicts fewer expansions than doubling.
+    (1000, 100, 2 ** -17, 400, 4, [100, 150, 75]),
+    # The switch time is longer than the expansions the yield predicts.
+    (1000, 1000, 2 ** -10, 500, 4, [1000, 1024]),
+    # The switch time is longer than doubling the phase takes, but phases
+    # still at most double.
+    (1000, 100, 2 ** -10, 0, 4, [100, 200, 400, 800]),
+    (1000, 100, 2 ** -10, 400, 4, [100, 200, 400]),
+]
+
+
+@pytest.fixture(scope="module")
+def sequence_binary(tmp_path_factory):
+    binary = str(tmp_path_factory.mktemp("adaptive-switching") / "sequence")
+    subprocess.check_call([
+        CXX, "-std=c++11", "-I", SEARCH_DIR, SEQUENCE_SOURCE,
+        os.path.join(SEARCH_DIR, "kstar", "adaptive_switching.cc"),
+        "-o", binary])
+    return binary
+
+
+@pytest.mark.parametrize(
+    "missing_plans, fallback_length, switch_time, plans_per_phase, "
+    "num_phases, expected", SEQUENCES)
+def test_phase_lengths(sequence_binary, missing_plans, fallback_length,
+                       switch_time, plans_per_phase, num_phases, expected):
+    output = subprocess.check_output([
+        sequence_binary, str(missing_plans), str(fallback_length),
+        str(EXPANSIONS_PER_SECOND), repr(switch_time), str(plans_per_phase),
+        str(num_phases)])
+    lengths = [int(line) for line in output.decode().split()]
+    assert lengths == expected
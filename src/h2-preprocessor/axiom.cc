@@ -1,3 +1,4 @@
+#include "binary_task_writer.h"
 #include "helper_functions.h"
 #include "axiom.h"
 #include "variable.h"
@@ -64,3 +65,16 @@ void Axiom::generate_cpp_input(ofstream &outfile) const {
     outfile << effect_var->get_level() << " " << old_val << " " << effect_val << endl;
     outfile << "end_rule" << endl;
 }
+
+void Axiom::generate_binary_input(BinaryTaskWriter &writer) const {
+    assert(effect_var->get_level() != -1);
+    writer.add(conditions.size());
+    for (const Condition &condition : conditions) {
+        assert(condition.var->get_level() != -1);
+        writer.add(condition.var->get_level());
+        writer.add(condition.cond);
+    }
+    writer.add(effect_var->get_level());
+    writer.add(old_val);
+    writer.add(effect_val);
+}
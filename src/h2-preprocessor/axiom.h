@@ -7,6 +7,7 @@
 #include <vector>
 using namespace std;
 
+class BinaryTaskWriter;
 class Variable;
 
 class Axiom {
@@ -28,6 +29,7 @@ public:
     void dump() const;
     int get_encoding_size() const;
     void generate_cpp_input(ofstream &outfile) const;
+    void generate_binary_input(BinaryTaskWriter &writer) const;
     const vector<Condition> &get_conditions() const {return conditions; }
     Variable *get_effect_var() const {return effect_var; }
     int get_old_val() const {return old_val; }
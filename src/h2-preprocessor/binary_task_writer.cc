@@ -0,0 +1,85 @@
+#include "binary_task_writer.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+static const char BINARY_MAGIC[] = "FDSASBIN";
+static const int BINARY_FORMAT_VERSION = 1;
+
+// The format is little-endian.
+template<typename T>
+static void write_number(ofstream &outfile, T value) {
+    unsigned char bytes[sizeof(T)];
+    uint64_t bits = static_cast<uint64_t>(value);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = static_cast<unsigned char>(bits >> (8 * i));
+    }
+    outfile.write(reinterpret_cast<const char *>(bytes), sizeof(T));
+}
+
+BinaryTaskWriter::BinaryTaskWriter()
+    : sections(NUM_INT_SECTIONS),
+      current_section(VARIABLES) {
+}
+
+void BinaryTaskWriter::start_section(Section section) {
+    current_section = section;
+}
+
+void BinaryTaskWriter::add_name(const string &name) {
+    auto result = name_ids.insert(make_pair(name, names.size()));
+    if (result.second)
+        names.push_back(name);
+    add(result.first->second);
+}
+
+void BinaryTaskWriter::add_facts(const vector<pair<int, int>> &facts) {
+    add(facts.size());
+    for (const auto &fact : facts) {
+        add(fact.first);
+        add(fact.second);
+    }
+}
+
+void BinaryTaskWriter::write(
+    const string &file_name, bool metric, int num_variables,
+    int num_mutex_groups, int num_operators, int num_axioms) const {
+    ofstream outfile(file_name, ios::out | ios::binary);
+    if (!outfile) {
+        cerr << "could not open " << file_name << " for writing" << endl;
+        exit(2);
+    }
+
+    outfile.write(BINARY_MAGIC, 8);
+    for (int value : {BINARY_FORMAT_VERSION, static_cast<int>(metric),
+                      num_variables, num_mutex_groups, num_operators,
+                      num_axioms, static_cast<int>(names.size()), 0}) {
+        write_number<int32_t>(outfile, value);
+    }
+
+    // Section offsets: the integer sections, then the name table.
+    int64_t offset = 8 + 8 * sizeof(int32_t) + (NUM_INT_SECTIONS + 1) * sizeof(int64_t);
+    for (const vector<int> &section : sections) {
+        write_number<int64_t>(outfile, offset);
+        offset += section.size() * sizeof(int32_t);
+    }
+    write_number<int64_t>(outfile, offset);
+
+    for (const vector<int> &section : sections) {
+        for (int value : section)
+            write_number<int32_t>(outfile, value);
+    }
+
+    int64_t name_offset = 0;
+    write_number<int64_t>(outfile, name_offset);
+    for (const string &name : names) {
+        name_offset += name.size();
+        write_number<int64_t>(outfile, name_offset);
+    }
+    for (const string &name : names)
+        outfile.write(name.data(), name.size());
+}
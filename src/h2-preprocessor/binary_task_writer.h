@@ -0,0 +1,45 @@
+#ifndef BINARY_TASK_WRITER_H
+#define BINARY_TASK_WRITER_H
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+using namespace std;
+
+/*
+  Collects a task in the binary format read by the search component (see
+  src/search/tasks/binary_task_file.h for the layout) and writes it to a
+  file. The sections have to be filled in their order in the file.
+*/
+class BinaryTaskWriter {
+public:
+    enum Section {
+        VARIABLES,
+        MUTEXES,
+        INITIAL_STATE,
+        GOAL,
+        OPERATORS,
+        AXIOMS,
+        NUM_INT_SECTIONS
+    };
+private:
+    vector<vector<int>> sections;
+    Section current_section;
+    vector<string> names;
+    unordered_map<string, int> name_ids;
+public:
+    BinaryTaskWriter();
+
+    void start_section(Section section);
+    void add(int value) {
+        sections[current_section].push_back(value);
+    }
+    void add_name(const string &name);
+    void add_facts(const vector<pair<int, int>> &facts);
+
+    void write(const string &file_name, bool metric, int num_variables,
+               int num_mutex_groups, int num_operators, int num_axioms) const;
+};
+
+#endif
@@ -5,15 +5,50 @@
 //#include "utilities.h"
 
 #include <algorithm>
+#include <functional>
+#include <map>
+#include <thread>
 #include <vector>
 #include <set>
 
 using namespace std;
 
+size_t BitMatrix::count() const {
+    size_t result = 0;
+    for (Block block : blocks)
+        result += count_bits(block);
+    return result;
+}
+
+/*
+  Splits [0, num_tasks) into one contiguous range per thread and calls
+  task(begin, end) for each range. The calling thread handles the first
+  range.
+*/
+static void run_in_parallel(int num_threads, int num_tasks,
+                            const function<void(int, int)> &task) {
+    num_threads = max(1, min(num_threads, num_tasks));
+    vector<thread> workers;
+    for (int i = 1; i < num_threads; ++i) {
+        int begin = static_cast<long long>(num_tasks) * i / num_threads;
+        int end = static_cast<long long>(num_tasks) * (i + 1) / num_threads;
+        workers.push_back(thread(task, begin, end));
+    }
+    task(0, num_tasks / num_threads);
+    for (thread &worker : workers)
+        worker.join();
+}
+
+/*
+  Deletes are collected in a bit vector (scratch, one bit per proposition)
+  to avoid duplicates and then stored as a sorted vector without the adds.
+*/
 Op_h2::Op_h2(const Operator &op,
              const vector< vector<unsigned>> &p_index,
-             const vector<vector<set<pair<int, int>>>> &inconsistent_facts,
-             bool regression) {
+             const BitMatrix &inconsistent,
+             vector<BitMatrix::Block> &scratch,
+             bool regression)
+    : last_update(0) {
     // //cout << "New op: " << op.get_name() << endl;
 
     if (op.is_redundant()) {
@@ -22,20 +57,33 @@ Op_h2::Op_h2(const Operator &op,
         triggered = NOT_REACHED;
     }
 
+    scratch.assign(inconsistent.get_blocks_per_row(), 0);
     if (regression) {
-        instantiate_operator_backward(op, p_index, inconsistent_facts);
+        instantiate_operator_backward(op, p_index, inconsistent, scratch);
     } else {
-        instantiate_operator_forward(op, p_index, inconsistent_facts);
+        instantiate_operator_forward(op, p_index, inconsistent, scratch);
     }
 
     sort(pre.begin(), pre.end());
     sort(add.begin(), add.end());
-    sort(del.begin(), del.end());
 
-    vector<unsigned int> aux;
-    set_difference(del.begin(), del.end(), add.begin(), add.end(), back_inserter(aux));
-    del.swap(aux);
-    sort(del.begin(), del.end());
+    for (unsigned p : add)
+        scratch[p / BitMatrix::BITS_PER_BLOCK] &= ~(BitMatrix::Block(1) << (p % BitMatrix::BITS_PER_BLOCK));
+    for_each_bit(scratch.data(), scratch.size(), [this](unsigned p) {
+                     del.push_back(p);
+                 });
+}
+
+// Adds all propositions that are inconsistent with prop to the deletes.
+static inline void add_inconsistent(const BitMatrix &inconsistent, unsigned prop,
+                                    vector<BitMatrix::Block> &deletes) {
+    const BitMatrix::Block *row = inconsistent.get_row(prop);
+    for (size_t b = 0; b < deletes.size(); ++b)
+        deletes[b] |= row[b];
+}
+
+static inline void add_delete(unsigned prop, vector<BitMatrix::Block> &deletes) {
+    deletes[prop / BitMatrix::BITS_PER_BLOCK] |= BitMatrix::Block(1) << (prop % BitMatrix::BITS_PER_BLOCK);
 }
 
 bool compute_h2_mutexes(const vector <Variable *> &variables,
@@ -44,8 +92,9 @@ bool compute_h2_mutexes(const vector <Variable *> &variables,
                         vector<MutexGroup> &mutexes,
                         State &initial_state,
                         const vector<pair<Variable *, int>> &goals,
-                        int limit_seconds, bool disable_bw_h2) {
-    H2Mutexes h2(limit_seconds);
+                        int limit_seconds, bool disable_bw_h2,
+                        int num_threads) {
+    H2Mutexes h2(limit_seconds, num_threads);
 
     if (!h2.initialize(variables, mutexes)) {
         return true;
@@ -127,11 +176,15 @@ int H2Mutexes::detect_unreachable_fluents(const vector <Variable *> &variables,
                     static_fluents.insert(static_fluent);
 
                     //Set inconsistent with everything else
-                    const set<pair<int, int>> &inconsistent = inconsistent_facts[static_fluent.first][static_fluent.second];
-                    for (auto it = inconsistent.begin();
-                         it != inconsistent.end(); it++) {
-                        if (!is_unreachable(it->first, it->second)) {
-                            if(!set_unreachable(it->first, it->second, variables, initial_state, goals))
+                    vector<unsigned> inconsistent_props;
+                    for_each_bit(inconsistent.get_row(p_index[static_fluent.first][static_fluent.second]),
+                                 inconsistent.get_blocks_per_row(), [&](unsigned p) {
+                                     inconsistent_props.push_back(p);
+                                 });
+                    for (unsigned p : inconsistent_props) {
+                        const pair<unsigned, unsigned> &fact = p_index_reverse[p];
+                        if (!is_unreachable(fact.first, fact.second)) {
+                            if(!set_unreachable(fact.first, fact.second, variables, initial_state, goals))
 				return UNSOLVABLE;
                             new_unreachable = true;
 			    num_discovered ++;
@@ -189,11 +242,22 @@ bool  H2Mutexes::set_unreachable(int var, int val, const vector <Variable *> &va
 bool H2Mutexes::remove_spurious_operators(vector<Operator> &operators) {
     int count = 0, totalCount = 0;
     bool spurious_detected = false;
-    for (Operator &op : operators) {
-        if (!op.is_redundant()) {
+    vector<bool> was_redundant(operators.size());
+    for (size_t i = 0; i < operators.size(); ++i)
+        was_redundant[i] = operators[i].is_redundant();
+
+    // Disambiguation only reads the mutexes, so operators can be handled in parallel.
+    run_in_parallel(num_threads, operators.size(), [&](int begin, int end) {
+                        for (int i = begin; i < end; ++i) {
+                            if (!was_redundant[i])
+                                operators[i].remove_ambiguity(*this);
+                        }
+                    });
+
+    for (size_t i = 0; i < operators.size(); ++i) {
+        if (!was_redundant[i]) {
             totalCount++;
-            op.remove_ambiguity(*this);
-            if (op.is_redundant()) {
+            if (operators[i].is_redundant()) {
                 spurious_detected = true;
                 count++;
             }
@@ -229,24 +293,19 @@ bool H2Mutexes::initialize(const vector <Variable *> &variables,
         unreachable[i].resize(num_vals[i], false);
     }
 
-    inconsistent_facts.resize(num_vars);
-    for (int i = 0; i < num_vars; i++) {
-        inconsistent_facts[i].resize(num_vals[i]);
-        //  cout << i << "-" << num_vals[i] << endl;
-    }
+    inconsistent.resize(number_props);
     //Initialize everything to NOT_REACHED (mutexes will be set to spurious)
-    m_values.resize(number_props * number_props, NOT_REACHED);
+    spurious.resize(number_props);
+    reached.resize(number_props);
+    num_changes = 0;
+    last_diagonal_change = 0;
+    last_change.assign(number_props, 0);
 
     //Set to spurious variables with themselves
     for (int var = 0; var < num_vars; ++var) {
         for (int val1 = 0; val1 < num_vals[var]; ++val1) {
-            int p_index_1 = p_index[var][val1];
             for (int val2 = val1 + 1; val2 < num_vals[var]; ++val2) {
-                int p_index_2 = p_index[var][val2];
-                int pos1 = position(p_index_1, p_index_2);
-                int pos2 = position(p_index_2, p_index_1);
-                m_values[pos1] = SPURIOUS;
-                m_values[pos2] = SPURIOUS;
+                set_spurious(p_index[var][val1], p_index[var][val2]);
             }
         }
     }
@@ -278,28 +337,18 @@ bool H2Mutexes::initialize(const vector <Variable *> &variables,
                        groups which lead to *some* redundant mutexes,
                        where some but not all facts talk about the
                        same variable. */
-                    //cout << var1 << "-" << val1 << " is inconsistent with " << var2 << "-" << val2 << endl;
-                    inconsistent_facts[var1][val1].insert(fact2);
-                    inconsistent_facts[var2][val2].insert(fact1); // Vidal: redundancy included
-
-
-		    //cout << "Initialize mutex: " << var1 <<"-" << val1 << " "  << variables[var1]->get_fact_name(val1) << " - " << var2<< "-" << val2 << " "  << variables[var2]->get_fact_name(val2) << endl;
+                    unsigned p1 = p_index[var1][val1];
+                    unsigned p2 = p_index[var2][val2];
+                    inconsistent.set(p1, p2);
+                    inconsistent.set(p2, p1); // Vidal: redundancy included
 
                     // set the pairs that are mutex as spurious
-                    m_values[position(p_index[var1][val1], p_index[var2][val2])] = SPURIOUS;
-                    m_values[position(p_index[var2][val2], p_index[var1][val1])] = SPURIOUS;
+                    set_spurious(p1, p2);
                 }
             }
         }
     }
 
-    // We do not have any unreachable fluent at this point
-    // // set the pairs with unreachable fluents as spurious
-    // for (set<pair<int, int> >::iterator it = g_unreachable.begin(); it != g_unreachable.end(); ++it)
-    //     for (unsigned i = 0; i < g_variable_domain.size(); i++)
-    //         for (unsigned j = 0; j < g_variable_domain[i]; j++)
-    //             m_values[position(p_index[i][j], p_index[it->first][it->second])] = m_values[position(p_index[it->first][it->second], p_index[i][j])] = SPURIOUS;
-
     cout << "Mutex computation initialized with " << number_props << " fluents." << endl;
     return true;
 }
@@ -307,16 +356,7 @@ bool H2Mutexes::initialize(const vector <Variable *> &variables,
 
 bool H2Mutexes::init_values_progression(const vector <Variable *> &variables,
                                         const State &initial_state) {
-    int countSpurious = 0, countReached = 0, countNotReached = 0;
-
-    for (unsigned i = 0; i < m_values.size(); i++) {
-        if (m_values[i] == SPURIOUS) {
-            countSpurious++;
-            continue;
-        }
-        m_values[i] = NOT_REACHED;
-        countNotReached++;
-    }
+    reached.resize(number_props);
 
     for (unsigned i = 0; i < variables.size(); i++) {
         int var1 = variables[i]->get_level();
@@ -324,17 +364,15 @@ bool H2Mutexes::init_values_progression(const vector <Variable *> &variables,
         for (unsigned j = 0; j < variables.size(); j++) {
             int var2 = variables[j]->get_level();
             unsigned fluent2 = p_index[var2][initial_state[variables[j]]];
-            unsigned pos = position(fluent1, fluent2);
-	    if(m_values[pos] == SPURIOUS) return false;
-            //This check probably is unnecessary, because the initial state should not contain anything spurious
-            // (I left it just in case of unsolvable problems)
-            if (m_values[pos] == NOT_REACHED) {
-                m_values[pos] = REACHED;
-                countReached++;
-                countNotReached--;
-            }
+	    if(spurious.test(fluent1, fluent2)) return false;
+            if (!reached.test(fluent1, fluent2))
+                set_reached(fluent1, fluent2);
         }
     }
+
+    size_t countSpurious = spurious.count();
+    size_t countReached = reached.count();
+    size_t countNotReached = static_cast<size_t>(number_props) * number_props - countSpurious - countReached;
     cout << "Initialized mvalues forward: reached=" << countReached <<
         ", notReached=" << countNotReached << ", spurious=" << countSpurious << endl;
 
@@ -350,8 +388,7 @@ bool H2Mutexes::check_initial_state_is_dead_end(const vector <Variable *> &varia
         for (unsigned j = 0; j < variables.size(); j++) {
             int var2 = variables[j]->get_level();
             unsigned fluent2 = p_index[var2][initial_state[variables[j]]];
-            unsigned pos = position(fluent1, fluent2);
-            if (m_values[pos] == SPURIOUS) {
+            if (spurious.test(fluent1, fluent2)) {
 		return true;
             }
         }
@@ -368,8 +405,7 @@ bool H2Mutexes::check_goal_state_is_unreachable(const vector<pair<Variable *, in
 	    int var2 = goal[g2].first->get_level();
 	    unsigned fluent2 = p_index[var2][goal[g2].second];
 
-            unsigned pos = position(fluent1, fluent2);
-            if (m_values[pos] == SPURIOUS) {
+            if (spurious.test(fluent1, fluent2)) {
 		return true;
             }
         }
@@ -384,11 +420,17 @@ bool H2Mutexes::init_values_regression(const vector<pair<Variable *, int>> &goal
     
     if(check_goal_state_is_unreachable(goal)) return false;
 
-    for (unsigned i = 0; i < m_values.size(); i++) {
-        if (m_values[i] != SPURIOUS) {
-            m_values[i] = REACHED;
-        }
+    // everything that is not spurious is reached
+    unsigned num_blocks = reached.get_blocks_per_row();
+    for (unsigned p = 0; p < number_props; ++p) {
+        BitMatrix::Block *reached_row = reached.get_row(p);
+        const BitMatrix::Block *spurious_row = spurious.get_row(p);
+        for (unsigned b = 0; b < num_blocks; ++b)
+            reached_row[b] = ~spurious_row[b];
+        reached_row[num_blocks - 1] &= reached.get_last_block_mask();
     }
+    last_diagonal_change = ++num_changes;
+    last_change.assign(number_props, num_changes);
 
     // the things that are mutex with the goal are not reached
     for (unsigned g = 0; g < goal.size(); g++) {
@@ -396,10 +438,10 @@ bool H2Mutexes::init_values_regression(const vector<pair<Variable *, int>> &goal
         int gval = goal[g].second;
 
         //cout << "Goal: " << goal[g].first->get_fact_name(goal[g].second) << endl;
-        const set<pair<int, int>> &goal_mutexes = inconsistent_facts[gvar][gval];
-        for (set<pair<int, int>>::iterator it = goal_mutexes.begin(); it != goal_mutexes.end(); ++it) {
-            setPropositionNotReached(p_index[it->first][it->second]);
-        }
+        for_each_bit(inconsistent.get_row(p_index[gvar][gval]), num_blocks,
+                     [this](unsigned p) {
+                         setPropositionNotReached(p);
+                     });
         for (int val1 = 0; val1 < num_vals[gvar]; val1++) {
             if (val1 != gval) {
                 setPropositionNotReached(p_index[gvar][val1]);
@@ -407,17 +449,9 @@ bool H2Mutexes::init_values_regression(const vector<pair<Variable *, int>> &goal
         }
     }
 
-    int countSpurious = 0, countReached = 0, countNotReached = 0;
-    for (unsigned i = 0; i < m_values.size(); i++) {
-        if (m_values[i] == REACHED) {
-            countReached++;
-        } else if (m_values[i] == NOT_REACHED) {
-            countNotReached++;
-        } else {
-            countSpurious++;
-        }
-    }
-
+    size_t countSpurious = spurious.count();
+    size_t countReached = reached.count();
+    size_t countNotReached = static_cast<size_t>(number_props) * number_props - countSpurious - countReached;
     cout << "Initialized mvalues backward: reached=" << countReached <<
         ", notReached=" << countNotReached << ", spurious=" << countSpurious << endl;
 
@@ -425,33 +459,76 @@ bool H2Mutexes::init_values_regression(const vector<pair<Variable *, int>> &goal
 }
 
 void H2Mutexes::setPropositionNotReached(int prop_index) {
-    for (int var2 = 0; var2 < num_vars; var2++) {
-        for (int val2 = 0; val2 < num_vals[var2]; val2++) {
-            int p_index_2 = p_index[var2][val2];
-            int pos1 = position(prop_index, p_index_2);
-            if (m_values[pos1] == REACHED) {
-                m_values[pos1] = NOT_REACHED;
-            }
-            int pos2 = position(p_index_2, prop_index);
-            if (m_values[pos2] == REACHED) {
-                m_values[pos2] = NOT_REACHED;
-            }
-        }
-    }
+    BitMatrix::Block *row = reached.get_row(prop_index);
+    for_each_bit(row, reached.get_blocks_per_row(), [&](unsigned p) {
+                     reached.reset(p, prop_index);
+                 });
+    fill(row, row + reached.get_blocks_per_row(), 0);
 }
 
 void H2Mutexes::init_h2_operators(const vector<Operator> &operators, const vector<Axiom> &axioms, bool regression) {
-    m_ops.clear();
-    m_ops.reserve(operators.size());
-    for (unsigned i = 0; i < operators.size(); i++) {
-        m_ops.push_back(Op_h2(operators[i], p_index, inconsistent_facts, regression));
-    }
-
     //TODO: use axioms
     if (axioms.size()) {
         cerr << "Error, axioms not supported by h2" << endl;
         exit(-1);
     }
+
+    m_ops.clear();
+    m_ops.resize(operators.size());
+    run_in_parallel(num_threads, operators.size(), [&](int begin, int end) {
+                        vector<BitMatrix::Block> scratch;
+                        for (int i = begin; i < end; ++i)
+                            m_ops[i] = Op_h2(operators[i], p_index, inconsistent, scratch, regression);
+                    });
+}
+
+/*
+  Sets all pairs (p, q) to reached where p is added by the operator and q
+  is reached together with all preconditions and neither added nor deleted.
+  Any reached pair (q, r) implies that (q, q) is reached, so for operators
+  with preconditions we only need to intersect the rows of the
+  preconditions.
+*/
+void H2Mutexes::apply_operator(Op_h2 &op, vector<BitMatrix::Block> &candidates) {
+    op.last_update = num_changes;
+
+    for (unsigned p : op.add) {
+        for (unsigned q : op.add) {
+            if (get_value(p, q) == NOT_REACHED)
+                set_reached(p, q);
+        }
+    }
+
+    unsigned num_blocks = reached.get_blocks_per_row();
+    if (op.pre.empty()) {
+        fill(candidates.begin(), candidates.end(), 0);
+        for (unsigned q = 0; q < number_props; ++q) {
+            if (reached.test(q, q))
+                candidates[q / BitMatrix::BITS_PER_BLOCK] |= BitMatrix::Block(1) << (q % BitMatrix::BITS_PER_BLOCK);
+        }
+    } else {
+        const BitMatrix::Block *row = reached.get_row(op.pre[0]);
+        copy(row, row + num_blocks, candidates.begin());
+        for (size_t i = 1; i < op.pre.size(); ++i) {
+            row = reached.get_row(op.pre[i]);
+            for (unsigned b = 0; b < num_blocks; ++b)
+                candidates[b] &= row[b];
+        }
+    }
+    for (unsigned q : op.add)
+        candidates[q / BitMatrix::BITS_PER_BLOCK] &= ~(BitMatrix::Block(1) << (q % BitMatrix::BITS_PER_BLOCK));
+    for (unsigned q : op.del)
+        candidates[q / BitMatrix::BITS_PER_BLOCK] &= ~(BitMatrix::Block(1) << (q % BitMatrix::BITS_PER_BLOCK));
+
+    for (unsigned p : op.add) {
+        const BitMatrix::Block *reached_row = reached.get_row(p);
+        const BitMatrix::Block *spurious_row = spurious.get_row(p);
+        for (unsigned b = 0; b < num_blocks; ++b) {
+            BitMatrix::Block new_pairs = candidates[b] & ~reached_row[b] & ~spurious_row[b];
+            for (; new_pairs; new_pairs &= new_pairs - 1)
+                set_reached(p, b * BitMatrix::BITS_PER_BLOCK + lowest_bit(new_pairs));
+        }
+    }
 }
 
 //Returns the number of new mutexes or -1 if failed
@@ -473,79 +550,41 @@ int H2Mutexes::compute(const vector <Variable *> &variables,
 
     cout << "Computing mutexes..." << endl;
 
+    vector<BitMatrix::Block> candidates(reached.get_blocks_per_row());
     bool updated;
     do {
-        // if (time_exceeded())
-        //     return TIMEOUT;
-	
         updated = false;
         for (unsigned op_i = 0; op_i < m_ops.size(); op_i++) {
 	    if (op_i % 10000 == 0 && time_exceeded()) return TIMEOUT; 
 
+            Op_h2 &op = m_ops[op_i];
             // disregard spurious operators
-            if (m_ops[op_i].triggered == SPURIOUS)
-                continue;
-
-            // if the preconditions haven't been met, continue
-            if ((m_ops[op_i].triggered != REACHED) &&
-                ((m_ops[op_i].triggered =
-                      eval_propositions(m_ops[op_i].pre)) != REACHED))
+            if (op.triggered == SPURIOUS)
                 continue;
 
-
-            for (unsigned add_i = 0; add_i < m_ops[op_i].add.size(); add_i++) {
-                unsigned p = m_ops[op_i].add[add_i];
-                for (unsigned add_j = 0; add_j < m_ops[op_i].add.size(); add_j++) {
-                    unsigned q = m_ops[op_i].add[add_j];
-                    if (m_values[position(p, q)] == NOT_REACHED) {
-                        m_values[position(p, q)] = m_values[position(q, p)] = REACHED;
-                        updated = true;
-                    }
-                }
-
-
-                for (unsigned prop_i = 0; prop_i < number_props; prop_i++) {
-                    if (m_values[position(prop_i, prop_i)] != REACHED ||
-                        m_values[position(p, prop_i)] != NOT_REACHED)
-                        continue;
-
-                    if (binary_search(m_ops[op_i].add.begin(),
-                                      m_ops[op_i].add.end(),
-                                      prop_i) ||
-                        binary_search(m_ops[op_i].del.begin(),
-                                      m_ops[op_i].del.end(),
-                                      prop_i)) {
-                        continue;
-                    }
-
-                    bool satisfied = true;
-                    for (unsigned pre_i = 0; satisfied && pre_i < m_ops[op_i].pre.size(); pre_i++) {
-                        satisfied = (m_values[position(prop_i, m_ops[op_i].pre[pre_i])] == REACHED);
-                    }
-
-                    if (satisfied) {
-                        // pair<unsigned, unsigned> a = p_index_reverse[prop_i];
-                        // pair<unsigned, unsigned> b = p_index_reverse[p];
-                        // cout << "Action: " << g_operators[op_i].get_name() << " -> ";
-                        // cout << print_fluent(a.first,a.second) << " - " << print_fluent(b.first,b.second) << endl;
-                        m_values[position(p, prop_i)] = m_values[position(prop_i, p)] = REACHED;
-                        updated = true;
-                    }
-                }
+            if (op.triggered != REACHED) {
+                // if the preconditions haven't been met, continue
+                if ((op.triggered = eval_propositions(op.pre)) != REACHED)
+                    continue;
+            } else {
+                // if no precondition pair has been reached since the last application, continue
+                bool changed = op.pre.empty() && last_diagonal_change > op.last_update;
+                for (size_t i = 0; !changed && i < op.pre.size(); ++i)
+                    changed = last_change[op.pre[i]] > op.last_update;
+                if (!changed)
+                    continue;
             }
+
+            unsigned long old_num_changes = num_changes;
+            apply_operator(op, candidates);
+            if (num_changes != old_num_changes)
+                updated = true;
         }
     } while (updated);
 
-    int countReached = 0, countNotReached = 0, countSpurious = 0;
-    for (unsigned i = 0; i < m_values.size(); i++) {
-        if (m_values[i] == REACHED) {
-            countReached++;
-        } else if (m_values[i] == NOT_REACHED) {
-            countNotReached++;
-        } else {
-            countSpurious++;
-        }
-    }
+    size_t countSpurious = spurious.count();
+    size_t countReached = reached.count();
+    size_t countNotReached = static_cast<size_t>(number_props) * number_props - countSpurious - countReached;
     cout << "Mutex computation finished with reached=" << countReached <<
         ", notReached=" << countNotReached << ", spurious=" << countSpurious << endl;
 
@@ -561,22 +600,30 @@ int H2Mutexes::compute(const vector <Variable *> &variables,
 
     //Add mutexes
     unsigned count = 0;
-  int countUnreachable = 0;
-    for (unsigned i = 0; i < m_values.size(); i++) {
-        if (m_values[i] == NOT_REACHED) {
-            m_values[i] = SPURIOUS;
-            pair<unsigned, unsigned> a = p_index_reverse[i / number_props];
-            pair<unsigned, unsigned> b = p_index_reverse[i % number_props];
-            if (a == b) {
-		if(!is_unreachable(a.first, a.second)) {
-	      countUnreachable ++;
-		    if(!set_unreachable(a.first, a.second, variables, initial_state, goal)){ 
-			return UNSOLVABLE;
-		    }
-		}
-            } else {
-                if (m_values[position(p_index[a.first][a.second], p_index[a.first][a.second])] == REACHED &&
-                    m_values[position(p_index[b.first][b.second], p_index[b.first][b.second])] == REACHED) {
+    int countUnreachable = 0;
+    unsigned num_blocks = reached.get_blocks_per_row();
+    vector<BitMatrix::Block> not_reached(num_blocks);
+    for (unsigned p1 = 0; p1 < number_props; ++p1) {
+        const BitMatrix::Block *reached_row = reached.get_row(p1);
+        const BitMatrix::Block *spurious_row = spurious.get_row(p1);
+        for (unsigned b = 0; b < num_blocks; ++b)
+            not_reached[b] = ~(reached_row[b] | spurious_row[b]);
+        not_reached[num_blocks - 1] &= reached.get_last_block_mask();
+
+        for (unsigned block_id = 0; block_id < num_blocks; ++block_id) {
+            for (BitMatrix::Block block = not_reached[block_id]; block; block &= block - 1) {
+                unsigned p2 = block_id * BitMatrix::BITS_PER_BLOCK + lowest_bit(block);
+                spurious.set(p1, p2);
+                pair<unsigned, unsigned> a = p_index_reverse[p1];
+                pair<unsigned, unsigned> b = p_index_reverse[p2];
+                if (a == b) {
+                    if(!is_unreachable(a.first, a.second)) {
+                        countUnreachable ++;
+                        if(!set_unreachable(a.first, a.second, variables, initial_state, goal)){ 
+                            return UNSOLVABLE;
+                        }
+                    }
+                } else if (reached.test(p1, p1) && reached.test(p2, p2)) {
                     // cout << "Mutex: " << variables[a.first]->get_fact_name(a.second) << " and "
                     //      << variables[b.first]->get_fact_name(b.second) << endl;
                     //Only increase the mutex count when both fluents are reachable
@@ -589,53 +636,41 @@ int H2Mutexes::compute(const vector <Variable *> &variables,
                         mutexes.push_back(MutexGroup(mut_group, variables, regression));
                     }
                     // add to inconsistent
-                    inconsistent_facts[a.first][a.second].insert(b);
-                    inconsistent_facts[b.first][b.second].insert(a);
+                    inconsistent.set(p1, p2);
+                    inconsistent.set(p2, p1);
                 }
             }
         }
     }
 
-  //   This is not neeed anymore because we handle this in set_unreachable
-    // for (int var = 0; var < static_cast<int>(unreachable.size()); var++) {
-    //     for (int val = 0; val < static_cast<int>(unreachable[var].size()); val++) {
-    //   if(variables[var]->is_reachable(val) && unreachable[var][val]){
-    // 	  cout << "WARNING: Setting an unreachable var out of set_unreachable. This never should happen." << endl;
-    // 	  // cout << "Unreachable proposition: " << variables[var]->get_fact_name(val) << endl;
-    // 	  countUnreachable++;
-    // 	variables[var]->set_unreachable(val);
-    //   }
-    // }
-    //}
-
     cout << "H^2 mutexes added " << (regression ? "bw" :  "fw") << ": " << count << ", unreachable: " << countUnreachable << endl;
 
     return count + countUnreachable;
 }
 
-Reachability H2Mutexes::eval_propositions(const vector<unsigned> & props) {
+Reachability H2Mutexes::eval_propositions(const vector<unsigned> & props) const {
     if (props.empty())
         return REACHED;
     for (unsigned i = 0; i < props.size(); i++)
         for (unsigned j = i; j < props.size(); j++)
-            if (m_values[position(props[i], props[j])] == NOT_REACHED)
+            if (get_value(props[i], props[j]) == NOT_REACHED)
                 return NOT_REACHED;
     return REACHED;
 }
 
 void H2Mutexes::print_mutexes(const vector <Variable *> &variables) {
     unsigned count = 0;
-    for (unsigned i = 0; i < m_values.size(); i++) {
-        if (m_values[i] == SPURIOUS) {
-            pair<unsigned, unsigned> a = p_index_reverse[i / number_props];
-            pair<unsigned, unsigned> b = p_index_reverse[i % number_props];
-            if (!are_mutex(a.first, a.second, b.first, b.second)) {
-                count++;
-                cout << variables[a.first]->get_fact_name(a.second) << " - " << variables[b.first]->get_fact_name(b.second) << endl;
-            }
-        }
-    }
-    cout << count << " " << m_values.size() << endl;
+    for (unsigned p1 = 0; p1 < number_props; ++p1) {
+        for_each_bit(spurious.get_row(p1), spurious.get_blocks_per_row(), [&](unsigned p2) {
+                         pair<unsigned, unsigned> a = p_index_reverse[p1];
+                         pair<unsigned, unsigned> b = p_index_reverse[p2];
+                         if (!are_mutex(a.first, a.second, b.first, b.second)) {
+                             count++;
+                             cout << variables[a.first]->get_fact_name(a.second) << " - " << variables[b.first]->get_fact_name(b.second) << endl;
+                         }
+                     });
+    }
+    cout << count << " " << static_cast<size_t>(number_props) * number_props << endl;
 }
 
 void H2Mutexes::print_pair(unsigned /*pair*/) {
@@ -658,8 +693,9 @@ bool H2Mutexes::time_exceeded() {
 
 void Op_h2::instantiate_operator_forward(const Operator &op,
                                          const vector< vector<unsigned>> &p_index,
-                                         const vector<vector<set<pair<int, int>>>> &inconsistent_facts) {
-    vector<bool> prepost_var(inconsistent_facts.size(), false);
+                                         const BitMatrix &inconsistent,
+                                         vector<BitMatrix::Block> &deletes) {
+    vector<bool> prepost_var(p_index.size(), false);
 
     const vector<Operator::Prevail> &prevail = op.get_prevail();
     for (unsigned j = 0; j < prevail.size(); j++)
@@ -675,7 +711,6 @@ void Op_h2::instantiate_operator_forward(const Operator &op,
     }
     // fluents mutex with prevails are e-deleted: add as negative effect
     for (unsigned j = 0; j < prevail.size(); j++) {
-        // pre.push_back(p_index[prevail[j].var][prevail[j].prev]);
         int var = prevail[j].var->get_level();
         int prev = prevail[j].prev;
         if (var == -1)
@@ -684,12 +719,10 @@ void Op_h2::instantiate_operator_forward(const Operator &op,
         // fluents that belong to the same variable
         for (int k = 0; k < static_cast<int>(p_index[var].size()); k++)
             if (k != prev)
-                del.push_back(p_index[var][k]);
+                add_delete(p_index[var][k], deletes);
 
         // fluents mutex with the prevail
-        const set<pair<int, int>> prev_mutexes = inconsistent_facts[var][prev];
-        for (set<pair<int, int>>::iterator it = prev_mutexes.begin(); it != prev_mutexes.end(); ++it)
-            del.push_back(p_index[it->first][it->second]);
+        add_inconsistent(inconsistent, p_index[var][prev], deletes);
     }
 
 
@@ -698,16 +731,8 @@ void Op_h2::instantiate_operator_forward(const Operator &op,
         int var = pre_post[j].var->get_level();
         int post = pre_post[j].post;
 
-        if (pre_post[j].is_conditional_effect) {
+        if (pre_post[j].is_conditional_effect)
             continue;
-            // }else{
-            // bool found = false;
-            // for (unsigned k = 0; k < pre_post.size(); k++) {
-            //  //found = /*pre_post[k].var->get_level() == var && */pre_post[k].is_conditional_effect;
-            //  if(found) break;
-            // }
-            // if(found) continue;
-        }
 
         if (var == -1)
             continue;
@@ -715,19 +740,16 @@ void Op_h2::instantiate_operator_forward(const Operator &op,
         // fluents that belong to the same variable
         for (int k = 0; k < static_cast<int>(p_index[var].size()); k++) {
             if (k != post) {
-                del.push_back(p_index[var][k]);
+                add_delete(p_index[var][k], deletes);
             }
         }
 
         // fluents mutex with the add
-        const set<pair<int, int>> prev_mutexes = inconsistent_facts[var][post];
-        for (set<pair<int, int>>::iterator it = prev_mutexes.begin(); it != prev_mutexes.end(); ++it)
-            del.push_back(p_index[it->first][it->second]);
+        add_inconsistent(inconsistent, p_index[var][post], deletes);
     }
 
     // augmented preconditions from the disambiguation
     const vector<pair<int, int>> &augmented = op.get_augmented_preconditions();
-    //     cout << "Augmented size: " << op.get_name() << " -> " << augmented.size() << endl;
     for (unsigned j = 0; j < augmented.size(); j++) {
         int var = augmented[j].first;
         int val = augmented[j].second;
@@ -738,18 +760,17 @@ void Op_h2::instantiate_operator_forward(const Operator &op,
             int num_p_index = p_index[var].size();
             for (int k = 0; k < num_p_index; k++)
                 if (k != val)
-                    del.push_back(p_index[var][k]);
-            const set<pair<int, int>> augmented_mutexes = inconsistent_facts[var][val];
-            for (set<pair<int, int>>::iterator it = augmented_mutexes.begin(); it != augmented_mutexes.end(); ++it)
-                del.push_back(p_index[it->first][it->second]);
+                    add_delete(p_index[var][k], deletes);
+            add_inconsistent(inconsistent, p_index[var][val], deletes);
         }
     }
 }
 
 void Op_h2::instantiate_operator_backward(const Operator &op,
                                           const vector< vector<unsigned>> &p_index,
-                                          const vector<vector<set<pair<int, int>>>> &inconsistent_facts) {
-    vector<bool> prepost_var(inconsistent_facts.size(), false);
+                                          const BitMatrix &inconsistent,
+                                          vector<BitMatrix::Block> &deletes) {
+    vector<bool> prepost_var(p_index.size(), false);
 
     const vector<Operator::Prevail> &prevail = op.get_prevail();
     for (unsigned j = 0; j < prevail.size(); j++)
@@ -769,7 +790,7 @@ void Op_h2::instantiate_operator_backward(const Operator &op,
         }
 
         if (pre_post[j].is_conditional_effect) {  // naive support for conditional effects
-            vector<Operator::EffCond> effect_conds = pre_post[j].effect_conds;
+            const vector<Operator::EffCond> &effect_conds = pre_post[j].effect_conds;
             for (unsigned k = 0; k < effect_conds.size(); k++)
                 push_add(p_index, effect_conds[k].var, effect_conds[k].cond);
         }
@@ -786,19 +807,16 @@ void Op_h2::instantiate_operator_backward(const Operator &op,
         // fluents that belong to the same variable
         for (int k = 0; k < static_cast<int>(p_index[var].size()); k++)
             if (k != prev)
-                del.push_back(p_index[var][k]);
+                add_delete(p_index[var][k], deletes);
 
         // fluents mutex with the prevail
-        const set<pair<int, int>> prev_mutexes = inconsistent_facts[var][prev];
-        for (set<pair<int, int>>::iterator it = prev_mutexes.begin(); it != prev_mutexes.end(); ++it)
-            del.push_back(p_index[it->first][it->second]);
+        add_inconsistent(inconsistent, p_index[var][prev], deletes);
     }
 
     // fluents mutex with pres are e-deleted: add as negative effect
     for (size_t j = 0; j < pre_post.size(); j++) {
         if (pre_post[j].is_conditional_effect)
             continue;
-        // pre.push_back(p_index[prevail[j].var][prevail[j].prev]);
         int var = pre_post[j].var->get_level();
         int pre = pre_post[j].pre;
         if (var == -1 || pre == -1)
@@ -808,22 +826,18 @@ void Op_h2::instantiate_operator_backward(const Operator &op,
         int num_p_index = p_index[var].size();
         for (int k = 0; k < num_p_index; k++)
             if (k != pre)
-                del.push_back(p_index[var][k]);
+                add_delete(p_index[var][k], deletes);
 
         // fluents mutex with the add
-        const set<pair<int, int>> pre_mutexes = inconsistent_facts[var][pre];
-        for (set<pair<int, int>>::iterator it = pre_mutexes.begin(); it != pre_mutexes.end(); ++it)
-            del.push_back(p_index[it->first][it->second]);
+        add_inconsistent(inconsistent, p_index[var][pre], deletes);
     }
 
     // augmented preconditions from the disambiguation
     const vector<pair<int, int>> &augmented = op.get_augmented_preconditions();
-    //     cout << "Augmented size: " << op.get_name() << " -> " << augmented.size() << endl;
     for (unsigned j = 0; j < augmented.size(); j++) {
         int var = augmented[j].first;
         int val = augmented[j].second;
         // add the precondition as an add
-        //         cout << "Augmented: " << op.get_name() << " -> " << print_fluent(augmented[j].first, augmented[j].second) << endl;
         if (!prepost_var[var])
             pre.push_back(p_index[var][val]);
 
@@ -831,47 +845,40 @@ void Op_h2::instantiate_operator_backward(const Operator &op,
         int num_p_index_var = p_index[var].size();
         for (int k = 0; k < num_p_index_var; k++)
             if (k != augmented[j].second)
-                del.push_back(p_index[var][k]);
-        const set<pair<int, int>> augmented_mutexes = inconsistent_facts[var][val];
-        for (set<pair<int, int>>::iterator it = augmented_mutexes.begin(); it != augmented_mutexes.end(); ++it)
-            del.push_back(p_index[it->first][it->second]);
+                add_delete(p_index[var][k], deletes);
+        add_inconsistent(inconsistent, p_index[var][val], deletes);
     }
 
     // potential preconditions from the disambiguation
     const vector<pair<int, int>> &potential = op.get_potential_preconditions();
     //For each variable, the set of potential deletes to add the set of
     //mutexes with ALL potential preconditions as deletes.
-    map<int, set<pair<int, int>>> potential_deletes;
+    map<int, vector<BitMatrix::Block>> potential_deletes;
+    vector<BitMatrix::Block> potential_deletes_aux(deletes.size());
     for (unsigned j = 0; j < potential.size(); j++) {
         int pvar = potential[j].first;
         int pval = potential[j].second;
+        unsigned p = p_index[pvar][pval];
 
         // add the precondition as an add
-        add.push_back(p_index[pvar][pval]);
+        add.push_back(p);
 
         //Update the potential deletes
-        set<pair<int, int>> potential_deletes_aux =
-            inconsistent_facts[pvar][pval]; //copy
-        int num_p_index_var = p_index[pvar].size();
-        for (int k = 0; k < num_p_index_var; k++)
-            if (k != pval)
-                potential_deletes_aux.insert(potential[j]);
-
-        if (potential_deletes.count(pvar)) {
-            set<pair<int, int>> intersect;
-            set_intersection(potential_deletes[pvar].begin(), potential_deletes[pvar].end(),
-                             potential_deletes_aux.begin(), potential_deletes_aux.end(),
-                             std::inserter(intersect, intersect.begin()));
-            potential_deletes[pvar].swap(intersect);
+        const BitMatrix::Block *row = inconsistent.get_row(p);
+        copy(row, row + deletes.size(), potential_deletes_aux.begin());
+        if (p_index[pvar].size() > 1)
+            add_delete(p, potential_deletes_aux);
+
+        auto it = potential_deletes.find(pvar);
+        if (it != potential_deletes.end()) {
+            for (size_t b = 0; b < deletes.size(); ++b)
+                it->second[b] &= potential_deletes_aux[b];
         } else {
-            potential_deletes[pvar].swap(potential_deletes_aux);
+            potential_deletes[pvar] = potential_deletes_aux;
         }
     }
-    for (map<int, set<pair<int, int>>>::iterator it = potential_deletes.begin();
-         it != potential_deletes.end(); ++it) {
-        for (set<pair<int, int>>::iterator it2 = it->second.begin();
-             it2 != it->second.end(); ++it2) {
-            del.push_back(p_index[it2->first][it2->second]);
-        }
+    for (auto it = potential_deletes.begin(); it != potential_deletes.end(); ++it) {
+        for (size_t b = 0; b < deletes.size(); ++b)
+            deletes[b] |= it->second[b];
     }
 }
@@ -3,6 +3,7 @@
 #ifndef H2_MUTEXES_H
 #define H2_MUTEXES_H
 
+#include <cstdint>
 #include <ctime>
 #include <iostream>
 #include <algorithm>
@@ -23,17 +24,112 @@ enum Reachability {SPURIOUS, REACHED, NOT_REACHED};
 static const int UNSOLVABLE = -2;
 static const int  TIMEOUT = -1;
 
+/*
+  Square matrix of bits, stored row by row in 64-bit blocks so that whole
+  rows can be combined a block at a time. Bits beyond the last column of a
+  row are always zero.
+*/
+class BitMatrix {
+public:
+    typedef uint64_t Block;
+    static const unsigned BITS_PER_BLOCK = 64;
+
+private:
+    unsigned size;
+    unsigned blocks_per_row;
+    vector<Block> blocks;
+
+public:
+
+    BitMatrix() : size(0), blocks_per_row(0) {}
+
+    void resize(unsigned n) {
+        size = n;
+        blocks_per_row = (n + BITS_PER_BLOCK - 1) / BITS_PER_BLOCK;
+        blocks.assign(static_cast<size_t>(size) * blocks_per_row, 0);
+    }
+
+    inline unsigned get_blocks_per_row() const {
+        return blocks_per_row;
+    }
+
+    inline Block *get_row(unsigned row) {
+        return &blocks[static_cast<size_t>(row) * blocks_per_row];
+    }
+
+    inline const Block *get_row(unsigned row) const {
+        return &blocks[static_cast<size_t>(row) * blocks_per_row];
+    }
+
+    inline bool test(unsigned row, unsigned col) const {
+        return (get_row(row)[col / BITS_PER_BLOCK] >> (col % BITS_PER_BLOCK)) & 1;
+    }
+
+    inline void set(unsigned row, unsigned col) {
+        get_row(row)[col / BITS_PER_BLOCK] |= Block(1) << (col % BITS_PER_BLOCK);
+    }
+
+    inline void reset(unsigned row, unsigned col) {
+        get_row(row)[col / BITS_PER_BLOCK] &= ~(Block(1) << (col % BITS_PER_BLOCK));
+    }
+
+    // Mask of the valid bits in the last block of a row.
+    inline Block get_last_block_mask() const {
+        unsigned bits = size % BITS_PER_BLOCK;
+        return bits ? (Block(1) << bits) - 1 : ~Block(0);
+    }
+
+    size_t count() const;
+};
+
+inline int count_bits(BitMatrix::Block block) {
+#ifdef __GNUC__
+    return __builtin_popcountll(block);
+#else
+    int count = 0;
+    for (; block; block &= block - 1)
+        ++count;
+    return count;
+#endif
+}
+
+inline unsigned lowest_bit(BitMatrix::Block block) {
+#ifdef __GNUC__
+    return __builtin_ctzll(block);
+#else
+    unsigned pos = 0;
+    while (!(block & 1)) {
+        block >>= 1;
+        ++pos;
+    }
+    return pos;
+#endif
+}
+
+// Calls f(i) for each bit i that is set in the given blocks, in increasing order.
+template<typename F>
+inline void for_each_bit(const BitMatrix::Block *blocks, unsigned num_blocks, F f) {
+    for (unsigned b = 0; b < num_blocks; ++b) {
+        for (BitMatrix::Block block = blocks[b]; block; block &= block - 1)
+            f(b * BitMatrix::BITS_PER_BLOCK + lowest_bit(block));
+    }
+}
+
 class Op_h2 {
 public:
+    Op_h2() : triggered(NOT_REACHED), last_update(0) {}
     Op_h2(const Operator &op,
           const vector< vector<unsigned>> &p_index,
-          const std::vector<std::vector<std::set<std::pair<int, int>>>> &inconsistent_facts,
+          const BitMatrix &inconsistent,
+          vector<BitMatrix::Block> &scratch,
           bool regression);
 
     vector<unsigned> pre;
     vector<unsigned> add;
     vector<unsigned> del;
     Reachability triggered;
+    // Value of the change counter of H2Mutexes when the operator was last applied.
+    unsigned long last_update;
 
 private:
     inline void push_pre(const vector< vector<unsigned>> &p_index, Variable *var, int val) {
@@ -49,9 +145,9 @@ private:
     }
 
     void instantiate_operator_backward(const Operator &op, const vector< vector<unsigned>> &p_index,
-                                       const std::vector<std::vector<std::set<std::pair<int, int>>>> &inconsistent_facts);
+                                       const BitMatrix &inconsistent, vector<BitMatrix::Block> &deletes);
     void instantiate_operator_forward(const Operator &op, const vector< vector<unsigned>> &p_index,
-                                      const std::vector<std::vector<std::set<std::pair<int, int>>>> &inconsistent_facts);
+                                      const BitMatrix &inconsistent, vector<BitMatrix::Block> &deletes);
 };
 
 
@@ -61,7 +157,7 @@ class H2Mutexes {
 
     bool check_goal_state_is_unreachable(const vector<pair<Variable *, int>> &goal) const;
 public:
-    H2Mutexes(int t = -1) : limit_seconds(t) {
+    H2Mutexes(int t = -1, int threads = 1) : limit_seconds(t), num_threads(threads) {
         if (limit_seconds != -1)
             time(&start);
     }
@@ -85,7 +181,34 @@ public:
             return val1 != val2;  //TODO: || unreachable[var1][val1];
         unsigned p1 = p_index[var1][val1];
         unsigned p2 = p_index[var2][val2];
-        return m_values[position(p1, p2)] == SPURIOUS;
+        return spurious.test(p1, p2);
+    }
+
+    /*
+      Sets of facts as bit vectors, to test a fact against many facts at
+      once. Facts with value -1 are ignored.
+    */
+    inline void clear_fact_set(vector<BitMatrix::Block> &facts) const {
+        facts.assign(spurious.get_blocks_per_row(), 0);
+    }
+
+    inline void add_to_fact_set(int var, int val, vector<BitMatrix::Block> &facts) const {
+        if (val != -1) {
+            unsigned p = p_index[var][val];
+            facts[p / BitMatrix::BITS_PER_BLOCK] |= BitMatrix::Block(1) << (p % BitMatrix::BITS_PER_BLOCK);
+        }
+    }
+
+    // Equivalent to testing are_mutex for each fact in the set, which must not contain facts of var.
+    inline bool is_mutex_with_any(int var, int val, const vector<BitMatrix::Block> &facts) const {
+        if (val == -1)
+            return false;
+        const BitMatrix::Block *row = spurious.get_row(p_index[var][val]);
+        for (size_t b = 0; b < facts.size(); ++b) {
+            if (row[b] & facts[b])
+                return true;
+        }
+        return false;
     }
 
     inline int num_variables() const {
@@ -117,21 +240,56 @@ protected:
 
     std::set<std::pair<int, int>> static_fluents;
     std::vector <std::vector <bool >> unreachable;
-    std::vector<std::vector<std::set<std::pair<int, int>>>> inconsistent_facts;
-
+    // inconsistent.test(p, q) iff p and q are known to be mutex (on different variables)
+    BitMatrix inconsistent;
+
+    /*
+      The h^2 value of each pair of propositions is stored in two symmetric
+      bit matrices: spurious pairs are mutex, reached pairs are reachable,
+      and pairs in neither matrix are not reached (yet).
+    */
     unsigned number_props;
-    vector<unsigned> m_values;
+    BitMatrix spurious;
+    BitMatrix reached;
     vector<Op_h2> m_ops;
 
+    /*
+      Propagation is delta-driven: num_changes counts the updates of the
+      reached matrix and last_change[p] is the count of the last update of
+      row p, so operators whose preconditions have not changed since they
+      were last applied can be skipped. last_diagonal_change is the count of
+      the last proposition that became reachable.
+    */
+    unsigned long num_changes;
+    unsigned long last_diagonal_change;
+    vector<unsigned long> last_change;
+
     vector< vector<unsigned>> p_index;
     vector< pair<unsigned, unsigned>> p_index_reverse;
 
-    Reachability eval_propositions(const vector<unsigned> & props);
+    Reachability eval_propositions(const vector<unsigned> & props) const;
 
-    inline unsigned position(unsigned a, unsigned b) const {
-        return (a * number_props) + b;
+    inline Reachability get_value(unsigned a, unsigned b) const {
+        if (spurious.test(a, b))
+            return SPURIOUS;
+        return reached.test(a, b) ? REACHED : NOT_REACHED;
     }
 
+    inline void set_reached(unsigned a, unsigned b) {
+        reached.set(a, b);
+        reached.set(b, a);
+        last_change[a] = last_change[b] = ++num_changes;
+        if (a == b)
+            last_diagonal_change = num_changes;
+    }
+
+    inline void set_spurious(unsigned a, unsigned b) {
+        spurious.set(a, b);
+        spurious.set(b, a);
+    }
+
+    void apply_operator(Op_h2 &op, vector<BitMatrix::Block> &candidates);
+
     bool set_unreachable(int var, int val, const vector <Variable *> &variables, 
 			 const State &initial_state, 
 			 const vector<pair<Variable *, int>> &goal); 
@@ -139,6 +297,7 @@ protected:
     void print_pair(unsigned pair);
 
     int limit_seconds;
+    int num_threads;
     time_t start;
     bool time_exceeded();
 
@@ -158,7 +317,8 @@ extern bool compute_h2_mutexes(const vector <Variable *> &variables,
                                vector<MutexGroup> &mutexes,
                                State &initial_state,
                                const vector<pair<Variable *, int>> &goal,
-                               int limit_seconds, bool disable_bw_h2);
+                               int limit_seconds, bool disable_bw_h2,
+                               int num_threads = 1);
 
 
 
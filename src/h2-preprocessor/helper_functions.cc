@@ -6,6 +6,7 @@
 #include <vector>
 #include <fstream>
 
+#include "binary_task_writer.h"
 #include "helper_functions.h"
 #include "state.h"
 #include "mutex_group.h"
@@ -276,3 +277,66 @@ void generate_unsolvable_cpp_input(string out_file_name) {
 
     outfile.close();
 }
+
+void generate_unsolvable_binary_input(string out_file_name) {
+    // Same task as in generate_unsolvable_cpp_input.
+    BinaryTaskWriter writer;
+    writer.start_section(BinaryTaskWriter::VARIABLES);
+    writer.add_name("var0");
+    writer.add(-1);
+    writer.add(2);
+    writer.add_name("Atom dummy(val1)");
+    writer.add_name("Atom dummy(val2)");
+    writer.start_section(BinaryTaskWriter::INITIAL_STATE);
+    writer.add(0);
+    writer.start_section(BinaryTaskWriter::GOAL);
+    writer.add_facts({make_pair(0, 1)});
+    writer.write(out_file_name, true, 1, 0, 0, 0);
+}
+
+void generate_binary_input(string out_file_name,
+                           const vector<Variable *> &ordered_vars,
+                           bool metric,
+                           const vector<MutexGroup> &mutexes,
+                           const State &initial_state,
+                           const vector<pair<Variable *, int>> &goals,
+                           const vector<Operator> &operators,
+                           const vector<Axiom> &axioms) {
+    /* The binary format only contains the parts that the search
+       component reads, i.e., no successor generator, DTGs or causal
+       graph. */
+    BinaryTaskWriter writer;
+    writer.start_section(BinaryTaskWriter::VARIABLES);
+    for (Variable *var : ordered_vars)
+        var->generate_binary_input(writer);
+
+    writer.start_section(BinaryTaskWriter::MUTEXES);
+    for (const MutexGroup &mutex : mutexes)
+        mutex.generate_binary_input(writer);
+
+    writer.start_section(BinaryTaskWriter::INITIAL_STATE);
+    for (Variable *var : ordered_vars)
+        writer.add(initial_state[var]);
+
+    int num_vars = ordered_vars.size();
+    vector<int> ordered_goal_values(num_vars, -1);
+    for (const auto &goal : goals)
+        ordered_goal_values[goal.first->get_level()] = goal.second;
+    vector<pair<int, int>> ordered_goals;
+    for (int i = 0; i < num_vars; i++)
+        if (ordered_goal_values[i] != -1)
+            ordered_goals.emplace_back(i, ordered_goal_values[i]);
+    writer.start_section(BinaryTaskWriter::GOAL);
+    writer.add_facts(ordered_goals);
+
+    writer.start_section(BinaryTaskWriter::OPERATORS);
+    for (const Operator &op : operators)
+        op.generate_binary_input(writer);
+
+    writer.start_section(BinaryTaskWriter::AXIOMS);
+    for (const Axiom &axiom : axioms)
+        axiom.generate_binary_input(writer);
+
+    writer.write(out_file_name, metric, num_vars, mutexes.size(),
+                 operators.size(), axioms.size());
+}
@@ -51,6 +51,15 @@ void generate_cpp_input(string out_file_name,
                         const SuccessorGenerator &sg,
                         const vector<DomainTransitionGraph> transition_graphs,
                         const CausalGraph &cg);
+void generate_unsolvable_binary_input(string out_file_name);
+void generate_binary_input(string out_file_name,
+                           const vector<Variable *> &ordered_vars,
+                           bool metric,
+                           const vector<MutexGroup> &mutexes,
+                           const State &initial_state,
+                           const vector<pair<Variable *, int>> &goals,
+                           const vector<Operator> &operators,
+                           const vector<Axiom> &axioms);
 void check_magic(istream &in, string magic);
 
 #endif
@@ -1,5 +1,6 @@
 #include "mutex_group.h"
 
+#include "binary_task_writer.h"
 #include "helper_functions.h"
 #include "variable.h"
 
@@ -63,6 +64,14 @@ void MutexGroup::generate_cpp_input(ofstream &outfile) const {
     outfile << "end_mutex_group" << endl;
 }
 
+void MutexGroup::generate_binary_input(BinaryTaskWriter &writer) const {
+    writer.add(facts.size());
+    for (const auto &fact : facts) {
+        writer.add(fact.first->get_level());
+        writer.add(fact.second);
+    }
+}
+
 void MutexGroup::strip_unimportant_facts() {
     int new_index = 0;
     for (const auto &fact : facts) {
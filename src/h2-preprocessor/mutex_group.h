@@ -7,6 +7,7 @@
 #include "state.h"
 using namespace std;
 
+class BinaryTaskWriter;
 class Variable;
 
 enum Dir {FW, BW};
@@ -36,6 +37,7 @@ public:
         return facts.size();
     }
     void generate_cpp_input(ofstream &outfile) const;
+    void generate_binary_input(BinaryTaskWriter &writer) const;
     void dump() const;
     void get_mutex_group(vector<pair<int, int>> &invariant_group) const;
 
@@ -1,3 +1,4 @@
+#include "binary_task_writer.h"
 #include "helper_functions.h"
 #include "operator.h"
 #include "variable.h"
@@ -123,6 +124,29 @@ void Operator::generate_cpp_input(ofstream &outfile) const {
     outfile << "end_operator" << endl;
 }
 
+void Operator::generate_binary_input(BinaryTaskWriter &writer) const {
+    writer.add_name(name);
+    writer.add(cost);
+    writer.add(prevail.size());
+    for (const auto &prev : prevail) {
+        assert(prev.var->get_level() != -1);
+        writer.add(prev.var->get_level());
+        writer.add(prev.prev);
+    }
+    writer.add(pre_post.size());
+    for (const auto &eff : pre_post) {
+        assert(eff.var->get_level() != -1);
+        writer.add(eff.effect_conds.size());
+        for (const auto &cond : eff.effect_conds) {
+            writer.add(cond.var->get_level());
+            writer.add(cond.cond);
+        }
+        writer.add(eff.var->get_level());
+        writer.add(eff.pre);
+        writer.add(eff.post);
+    }
+}
+
 // Removes ambiguity in the preconditions,
 // detects whether the operator is spurious
 void Operator::remove_ambiguity(const H2Mutexes &h2) {
@@ -163,77 +187,66 @@ void Operator::remove_ambiguity(const H2Mutexes &h2) {
     }
 
     // check that no precondition is unreachable or mutex with some other precondition
-    for (size_t i = 0; i < preconditions.size(); i++) {
+    vector<BitMatrix::Block> fact_set;
+    h2.clear_fact_set(fact_set);
+    for (int i = preconditions.size() - 1; i >= 0; i--) {
         if (preconditions[i] != -1) {
-            if (h2.is_unreachable(i, preconditions[i])) {
+            if (h2.is_unreachable(i, preconditions[i]) ||
+                h2.is_mutex_with_any(i, preconditions[i], fact_set)) {
                 spurious = true;
                 return;
             }
-            for (size_t j = i + 1; j < preconditions.size(); j++) {
-                if (h2.are_mutex(i, preconditions[i], j, preconditions[j])) {
-                    spurious = true;
-                    return;
-                }
-            }
+            h2.add_to_fact_set(i, preconditions[i], fact_set);
         }
     }
 
-    std::list<std::pair<unsigned, std::list<unsigned>>> candidates;
-    for (int i = 0; i < h2.num_variables(); i++) {
-        // consider unknown preconditions only
-        if (preconditions[i] != -1)
-            continue;
-
-        pair<unsigned, list<unsigned>> candidate_var = make_pair(i, list<unsigned>());
-        // add every reachable fluent
-        for (int j = 0; j < h2.num_values(i); j++)
-            candidate_var.second.push_back(j);
+    vector<BitMatrix::Block> effect_set;
+    h2.clear_fact_set(effect_set);
+    for (const pair<int, int> &effect : effects)
+        h2.add_to_fact_set(effect.first, effect.second, effect_set);
 
-        candidates.push_back(candidate_var);
+    // unknown preconditions; each of them may have any value of its variable
+    vector<int> candidates;
+    for (int i = 0; i < h2.num_variables(); i++) {
+        if (preconditions[i] == -1)
+            candidates.push_back(i);
     }
 
     // actual disambiguation process
     while (!known_values.empty()) {
         vector<pair<int, int>> aux_values;
+        h2.clear_fact_set(fact_set);
+        for (const pair<int, int> &known_value : known_values)
+            h2.add_to_fact_set(known_value.first, known_value.second, fact_set);
         // for each unknown variable
-        for (list<pair<unsigned, list<unsigned>>>::iterator it = candidates.begin(); it != candidates.end();) {
-            unsigned var = it->first;
-            list<unsigned> candidate_var = it->second;
-            // cout << var << " -> " << candidate_var.size() << endl;
-
+        size_t num_candidates = 0;
+        for (int var : candidates) {
             // we eliminate candidates mutex with other things
-            for (list<unsigned>::iterator it2 = candidate_var.begin(); it2 != candidate_var.end();) {
-                bool mutex = h2.is_unreachable(var, *it2);
-                for (size_t k = 0; !mutex && k < known_values.size(); k++)
-                    mutex = h2.are_mutex(known_values[k].first, known_values[k].second, var, *it2);
-
-                if (!effect_var[var]) {
-                    for (size_t k = 0; !mutex && k < effects.size(); k++)
-                        mutex = h2.are_mutex(effects[k].first, effects[k].second, var, *it2);
-                }
-
-
-
-                if (mutex) {
-                    it2 = candidate_var.erase(it2);
-                } else {
-                    ++it2;
+            // (known values and effects never contain a value of var here)
+            int num_possible = 0;
+            int possible_value = -1;
+            for (int val = 0; num_possible < 2 && val < h2.num_values(var); val++) {
+                bool mutex = h2.is_unreachable(var, val) ||
+                    h2.is_mutex_with_any(var, val, fact_set) ||
+                    (!effect_var[var] && h2.is_mutex_with_any(var, val, effect_set));
+                if (!mutex) {
+                    num_possible++;
+                    possible_value = val;
                 }
             }
 
             // we check the remaining candidates
-            if (candidate_var.empty()) { // if no fluent is possible for a given variable, the operator is spurious
+            if (num_possible == 0) { // if no fluent is possible for a given variable, the operator is spurious
                 spurious = true;
                 return;
-            } else if (candidate_var.size() == 1) { // add the single possible fluent to preconditions and aux_values and remove the variables from candidate
-                pair<int, int> new_fluent = make_pair(var, candidate_var.front());
-                aux_values.push_back(new_fluent);
-                preconditions[new_fluent.first] = new_fluent.second;
-                it = candidates.erase(it);
+            } else if (num_possible == 1) { // add the single possible fluent to preconditions and aux_values and remove the variables from candidate
+                aux_values.push_back(make_pair(var, possible_value));
+                preconditions[var] = possible_value;
             } else {
-                ++it;
+                candidates[num_candidates++] = var;
             }
         }
+        candidates.resize(num_candidates);
 
         known_values.swap(aux_values);
     }
@@ -248,6 +261,9 @@ void Operator::remove_ambiguity(const H2Mutexes &h2) {
     // important for backwards h^2
     // note: they may overlap with augmented preconditions
     potential_preconditions.clear();
+    h2.clear_fact_set(fact_set);
+    for (size_t i = 0; i < preconditions.size(); i++)
+        h2.add_to_fact_set(i, preconditions[i], fact_set);
     for (size_t i = 0; i < pre_post.size(); i++) {
         // for each undefined precondition
         if (pre_post[i].pre != -1)
@@ -261,11 +277,7 @@ void Operator::remove_ambiguity(const H2Mutexes &h2) {
 
         // for each fluent
         for (int j = 0; j < h2.num_values(var); j++) {
-            bool conflict = false;
-            for (size_t k = 0; !conflict && k < preconditions.size(); k++)
-                if (preconditions[k] != -1)
-                    conflict = h2.are_mutex(var, j, k, preconditions[k]);
-
+            bool conflict = h2.is_mutex_with_any(var, j, fact_set);
             if (!conflict)
                 potential_preconditions.push_back(make_pair(var, j));
         }
@@ -10,6 +10,7 @@
 #include "variable.h"
 using namespace std;
 
+class BinaryTaskWriter;
 class H2Mutexes;
 
 class Operator {
@@ -93,6 +94,7 @@ public:
     void dump() const;
     int get_encoding_size() const;
     void generate_cpp_input(ofstream &outfile) const;
+    void generate_binary_input(BinaryTaskWriter &writer) const;
     int get_cost() const {return cost; }
     string get_name() const {return name; }
     bool has_conditional_effects() const {
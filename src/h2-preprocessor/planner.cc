@@ -16,14 +16,25 @@
 #include "axiom.h"
 #include "h2_mutexes.h"
 #include "variable.h"
+#include <algorithm>
 #include <iostream>
+#include <thread>
 using namespace std;
 
+static void generate_unsolvable_output(const string &out_file_name, bool binary_output) {
+    if (binary_output)
+        generate_unsolvable_binary_input(out_file_name);
+    else
+        generate_unsolvable_cpp_input(out_file_name);
+}
+
 int main(int argc, const char **argv) {
     int h2_mutex_time = 300; // 5 minutes to compute mutexes by default
     bool include_augmented_preconditions = false;
     bool expensive_statistics = false;
     bool disable_bw_h2 = false;
+    int h2_threads = 1;
+    bool binary_output = false;
 
     bool metric;
     vector<Variable *> variables;
@@ -54,6 +65,15 @@ int main(int argc, const char **argv) {
                 cerr << "please specify the number of seconds after --h2_time_limit" << endl;
                 exit(2);
             }
+        } else if (arg.compare("--h2_threads") == 0) {
+            i++;
+            h2_threads = (i < argc) ? atoi(argv[i]) : -1;
+            if (h2_threads == 0)
+                h2_threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+            if (h2_threads < 1) {
+                cerr << "please specify a non-negative number of threads after --h2_threads (0: all hardware threads)" << endl;
+                exit(2);
+            }
         } else if (arg.compare("--output-file") == 0) {
             i++;
             if (i < argc) {
@@ -62,6 +82,8 @@ int main(int argc, const char **argv) {
                 cerr << "please specify the name of the output file after --output-file" << endl;
                 exit(2);
             }
+        } else if (arg.compare("--binary-output") == 0) {
+            binary_output = true;
         } else if (arg.compare("--no_h2") == 0) {
             h2_mutex_time = 0;
         } else if (arg.compare("--augmented_pre") == 0) {
@@ -72,7 +94,7 @@ int main(int argc, const char **argv) {
             expensive_statistics = true;
         } else {
             cerr << "unknown option " << arg << endl << endl;
-            cout << "Usage: ./preprocess [--no_rel] [--no_h2]  [--no_bw_h2] [--augmented_pre] [--stat] < output" << endl;
+            cout << "Usage: ./preprocess [--no_rel] [--no_h2]  [--no_bw_h2] [--h2_threads N] [--augmented_pre] [--stat] [--binary-output] [--output-file FILE] < output" << endl;
             exit(2);
         }
     }
@@ -109,10 +131,10 @@ int main(int argc, const char **argv) {
 
         if(!compute_h2_mutexes(ordering, operators, axioms,
                            mutexes, initial_state, goals,
-			       h2_mutex_time, disable_bw_h2)){
+			       h2_mutex_time, disable_bw_h2, h2_threads)){
 	                // TODO: don't duplicate the code to return an unsolvable task, log and exit here
             cout << "Unsolvable task in preprocessor" << endl;
-            generate_unsolvable_cpp_input(out_file_name);
+            generate_unsolvable_output(out_file_name, binary_output);
             cout << "done" << endl;
             return 0;
 	}
@@ -149,7 +171,7 @@ int main(int argc, const char **argv) {
         if (initial_state.remove_unreachable_facts()) {
             // TODO: don't duplicate the code to return an unsolvable task, log and exit here
             cout << "Unsolvable task in preprocessor" << endl;
-            generate_unsolvable_cpp_input(out_file_name);
+            generate_unsolvable_output(out_file_name, binary_output);
             cout << "done" << endl;
             return 0;
         }
@@ -278,7 +300,10 @@ int main(int argc, const char **argv) {
     cout << "Writing output..." << endl;
     if (ordering.empty()) {
         cout << "Unsolvable task in preprocessor" << endl;
-        generate_unsolvable_cpp_input(out_file_name);
+        generate_unsolvable_output(out_file_name, binary_output);
+    } else if (binary_output) {
+        generate_binary_input(out_file_name, ordering, metric, mutexes,
+                              initial_state, goals, operators, axioms);
     } else {
         generate_cpp_input(out_file_name,
             solveable_in_poly_time, ordering, metric,
@@ -1,5 +1,6 @@
 #include "variable.h"
 
+#include "binary_task_writer.h"
 #include "helper_functions.h"
 
 #include <cassert>
@@ -71,6 +72,15 @@ void Variable::generate_cpp_input(ofstream &outfile) const {
     outfile << "end_variable" << endl;
 }
 
+void Variable::generate_binary_input(BinaryTaskWriter &writer) const {
+    writer.add_name(name);
+    writer.add(layer);
+    writer.add(reachable_values);
+    for (size_t i = 0; i < values.size(); ++i)
+        if (reachable[i])
+            writer.add_name(values[i]);
+}
+
 void Variable::remove_unreachable_facts() {
     vector<string> new_values;
     for (size_t i = 0; i < values.size(); i++) {
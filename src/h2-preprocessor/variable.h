@@ -5,6 +5,8 @@
 #include <vector>
 using namespace std;
 
+class BinaryTaskWriter;
+
 class Variable {
     vector<string> values;
     string name;
@@ -25,6 +27,7 @@ public:
     int get_layer() const {return layer; }
     bool is_derived() const {return layer != -1; }
     void generate_cpp_input(ofstream &outfile) const;
+    void generate_binary_input(BinaryTaskWriter &writer) const;
     void dump() const;
 
     string get_fact_name(int value) const {
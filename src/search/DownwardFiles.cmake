@@ -116,6 +116,8 @@ fast_downward_plugin(
         utils/markup
         utils/math
         utils/memory
+        utils/parallel
+        utils/profiling
         utils/rng
         utils/rng_options
         utils/strings
@@ -161,6 +163,13 @@ fast_downward_plugin(
         open_lists/tiebreaking_open_list
 )
 
+fast_downward_plugin(
+    NAME TWO_LEVEL_BUCKET_OPEN_LIST
+    HELP "Open list with buckets indexed by two evaluator values"
+    SOURCES
+        open_lists/two_level_bucket_open_list
+)
+
 fast_downward_plugin(
     NAME TYPE_BASED_OPEN_LIST
     HELP "Type-based open list"
@@ -364,7 +373,7 @@ fast_downward_plugin(
     HELP "Basic classes used for all search engines"
     SOURCES
         search_engines/search_common
-    DEPENDS ALTERNATION_OPEN_LIST G_EVALUATOR BEST_FIRST_OPEN_LIST SUM_EVALUATOR TIEBREAKING_OPEN_LIST WEIGHTED_EVALUATOR
+    DEPENDS ALTERNATION_OPEN_LIST G_EVALUATOR BEST_FIRST_OPEN_LIST SUM_EVALUATOR TIEBREAKING_OPEN_LIST TWO_LEVEL_BUCKET_OPEN_LIST WEIGHTED_EVALUATOR
     DEPENDENCY_ONLY
 )
 
@@ -391,6 +400,10 @@ fast_downward_plugin(
     SOURCES
         kstar/top_k_eager_search
         kstar/plan_selector
+        kstar/json_plan_writer
+        kstar/kstar_metrics
+        kstar/adaptive_switching
+        kstar/path_graph_queue
     DEPENDS NULL_PRUNING_METHOD ORDERED_SET SUCCESSOR_GENERATOR STRUCTURAL_SYMMETRIES
     DEPENDENCY_ONLY
 )
@@ -588,6 +601,7 @@ fast_downward_plugin(
     NAME CORE_TASKS
     HELP "Core task transformations"
     SOURCES
+        tasks/binary_task_file
         tasks/cost_adapted_task
         tasks/delegating_task
         tasks/root_task
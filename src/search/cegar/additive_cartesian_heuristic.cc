@@ -2,27 +2,142 @@
 
 #include "cartesian_heuristic_function.h"
 #include "cost_saturation.h"
+#include "subtask_generators.h"
 #include "types.h"
 #include "utils.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../task_utils/task_properties.h"
+
+#include "../utils/collections.h"
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 
 #include <cassert>
+#include <cstring>
+#include <fstream>
 
 using namespace std;
 
 namespace cegar {
+static const char ABSTRACTIONS_FILE_MAGIC[8] = {
+    'C', 'E', 'G', 'A', 'R', 'H', '2', '\0'};
+
+/*
+  Hash everything that influences the computed abstractions: the task
+  (including its operator costs), the types and options of the subtask
+  generators and the options of the cost saturation. Each stored
+  hierarchy additionally checks that it is loaded for the same subtask.
+*/
+static uint64_t compute_fingerprint(
+    const options::Options &opts, const TaskProxy &task_proxy) {
+    utils::HashState hash_state;
+    task_properties::feed_task(hash_state, task_proxy);
+    vector<shared_ptr<SubtaskGenerator>> subtask_generators =
+        opts.get_list<shared_ptr<SubtaskGenerator>>("subtasks");
+    utils::feed(hash_state, subtask_generators.size());
+    for (const shared_ptr<SubtaskGenerator> &generator : subtask_generators)
+        generator->feed_configuration(hash_state);
+    utils::feed(hash_state, opts.get<int>("max_states"));
+    utils::feed(hash_state, opts.get<int>("max_transitions"));
+    utils::feed(hash_state, opts.get<bool>("use_general_costs"));
+    utils::feed(hash_state, static_cast<int>(opts.get<PickSplit>("pick")));
+    utils::feed(hash_state, opts.get<int>("random_seed"));
+    return hash_state.get_hash64();
+}
+
+static bool load_heuristic_functions(
+    const string &filename,
+    uint64_t fingerprint,
+    const vector<shared_ptr<SubtaskGenerator>> &subtask_generators,
+    const shared_ptr<AbstractTask> &task,
+    vector<CartesianHeuristicFunction> &functions) {
+    ifstream file(filename, ios::binary);
+    char magic[sizeof(ABSTRACTIONS_FILE_MAGIC)];
+    uint64_t file_fingerprint;
+    if (!file.read(magic, sizeof(magic)) ||
+        memcmp(magic, ABSTRACTIONS_FILE_MAGIC, sizeof(magic)) != 0 ||
+        !file.read(reinterpret_cast<char *>(&file_fingerprint),
+                   sizeof(file_fingerprint)) ||
+        file_fingerprint != fingerprint) {
+        return false;
+    }
+    vector<int> subtask_ids;
+    if (!read_ints(file, subtask_ids) || subtask_ids.size() % 2 != 0)
+        return false;
+
+    /*
+      The subtasks are cheap to compute compared to the abstractions, so
+      we recreate them to be able to convert states for the lookups.
+    */
+    vector<SharedTasks> subtasks_by_generator(subtask_generators.size());
+    vector<CartesianHeuristicFunction> loaded_functions;
+    for (size_t i = 0; i < subtask_ids.size(); i += 2) {
+        int generator_id = subtask_ids[i];
+        int subtask_id = subtask_ids[i + 1];
+        if (!utils::in_bounds(generator_id, subtask_generators))
+            return false;
+        SharedTasks &subtasks = subtasks_by_generator[generator_id];
+        if (subtasks.empty())
+            subtasks = subtask_generators[generator_id]->get_subtasks(task);
+        if (!utils::in_bounds(subtask_id, subtasks) ||
+            !CartesianHeuristicFunction::read(
+                file, subtasks[subtask_id], loaded_functions)) {
+            return false;
+        }
+    }
+    swap(functions, loaded_functions);
+    return true;
+}
+
+static void save_heuristic_functions(
+    const string &filename,
+    uint64_t fingerprint,
+    const vector<pair<int, int>> &subtask_ids,
+    const vector<CartesianHeuristicFunction> &functions) {
+    ofstream file(filename, ios::binary);
+    file.write(ABSTRACTIONS_FILE_MAGIC, sizeof(ABSTRACTIONS_FILE_MAGIC));
+    file.write(reinterpret_cast<const char *>(&fingerprint), sizeof(fingerprint));
+    vector<int> flat_subtask_ids;
+    for (const pair<int, int> &ids : subtask_ids) {
+        flat_subtask_ids.push_back(ids.first);
+        flat_subtask_ids.push_back(ids.second);
+    }
+    write_ints(file, flat_subtask_ids);
+    for (const CartesianHeuristicFunction &function : functions)
+        function.write(file);
+    if (!file) {
+        utils::g_log << "Failed to write abstractions to " << filename << endl;
+    }
+}
+
 static vector<CartesianHeuristicFunction> generate_heuristic_functions(
     const options::Options &opts) {
     utils::g_log << "Initializing additive Cartesian heuristic..." << endl;
     vector<shared_ptr<SubtaskGenerator>> subtask_generators =
         opts.get_list<shared_ptr<SubtaskGenerator>>("subtasks");
+    shared_ptr<AbstractTask> task = opts.get<shared_ptr<AbstractTask>>("transform");
+
+    bool use_file = opts.contains("abstractions_file");
+    string filename;
+    uint64_t fingerprint = 0;
+    if (use_file) {
+        filename = opts.get<string>("abstractions_file");
+        fingerprint = compute_fingerprint(opts, TaskProxy(*task));
+        vector<CartesianHeuristicFunction> functions;
+        if (load_heuristic_functions(
+                filename, fingerprint, subtask_generators, task, functions)) {
+            utils::g_log << "Loaded " << functions.size()
+                         << " Cartesian abstractions from " << filename << endl;
+            return functions;
+        }
+    }
+
     shared_ptr<utils::RandomNumberGenerator> rng =
         utils::parse_rng_from_options(opts);
     CostSaturation cost_saturation(
@@ -34,8 +149,13 @@ static vector<CartesianHeuristicFunction> generate_heuristic_functions(
         opts.get<PickSplit>("pick"),
         *rng,
         opts.get<bool>("debug"));
-    return cost_saturation.generate_heuristic_functions(
-        opts.get<shared_ptr<AbstractTask>>("transform"));
+    vector<CartesianHeuristicFunction> functions =
+        cost_saturation.generate_heuristic_functions(task);
+    if (use_file) {
+        save_heuristic_functions(
+            filename, fingerprint, cost_saturation.get_subtask_ids(), functions);
+    }
+    return functions;
 }
 
 AdditiveCartesianHeuristic::AdditiveCartesianHeuristic(
@@ -139,6 +259,13 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "debug",
         "print debugging output",
         "false");
+    parser.add_option<string>(
+        "abstractions_file",
+        "binary file for reusing abstractions across runs. If the file "
+        "contains abstractions for the same task and options, they are "
+        "loaded instead of being computed. Otherwise, the computed "
+        "abstractions are written to the file.",
+        OptionParser::NONE);
     Heuristic::add_options_to_parser(parser);
     utils::add_rng_options(parser);
     Options opts = parser.parse();
@@ -1,6 +1,7 @@
 #include "cartesian_heuristic_function.h"
 
 #include "refinement_hierarchy.h"
+#include "utils.h"
 
 #include "../utils/collections.h"
 
@@ -19,4 +20,27 @@ int CartesianHeuristicFunction::get_value(const State &state) const {
     assert(utils::in_bounds(abstract_state_id, h_values));
     return h_values[abstract_state_id];
 }
+
+void CartesianHeuristicFunction::write(ostream &os) const {
+    write_ints(os, h_values);
+    refinement_hierarchy->write(os);
+}
+
+bool CartesianHeuristicFunction::read(
+    istream &is, const shared_ptr<AbstractTask> &task,
+    vector<CartesianHeuristicFunction> &functions) {
+    vector<int> h_values;
+    if (!read_ints(is, h_values))
+        return false;
+    for (int h : h_values) {
+        if (h < 0)
+            return false;
+    }
+    unique_ptr<RefinementHierarchy> hierarchy =
+        RefinementHierarchy::read(is, task, h_values.size());
+    if (!hierarchy)
+        return false;
+    functions.emplace_back(move(hierarchy), move(h_values));
+    return true;
+}
 }
@@ -1,9 +1,12 @@
 #ifndef CEGAR_CARTESIAN_HEURISTIC_FUNCTION_H
 #define CEGAR_CARTESIAN_HEURISTIC_FUNCTION_H
 
+#include <istream>
 #include <memory>
+#include <ostream>
 #include <vector>
 
+class AbstractTask;
 class State;
 
 namespace cegar {
@@ -26,6 +29,17 @@ public:
     CartesianHeuristicFunction(CartesianHeuristicFunction &&) = default;
 
     int get_value(const State &state) const;
+
+    // Write the heuristic values and the hierarchy in binary format.
+    void write(std::ostream &os) const;
+
+    /*
+      Read a function written by write() for the given task. Return false
+      and leave functions unchanged if the data is malformed.
+    */
+    static bool read(
+        std::istream &is, const std::shared_ptr<AbstractTask> &task,
+        std::vector<CartesianHeuristicFunction> &functions);
 };
 }
 
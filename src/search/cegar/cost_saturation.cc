@@ -129,9 +129,10 @@ vector<CartesianHeuristicFunction> CostSaturation::generate_heuristic_functions(
         };
 
     utils::reserve_extra_memory_padding(memory_padding_in_mb);
-    for (const shared_ptr<SubtaskGenerator> &subtask_generator : subtask_generators) {
-        SharedTasks subtasks = subtask_generator->get_subtasks(task);
-        build_abstractions(subtasks, timer, should_abort);
+    for (size_t generator_id = 0; generator_id < subtask_generators.size();
+         ++generator_id) {
+        SharedTasks subtasks = subtask_generators[generator_id]->get_subtasks(task);
+        build_abstractions(generator_id, subtasks, timer, should_abort);
         if (should_abort())
             break;
     }
@@ -147,6 +148,7 @@ vector<CartesianHeuristicFunction> CostSaturation::generate_heuristic_functions(
 
 void CostSaturation::reset(const TaskProxy &task_proxy) {
     remaining_costs = task_properties::get_operator_costs(task_proxy);
+    subtask_ids.clear();
     num_abstractions = 0;
     num_states = 0;
 }
@@ -188,11 +190,13 @@ bool CostSaturation::state_is_dead_end(const State &state) const {
 }
 
 void CostSaturation::build_abstractions(
+    int generator_id,
     const vector<shared_ptr<AbstractTask>> &subtasks,
     const utils::CountdownTimer &timer,
     function<bool()> should_abort) {
     int rem_subtasks = subtasks.size();
-    for (shared_ptr<AbstractTask> subtask : subtasks) {
+    for (size_t subtask_id = 0; subtask_id < subtasks.size(); ++subtask_id) {
+        shared_ptr<AbstractTask> subtask = subtasks[subtask_id];
         subtask = get_remaining_costs_task(subtask);
 
         assert(num_states < max_states);
@@ -230,6 +234,7 @@ void CostSaturation::build_abstractions(
         heuristic_functions.emplace_back(
             abstraction->extract_refinement_hierarchy(),
             move(goal_distances));
+        subtask_ids.emplace_back(generator_id, subtask_id);
 
         reduce_remaining_costs(saturated_costs);
 
@@ -5,6 +5,7 @@
 #include "split_selector.h"
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace utils {
@@ -35,6 +36,7 @@ class CostSaturation {
     const bool debug;
 
     std::vector<CartesianHeuristicFunction> heuristic_functions;
+    std::vector<std::pair<int, int>> subtask_ids;
     std::vector<int> remaining_costs;
     int num_abstractions;
     int num_states;
@@ -46,6 +48,7 @@ class CostSaturation {
         std::shared_ptr<AbstractTask> &parent) const;
     bool state_is_dead_end(const State &state) const;
     void build_abstractions(
+        int generator_id,
         const std::vector<std::shared_ptr<AbstractTask>> &subtasks,
         const utils::CountdownTimer &timer,
         std::function<bool()> should_abort);
@@ -64,6 +67,15 @@ public:
 
     std::vector<CartesianHeuristicFunction> generate_heuristic_functions(
         const std::shared_ptr<AbstractTask> &task);
+
+    /*
+      For each heuristic function returned by the last call to
+      generate_heuristic_functions(), return the index of its subtask
+      generator and the index of its subtask in the generator's output.
+    */
+    const std::vector<std::pair<int, int>> &get_subtask_ids() const {
+        return subtask_ids;
+    }
 };
 }
 
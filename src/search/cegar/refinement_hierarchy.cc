@@ -1,30 +1,30 @@
 #include "refinement_hierarchy.h"
 
+#include "utils.h"
+
 #include "../task_proxy.h"
 
+#include "../utils/hash.h"
+#include "../utils/memory.h"
+
 using namespace std;
 
 namespace cegar {
 Node::Node(int state_id)
-    : left_child(UNDEFINED),
-      right_child(UNDEFINED),
-      var(UNDEFINED),
-      value(UNDEFINED),
-      state_id(state_id) {
+    : var(UNDEFINED),
+      value(state_id),
+      left_child(UNDEFINED),
+      right_child(UNDEFINED) {
     assert(state_id != UNDEFINED);
     assert(!is_split());
 }
 
 bool Node::information_is_valid() const {
-    return (left_child == UNDEFINED && right_child == UNDEFINED &&
-            var == UNDEFINED && value == UNDEFINED && state_id != UNDEFINED) ||
-           (left_child != UNDEFINED && right_child != UNDEFINED &&
-            var != UNDEFINED && value != UNDEFINED && state_id == UNDEFINED);
-}
-
-bool Node::is_split() const {
-    assert(information_is_valid());
-    return left_child != UNDEFINED;
+    return value != UNDEFINED &&
+           ((var == UNDEFINED && left_child == UNDEFINED &&
+             right_child == UNDEFINED) ||
+            (var != UNDEFINED && left_child != UNDEFINED &&
+             right_child != UNDEFINED));
 }
 
 void Node::split(int var, int value, NodeID left_child, NodeID right_child) {
@@ -32,19 +32,38 @@ void Node::split(int var, int value, NodeID left_child, NodeID right_child) {
     this->value = value;
     this->left_child = left_child;
     this->right_child = right_child;
-    state_id = UNDEFINED;
     assert(is_split());
 }
 
 
 
 ostream &operator<<(ostream &os, const Node &node) {
-    return os << "<Node: var=" << node.var << " value=" << node.value
-              << " state=" << node.state_id << " left=" << node.left_child
-              << " right=" << node.right_child << ">";
+    if (node.is_split()) {
+        return os << "<Node: var=" << node.var << " value=" << node.value
+                  << " left=" << node.left_child
+                  << " right=" << node.right_child << ">";
+    }
+    return os << "<Node: state=" << node.value << ">";
 }
 
 
+/*
+  Hash the parts of the task that identify a subtask: the variables, the
+  goals and the initial state. Operator costs are excluded because the
+  hierarchy is built for the remaining costs of the subtask.
+*/
+static vector<int> compute_task_signature(const AbstractTask &task) {
+    TaskProxy task_proxy(task);
+    utils::HashState hash_state;
+    for (VariableProxy var : task_proxy.get_variables())
+        utils::feed(hash_state, var.get_domain_size());
+    for (FactProxy goal : task_proxy.get_goals())
+        utils::feed(hash_state, goal.get_pair());
+    utils::feed(hash_state, task_proxy.get_initial_state().get_unpacked_values());
+    uint64_t hash = hash_state.get_hash64();
+    return {static_cast<int>(hash & 0xffffffff), static_cast<int>(hash >> 32)};
+}
+
 RefinementHierarchy::RefinementHierarchy(const shared_ptr<AbstractTask> &task)
     : task(task) {
     nodes.emplace_back(0);
@@ -56,11 +75,11 @@ NodeID RefinementHierarchy::add_node(int state_id) {
     return node_id;
 }
 
-NodeID RefinementHierarchy::get_node_id(const State &state) const {
+NodeID RefinementHierarchy::get_node_id(const vector<int> &state_values) const {
     NodeID id = 0;
     while (nodes[id].is_split()) {
         const Node &node = nodes[id];
-        id = node.get_child(state[node.get_var()].get_value());
+        id = node.get_child(state_values[node.get_var()]);
     }
     return id;
 }
@@ -80,6 +99,91 @@ pair<NodeID, NodeID> RefinementHierarchy::split(
 int RefinementHierarchy::get_abstract_state_id(const State &state) const {
     TaskProxy subtask_proxy(*task);
     State subtask_state = subtask_proxy.convert_ancestor_state(state);
-    return nodes[get_node_id(subtask_state)].get_state_id();
+    return nodes[get_node_id(subtask_state.get_unpacked_values())].get_state_id();
+}
+
+void RefinementHierarchy::write(ostream &os) const {
+    write_ints(os, compute_task_signature(*task));
+    vector<int> data;
+    data.reserve(4 * nodes.size());
+    for (const Node &node : nodes) {
+        data.push_back(node.var);
+        data.push_back(node.value);
+        data.push_back(node.left_child);
+        data.push_back(node.right_child);
+    }
+    write_ints(os, data);
+}
+
+unique_ptr<RefinementHierarchy> RefinementHierarchy::read(
+    istream &is, const shared_ptr<AbstractTask> &task, int num_states) {
+    vector<int> signature;
+    if (!read_ints(is, signature) || signature != compute_task_signature(*task))
+        return nullptr;
+    vector<int> data;
+    if (!read_ints(is, data) || data.empty() || data.size() % 4 != 0)
+        return nullptr;
+    int num_nodes = data.size() / 4;
+    TaskProxy task_proxy(*task);
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_variables = variables.size();
+    unique_ptr<RefinementHierarchy> hierarchy =
+        utils::make_unique_ptr<RefinementHierarchy>(task);
+    hierarchy->nodes.assign(num_nodes, Node(0));
+    for (int id = 0; id < num_nodes; ++id) {
+        Node &node = hierarchy->nodes[id];
+        node.var = data[4 * id];
+        node.value = data[4 * id + 1];
+        node.left_child = data[4 * id + 2];
+        node.right_child = data[4 * id + 3];
+        bool valid;
+        if (node.var == UNDEFINED) {
+            valid = node.value >= 0 && node.value < num_states &&
+                node.left_child == UNDEFINED && node.right_child == UNDEFINED;
+        } else {
+            valid = node.var >= 0 && node.var < num_variables &&
+                node.value >= 0 &&
+                node.value < variables[node.var].get_domain_size() &&
+                node.left_child >= 0 && node.left_child < num_nodes &&
+                node.right_child >= 0 && node.right_child < num_nodes;
+        }
+        if (!valid)
+            return nullptr;
+    }
+    // Lookups would not terminate on a cycle.
+    if (hierarchy->has_cycle())
+        return nullptr;
+    return hierarchy;
+}
+
+bool RefinementHierarchy::has_cycle() const {
+    enum class Mark {
+        UNVISITED,
+        ON_STACK,
+        DONE
+    };
+    vector<Mark> marks(nodes.size(), Mark::UNVISITED);
+    // Pairs of node ID and number of children that have been expanded.
+    vector<pair<NodeID, int>> stack;
+    stack.emplace_back(0, 0);
+    marks[0] = Mark::ON_STACK;
+    while (!stack.empty()) {
+        pair<NodeID, int> &entry = stack.back();
+        const Node &node = nodes[entry.first];
+        if (!node.is_split() || entry.second == 2) {
+            marks[entry.first] = Mark::DONE;
+            stack.pop_back();
+            continue;
+        }
+        NodeID child = (entry.second == 0) ? node.left_child : node.right_child;
+        ++entry.second;
+        if (marks[child] == Mark::ON_STACK)
+            return true;
+        if (marks[child] == Mark::UNVISITED) {
+            marks[child] = Mark::ON_STACK;
+            stack.emplace_back(child, 0);
+        }
+    }
+    return false;
 }
 }
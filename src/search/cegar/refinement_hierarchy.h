@@ -4,6 +4,7 @@
 #include "types.h"
 
 #include <cassert>
+#include <istream>
 #include <memory>
 #include <ostream>
 #include <utility>
@@ -26,13 +27,20 @@ class Node;
   helper nodes, see below). Leaf nodes correspond to the current
   (unsplit) states in an abstraction. The use of helper nodes makes
   this structure a directed acyclic graph (instead of a tree).
+
+  All nodes live in one contiguous vector of fixed-size records and are
+  addressed by their index, so lookups walk a flat array and the
+  hierarchy can be written to and read from binary files without any
+  pointer translation.
 */
 class RefinementHierarchy {
     std::shared_ptr<AbstractTask> task;
     std::vector<Node> nodes;
 
     NodeID add_node(int state_id);
-    NodeID get_node_id(const State &state) const;
+    NodeID get_node_id(const std::vector<int> &state_values) const;
+    // Return true iff a cycle is reachable from the root node.
+    bool has_cycle() const;
 
 public:
     explicit RefinementHierarchy(const std::shared_ptr<AbstractTask> &task);
@@ -48,33 +56,56 @@ public:
         int left_state_id, int right_state_id);
 
     int get_abstract_state_id(const State &state) const;
+
+    /*
+      Write the nodes in the binary format expected by read(), preceded by
+      a signature of the task.
+    */
+    void write(std::ostream &os) const;
+
+    /*
+      Read a hierarchy written by write() for the given task. Return nullptr
+      if the data is malformed, was written for a different task, contains
+      a cycle or refers to abstract states with IDs of at least num_states.
+    */
+    static std::unique_ptr<RefinementHierarchy> read(
+        std::istream &is, const std::shared_ptr<AbstractTask> &task,
+        int num_states);
 };
 
 
 class Node {
+    friend class RefinementHierarchy;
+
+    /*
+      Before splitting the corresponding state, var holds UNDEFINED and
+      value holds the ID of the abstract state. Afterwards, var and value
+      describe the split fact. Storing the state ID in value keeps nodes
+      at four integers, and testing var first during lookups touches
+      only the first word of each node.
+    */
+    int var;
+    int value;
+
     /*
       While right_child is always the node of a (possibly split)
       abstract state, left_child may be a helper node. We add helper
       nodes to the hierarchy to allow for efficient lookup in case more
-      than one fact is split off a state.
+      than one fact is split off a state. Both hold UNDEFINED before
+      splitting.
     */
     NodeID left_child;
     NodeID right_child;
 
-    /* Before splitting the corresponding state for var and value, both
-       members hold UNDEFINED. */
-    int var;
-    int value;
-
-    // When splitting the corresponding state, we change this value to UNDEFINED.
-    int state_id;
-
     bool information_is_valid() const;
 
 public:
     explicit Node(int state_id);
 
-    bool is_split() const;
+    bool is_split() const {
+        assert(information_is_valid());
+        return var != UNDEFINED;
+    }
 
     void split(int var, int value, NodeID left_child, NodeID right_child);
 
@@ -92,7 +123,7 @@ public:
 
     int get_state_id() const {
         assert(!is_split());
-        return state_id;
+        return value;
     }
 
     friend std::ostream &operator<<(std::ostream &os, const Node &node);
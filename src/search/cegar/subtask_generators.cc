@@ -11,6 +11,7 @@
 #include "../task_utils/task_properties.h"
 #include "../tasks/domain_abstracted_task_factory.h"
 #include "../tasks/modified_goals_task.h"
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
@@ -91,6 +92,13 @@ static Facts filter_and_order_facts(
     return facts;
 }
 
+// Distinguishes the generator types in feed_configuration().
+enum class GeneratorType {
+    ORIGINAL,
+    GOALS,
+    LANDMARKS
+};
+
 
 TaskDuplicator::TaskDuplicator(const Options &opts)
     : num_copies(opts.get<int>("copies")) {
@@ -106,8 +114,14 @@ SharedTasks TaskDuplicator::get_subtasks(
     return subtasks;
 }
 
+void TaskDuplicator::feed_configuration(utils::HashState &hash_state) const {
+    utils::feed(hash_state, static_cast<int>(GeneratorType::ORIGINAL));
+    utils::feed(hash_state, num_copies);
+}
+
 GoalDecomposition::GoalDecomposition(const Options &opts)
     : fact_order(opts.get<FactOrder>("order")),
+      random_seed(opts.get<int>("random_seed")),
       rng(utils::parse_rng_from_options(opts)) {
 }
 
@@ -125,10 +139,17 @@ SharedTasks GoalDecomposition::get_subtasks(
     return subtasks;
 }
 
+void GoalDecomposition::feed_configuration(utils::HashState &hash_state) const {
+    utils::feed(hash_state, static_cast<int>(GeneratorType::GOALS));
+    utils::feed(hash_state, static_cast<int>(fact_order));
+    utils::feed(hash_state, random_seed);
+}
+
 
 LandmarkDecomposition::LandmarkDecomposition(const Options &opts)
     : fact_order(opts.get<FactOrder>("order")),
       combine_facts(opts.get<bool>("combine_facts")),
+      random_seed(opts.get<int>("random_seed")),
       rng(utils::parse_rng_from_options(opts)) {
 }
 
@@ -166,6 +187,13 @@ SharedTasks LandmarkDecomposition::get_subtasks(
     return subtasks;
 }
 
+void LandmarkDecomposition::feed_configuration(utils::HashState &hash_state) const {
+    utils::feed(hash_state, static_cast<int>(GeneratorType::LANDMARKS));
+    utils::feed(hash_state, static_cast<int>(fact_order));
+    utils::feed(hash_state, combine_facts);
+    utils::feed(hash_state, random_seed);
+}
+
 static shared_ptr<SubtaskGenerator> _parse_original(OptionParser &parser) {
     parser.add_option<int>(
         "copies",
@@ -16,6 +16,7 @@ class Options;
 }
 
 namespace utils {
+class HashState;
 class RandomNumberGenerator;
 }
 
@@ -38,6 +39,13 @@ class SubtaskGenerator {
 public:
     virtual SharedTasks get_subtasks(
         const std::shared_ptr<AbstractTask> &task) const = 0;
+
+    /*
+      Feed the type and all options of the generator into hash_state. This
+      allows detecting stored abstractions that were computed for other
+      subtasks.
+    */
+    virtual void feed_configuration(utils::HashState &hash_state) const = 0;
     virtual ~SubtaskGenerator() = default;
 };
 
@@ -53,6 +61,7 @@ public:
 
     virtual SharedTasks get_subtasks(
         const std::shared_ptr<AbstractTask> &task) const override;
+    virtual void feed_configuration(utils::HashState &hash_state) const override;
 };
 
 
@@ -61,6 +70,7 @@ public:
 */
 class GoalDecomposition : public SubtaskGenerator {
     FactOrder fact_order;
+    int random_seed;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
 public:
@@ -68,6 +78,7 @@ public:
 
     virtual SharedTasks get_subtasks(
         const std::shared_ptr<AbstractTask> &task) const override;
+    virtual void feed_configuration(utils::HashState &hash_state) const override;
 };
 
 
@@ -78,6 +89,7 @@ public:
 class LandmarkDecomposition : public SubtaskGenerator {
     FactOrder fact_order;
     bool combine_facts;
+    int random_seed;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     /* Perform domain abstraction by combining facts that have to be
@@ -92,6 +104,7 @@ public:
 
     virtual SharedTasks get_subtasks(
         const std::shared_ptr<AbstractTask> &task) const override;
+    virtual void feed_configuration(utils::HashState &hash_state) const override;
 };
 }
 
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <unordered_map>
 
 using namespace std;
@@ -88,4 +89,36 @@ vector<int> get_domain_sizes(const TaskProxy &task) {
         domain_sizes.push_back(var.get_domain_size());
     return domain_sizes;
 }
+
+void write_ints(ostream &os, const vector<int> &values) {
+    int size = values.size();
+    os.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    os.write(reinterpret_cast<const char *>(values.data()),
+             size * sizeof(int));
+}
+
+static streamoff get_remaining_size(istream &is) {
+    streampos pos = is.tellg();
+    if (pos == streampos(-1) || !is.seekg(0, ios::end))
+        return -1;
+    streampos end = is.tellg();
+    is.seekg(pos);
+    return end - pos;
+}
+
+bool read_ints(istream &is, vector<int> &values) {
+    int size;
+    if (!is.read(reinterpret_cast<char *>(&size), sizeof(size)) || size < 0)
+        return false;
+    // Don't trust a corrupted size to allocate the vector.
+    streamoff remaining_size = get_remaining_size(is);
+    if (remaining_size < 0 ||
+        static_cast<uint64_t>(size) * sizeof(int) >
+        static_cast<uint64_t>(remaining_size)) {
+        return false;
+    }
+    values.resize(size);
+    return static_cast<bool>(
+        is.read(reinterpret_cast<char *>(values.data()), size * sizeof(int)));
+}
 }
@@ -5,7 +5,9 @@
 
 #include "../utils/hash.h"
 
+#include <istream>
 #include <memory>
+#include <ostream>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -29,6 +31,15 @@ extern utils::HashSet<FactProxy> get_relaxed_possible_before(
     const TaskProxy &task, const FactProxy &fact);
 
 extern std::vector<int> get_domain_sizes(const TaskProxy &task);
+
+/*
+  Write the values in a compact binary format (size followed by the raw
+  integers) and read them back. read_ints() returns false if the stream
+  ends prematurely, holds a negative size or a size larger than the rest
+  of the stream, or is not seekable.
+*/
+extern void write_ints(std::ostream &os, const std::vector<int> &values);
+extern bool read_ints(std::istream &is, std::vector<int> &values);
 }
 
 /*
@@ -45,7 +45,10 @@ EvaluationContext::EvaluationContext(
 const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
     EvaluationResult &result = cache[evaluator];
     if (result.is_uninitialized()) {
-        result = evaluator->compute_result(*this);
+        {
+            PROFILE_COMPONENT_SCOPE(evaluator->get_profiling_component());
+            result = evaluator->compute_result(*this);
+        }
         if (statistics &&
             evaluator->is_used_for_counting_evaluations() &&
             result.get_count_evaluation()) {
@@ -6,6 +6,7 @@
 #include "utils/logging.h"
 #include "utils/system.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -18,13 +19,22 @@ Evaluator::Evaluator(const string &description,
     : description(description),
       use_for_reporting_minima(use_for_reporting_minima),
       use_for_boosting(use_for_boosting),
-      use_for_counting_evaluations(use_for_counting_evaluations) {
+      use_for_counting_evaluations(use_for_counting_evaluations)
+#ifdef USE_PROFILING
+    , profiling_component(utils::get_profiling_component("evaluator " + description))
+#endif
+{
 }
 
 bool Evaluator::dead_ends_are_reliable() const {
     return true;
 }
 
+void Evaluator::get_involved_evaluators(vector<Evaluator *> &evals) {
+    if (find(evals.begin(), evals.end(), this) == evals.end())
+        evals.push_back(this);
+}
+
 void Evaluator::report_value_for_initial_state(
     const EvaluationResult &result, utils::LogProxy &log) const {
     assert(use_for_reporting_minima);
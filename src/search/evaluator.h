@@ -3,7 +3,10 @@
 
 #include "evaluation_result.h"
 
+#include "utils/profiling.h"
+
 #include <set>
+#include <vector>
 
 class EvaluationContext;
 class State;
@@ -17,6 +20,10 @@ class Evaluator {
     const bool use_for_reporting_minima;
     const bool use_for_boosting;
     const bool use_for_counting_evaluations;
+#ifdef USE_PROFILING
+    // Shared by all evaluators with the same description.
+    utils::ProfilingComponent &profiling_component;
+#endif
 
 public:
     Evaluator(
@@ -47,6 +54,23 @@ public:
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) = 0;
 
+    /*
+      get_involved_evaluators should append this evaluator and all
+      evaluators that it directly or indirectly depends on to the result
+      vector, skipping those that are already contained. Unlike a set of
+      pointers, the vector has a deterministic order.
+
+      The default implementation only appends the evaluator itself.
+    */
+    virtual void get_involved_evaluators(std::vector<Evaluator *> &evals);
+
+    /*
+      Print statistics collected during the search. Search engines call
+      this once for each involved evaluator after the search.
+    */
+    virtual void print_statistics() const {
+    }
+
 
     virtual void notify_initial_state(const State & /*initial_state*/) {
     }
@@ -86,6 +110,11 @@ public:
         const EvaluationResult &result, utils::LogProxy &log) const;
 
     const std::string &get_description() const;
+#ifdef USE_PROFILING
+    utils::ProfilingComponent &get_profiling_component() const {
+        return profiling_component;
+    }
+#endif
     bool is_used_for_reporting_minima() const;
     bool is_used_for_boosting() const;
     bool is_used_for_counting_evaluations() const;
@@ -50,4 +50,11 @@ void CombiningEvaluator::get_path_dependent_evaluators(
     for (auto &subevaluator : subevaluators)
         subevaluator->get_path_dependent_evaluators(evals);
 }
+
+void CombiningEvaluator::get_involved_evaluators(
+    vector<Evaluator *> &evals) {
+    Evaluator::get_involved_evaluators(evals);
+    for (auto &subevaluator : subevaluators)
+        subevaluator->get_involved_evaluators(evals);
+}
 }
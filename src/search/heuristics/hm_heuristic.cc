@@ -5,24 +5,132 @@
 
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/system.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iostream>
+#include <iterator>
 #include <limits>
-#include <set>
+#include <numeric>
 
 using namespace std;
 
 namespace hm_heuristic {
+static const int INF = numeric_limits<int>::max();
+static const int UNDEFINED = -1;
+static const int CONFLICT = -2;
+
+template<typename Callback>
+static bool for_each_subset_aux(
+    const vector<int> &tuple, size_t start, int max_size,
+    vector<int> &subset, const Callback &callback) {
+    for (size_t i = start; i < tuple.size(); ++i) {
+        subset.push_back(tuple[i]);
+        bool proceed = callback(subset) &&
+            (static_cast<int>(subset.size()) == max_size ||
+             for_each_subset_aux(tuple, i + 1, max_size, subset, callback));
+        subset.pop_back();
+        if (!proceed)
+            return false;
+    }
+    return true;
+}
+
+/*
+  Call callback for all non-empty subsets of tuple with at most max_size
+  elements, using subset as scratch space. Stop and return false as soon
+  as callback returns false.
+*/
+template<typename Callback>
+static bool for_each_subset(
+    const vector<int> &tuple, int max_size, vector<int> &subset,
+    const Callback &callback) {
+    subset.clear();
+    if (max_size <= 0)
+        return true;
+    return for_each_subset_aux(tuple, 0, max_size, subset, callback);
+}
+
+static size_t saturating_add(size_t a, size_t b) {
+    return (a > numeric_limits<size_t>::max() - b) ?
+           numeric_limits<size_t>::max() : a + b;
+}
+
 HMHeuristic::HMHeuristic(const Options &opts)
     : Heuristic(opts),
       m(opts.get<int>("m")),
       has_cond_effects(task_properties::has_conditional_effects(task_proxy)),
-      goals(task_properties::get_fact_pairs(task_proxy.get_goals())) {
+      small_tuple_changed(false),
+      sweep_id(0) {
     utils::g_log << "Using h^" << m << "." << endl;
-    utils::g_log << "The implementation of the h^m heuristic is preliminary." << endl
-                 << "It is SLOOOOOOOOOOOW." << endl
-                 << "Please do not use this for comparison!" << endl;
-    generate_all_tuples();
+    utils::g_log << "The implementation of the h^m heuristic is preliminary." << endl;
+
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_facts = 0;
+    for (VariableProxy var : variables) {
+        fact_id_offsets.push_back(num_facts);
+        for (int value = 0; value < var.get_domain_size(); ++value)
+            fact_to_var.push_back(var.get_id());
+        num_facts += var.get_domain_size();
+    }
+    fact_id_offsets.push_back(num_facts);
+
+    auto get_fact_id = [&](const FactProxy &fact) {
+               return fact_id_offsets[fact.get_variable().get_id()] +
+                      fact.get_value();
+           };
+    for (FactProxy goal : task_proxy.get_goals())
+        goals.push_back(get_fact_id(goal));
+    sort(goals.begin(), goals.end());
+
+    OperatorsProxy operators = task_proxy.get_operators();
+    operators_by_precondition_fact.resize(num_facts);
+    for (OperatorProxy op : operators) {
+        Tuple pre;
+        for (FactProxy fact : op.get_preconditions()) {
+            pre.push_back(get_fact_id(fact));
+            operators_by_precondition_fact[pre.back()].push_back(op.get_id());
+        }
+        sort(pre.begin(), pre.end());
+        operator_preconditions.push_back(move(pre));
+
+        Tuple eff;
+        for (EffectProxy effect : op.get_effects())
+            eff.push_back(get_fact_id(effect.get_fact()));
+        sort(eff.begin(), eff.end());
+        eff.erase(unique(eff.begin(), eff.end()), eff.end());
+        operator_effects.push_back(move(eff));
+
+        operator_costs.push_back(op.get_cost());
+    }
+
+    binomials.assign(m + 1, vector<size_t>(num_facts + 1, 0));
+    for (int n = 0; n <= num_facts; ++n)
+        binomials[0][n] = 1;
+    for (int k = 1; k <= m; ++k) {
+        for (int n = 1; n <= num_facts; ++n) {
+            binomials[k][n] = saturating_add(
+                binomials[k - 1][n - 1], binomials[k][n - 1]);
+        }
+    }
+    size_offsets.assign(m + 2, 0);
+    for (int k = 1; k <= m; ++k) {
+        size_offsets[k + 1] = saturating_add(
+            size_offsets[k], binomials[k][num_facts]);
+    }
+    size_t table_size = size_offsets[m + 1];
+    if (table_size >= hm_table.max_size()) {
+        cerr << "The h^" << m << " table for this task is too large." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    hm_table.resize(table_size);
+    utils::g_log << "h^m table entries: " << table_size << endl;
+
+    fact_change_marks.assign(num_facts, -1);
+    operator_marks.assign(operators.size(), -1);
+    current_pre_values.assign(variables.size(), UNDEFINED);
+    current_eff_values.assign(variables.size(), UNDEFINED);
 }
 
 
@@ -36,231 +144,262 @@ int HMHeuristic::compute_heuristic(const State &ancestor_state) {
     if (task_properties::is_goal_state(task_proxy, state)) {
         return 0;
     } else {
-        Tuple s_tup = task_properties::get_fact_pairs(state);
+        Tuple state_facts;
+        for (FactProxy fact : state)
+            state_facts.push_back(
+                fact_id_offsets[fact.get_variable().get_id()] + fact.get_value());
 
-        init_hm_table(s_tup);
+        init_hm_table(state_facts);
         update_hm_table();
 
         int h = eval(goals);
 
-        if (h == numeric_limits<int>::max())
+        if (h == INF)
             return DEAD_END;
         return h;
     }
 }
 
 
-void HMHeuristic::init_hm_table(const Tuple &t) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        int h_val = check_tuple_in_tuple(tuple, t);
-        hm_table[tuple] = h_val;
-    }
+size_t HMHeuristic::get_index(const Tuple &tuple) const {
+    assert(!tuple.empty() && static_cast<int>(tuple.size()) <= m);
+    size_t index = size_offsets[tuple.size()];
+    for (size_t i = 0; i < tuple.size(); ++i)
+        index += binomials[i + 1][tuple[i]];
+    return index;
 }
 
 
-void HMHeuristic::update_hm_table() {
-    int round = 0;
-    do {
-        ++round;
-        was_updated = false;
-
-        for (OperatorProxy op : task_proxy.get_operators()) {
-            Tuple pre = get_operator_pre(op);
-
-            int c1 = eval(pre);
-            if (c1 != numeric_limits<int>::max()) {
-                Tuple eff = get_operator_eff(op);
-                vector<Tuple> partial_effs;
-                generate_all_partial_tuples(eff, partial_effs);
-                for (Tuple &partial_eff : partial_effs) {
-                    update_hm_entry(partial_eff, c1 + op.get_cost());
-
-                    int eff_size = partial_eff.size();
-                    if (eff_size < m) {
-                        extend_tuple(partial_eff, op);
-                    }
-                }
-            }
-        }
-    } while (was_updated);
+bool HMHeuristic::has_distinct_variables(const Tuple &tuple) const {
+    // Facts of the same variable have adjacent IDs.
+    for (size_t i = 1; i < tuple.size(); ++i) {
+        if (fact_to_var[tuple[i - 1]] == fact_to_var[tuple[i]])
+            return false;
+    }
+    return true;
 }
 
 
-void HMHeuristic::extend_tuple(const Tuple &t, const OperatorProxy &op) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        bool contradict = false;
-        for (const FactPair &fact : tuple) {
-            if (contradict_effect_of(op, fact.var, fact.value)) {
-                contradict = true;
-                break;
-            }
-        }
-        if (!contradict && (tuple.size() > t.size()) && (check_tuple_in_tuple(t, tuple) == 0)) {
-            Tuple pre = get_operator_pre(op);
-
-            Tuple others;
-            for (const FactPair &fact : tuple) {
-                if (find(t.begin(), t.end(), fact) == t.end()) {
-                    others.push_back(fact);
-                    if (find(pre.begin(), pre.end(), fact) == pre.end()) {
-                        pre.push_back(fact);
-                    }
-                }
-            }
-
-            sort(pre.begin(), pre.end());
+void HMHeuristic::init_hm_table(const Tuple &state_facts) {
+    fill(hm_table.begin(), hm_table.end(), INF);
+    for_each_subset(
+        state_facts, m, subset,
+        [this](const Tuple &tuple) {
+            hm_table[get_index(tuple)] = 0;
+            return true;
+        });
+}
 
-            set<int> vars;
-            bool is_valid = true;
-            for (const FactPair &fact : pre) {
-                if (vars.count(fact.var) != 0) {
-                    is_valid = false;
-                    break;
-                }
-                vars.insert(fact.var);
-            }
 
-            if (is_valid) {
-                int c2 = eval(pre);
-                if (c2 != numeric_limits<int>::max()) {
-                    update_hm_entry(tuple, c2 + op.get_cost());
+void HMHeuristic::update_hm_table() {
+    int num_operators = operator_costs.size();
+    vector<int> operators(num_operators);
+    iota(operators.begin(), operators.end(), 0);
+    vector<int> next_operators;
+    while (!operators.empty()) {
+        ++sweep_id;
+        small_tuple_changed = false;
+        changed_facts.clear();
+
+        for (int op_id : operators)
+            apply_operator(op_id);
+
+        /*
+          An operator reads the entries of tuples that contain at least one
+          of its preconditions or have less than m facts.
+        */
+        next_operators.clear();
+        if (small_tuple_changed) {
+            next_operators.resize(num_operators);
+            iota(next_operators.begin(), next_operators.end(), 0);
+        } else {
+            for (int fact : changed_facts) {
+                for (int op_id : operators_by_precondition_fact[fact]) {
+                    if (operator_marks[op_id] != sweep_id) {
+                        operator_marks[op_id] = sweep_id;
+                        next_operators.push_back(op_id);
+                    }
                 }
             }
+            sort(next_operators.begin(), next_operators.end());
         }
+        swap(operators, next_operators);
     }
 }
 
 
-int HMHeuristic::eval(const Tuple &t) const {
-    vector<Tuple> partial;
-    generate_all_partial_tuples(t, partial);
-    int max = 0;
-    for (Tuple &tuple : partial) {
-        assert(hm_table.count(tuple) == 1);
-
-        int h = hm_table.at(tuple);
-        if (h > max) {
-            max = h;
-        }
+void HMHeuristic::apply_operator(int op_id) {
+    const Tuple &pre = operator_preconditions[op_id];
+    int c1 = eval(pre);
+    if (c1 == INF)
+        return;
+
+    const Tuple &eff = operator_effects[op_id];
+    for (int fact : pre)
+        current_pre_values[fact_to_var[fact]] = fact - fact_id_offsets[fact_to_var[fact]];
+    for (int fact : eff) {
+        int var = fact_to_var[fact];
+        int value = fact - fact_id_offsets[var];
+        int &eff_value = current_eff_values[var];
+        eff_value = (eff_value == UNDEFINED || eff_value == value) ? value : CONFLICT;
     }
-    return max;
+
+    int cost = operator_costs[op_id];
+    for_each_subset(
+        eff, m, effect_subset,
+        [&](const Tuple &partial_eff) {
+            /* With conditional effects, an operator can have effects with
+               different values on the same variable. Such sets of facts
+               cannot be true together and have no table entry. */
+            if (has_distinct_variables(partial_eff)) {
+                update_hm_entry(partial_eff, c1 + cost);
+                if (static_cast<int>(partial_eff.size()) < m)
+                    extend_tuple(partial_eff, op_id, c1);
+            }
+            return true;
+        });
+
+    for (int fact : pre)
+        current_pre_values[fact_to_var[fact]] = UNDEFINED;
+    for (int fact : eff)
+        current_eff_values[fact_to_var[fact]] = UNDEFINED;
 }
 
 
-int HMHeuristic::update_hm_entry(const Tuple &t, int val) {
-    assert(hm_table.count(t) == 1);
-    if (hm_table[t] > val) {
-        hm_table[t] = val;
-        was_updated = true;
+void HMHeuristic::extend_tuple(const Tuple &t, int op_id, int c1) {
+    for (int fact : t) {
+        if (current_eff_values[fact_to_var[fact]] == CONFLICT)
+            return;
     }
-    return val;
+    extension.clear();
+    new_extension_facts.clear();
+    extend_tuple_aux(t, op_id, c1, 0);
 }
 
 
-int HMHeuristic::check_tuple_in_tuple(
-    const Tuple &tuple, const Tuple &big_tuple) const {
-    for (const FactPair &fact0 : tuple) {
-        bool found = false;
-        for (auto &fact1 : big_tuple) {
-            if (fact0 == fact1) {
-                found = true;
+/*
+  Extend t by one fact of a variable with ID of at least first_var that
+  does not occur in t. The fact must not contradict an effect of the
+  operator, and adding it to the operator's preconditions must not
+  contradict them either.
+*/
+void HMHeuristic::extend_tuple_aux(
+    const Tuple &t, int op_id, int c1, int first_var) {
+    int num_variables = current_eff_values.size();
+    for (int var = first_var; var < num_variables; ++var) {
+        bool var_in_t = false;
+        for (int fact : t) {
+            if (fact_to_var[fact] == var) {
+                var_in_t = true;
                 break;
             }
         }
-        if (!found) {
-            return numeric_limits<int>::max();
+        int eff_value = current_eff_values[var];
+        int pre_value = current_pre_values[var];
+        if (var_in_t || eff_value == CONFLICT ||
+            (eff_value != UNDEFINED && pre_value != UNDEFINED &&
+             eff_value != pre_value)) {
+            continue;
         }
-    }
-    return 0;
-}
-
-
-HMHeuristic::Tuple HMHeuristic::get_operator_pre(const OperatorProxy &op) const {
-    Tuple preconditions = task_properties::get_fact_pairs(op.get_preconditions());
-    sort(preconditions.begin(), preconditions.end());
-    return preconditions;
-}
-
+        int min_value = 0;
+        int max_value = fact_id_offsets[var + 1] - fact_id_offsets[var] - 1;
+        if (eff_value != UNDEFINED) {
+            min_value = max_value = eff_value;
+        } else if (pre_value != UNDEFINED) {
+            min_value = max_value = pre_value;
+        }
+        for (int value = min_value; value <= max_value; ++value) {
+            int fact = fact_id_offsets[var] + value;
+            bool is_new_precondition = (pre_value == UNDEFINED);
+            extension.push_back(fact);
+            if (is_new_precondition)
+                new_extension_facts.push_back(fact);
+
+            int c2 = new_extension_facts.empty() ? c1 :
+                eval_with_extension(operator_preconditions[op_id], c1);
+            if (c2 != INF) {
+                merged_tuple.clear();
+                merge(t.begin(), t.end(), extension.begin(), extension.end(),
+                      back_inserter(merged_tuple));
+                update_hm_entry(merged_tuple, c2 + operator_costs[op_id]);
+            }
+            if (static_cast<int>(t.size() + extension.size()) < m)
+                extend_tuple_aux(t, op_id, c1, var + 1);
 
-HMHeuristic::Tuple HMHeuristic::get_operator_eff(const OperatorProxy &op) const {
-    Tuple effects;
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(eff.get_fact().get_pair());
+            extension.pop_back();
+            if (is_new_precondition)
+                new_extension_facts.pop_back();
+        }
     }
-    sort(effects.begin(), effects.end());
-    return effects;
 }
 
 
-bool HMHeuristic::contradict_effect_of(
-    const OperatorProxy &op, int var, int val) const {
-    for (EffectProxy eff : op.get_effects()) {
-        FactProxy fact = eff.get_fact();
-        if (fact.get_variable().get_id() == var && fact.get_value() != val) {
+int HMHeuristic::eval(const Tuple &t) {
+    int max = 0;
+    bool finite = for_each_subset(
+        t, m, subset,
+        [&](const Tuple &tuple) {
+            int h = hm_table[get_index(tuple)];
+            if (h == INF)
+                return false;
+            max = std::max(max, h);
             return true;
-        }
-    }
-    return false;
+        });
+    return finite ? max : INF;
 }
 
 
-void HMHeuristic::generate_all_tuples() {
-    Tuple t;
-    generate_all_tuples_aux(0, m, t);
+/*
+  Return the h^m value of the union of pre and new_extension_facts, given
+  that c1 is the value of pre. Only subsets that contain a fact from
+  new_extension_facts need to be looked up.
+*/
+int HMHeuristic::eval_with_extension(const Tuple &pre, int c1) {
+    int max = c1;
+    bool finite = for_each_subset(
+        new_extension_facts, m, extension_subset,
+        [&](const Tuple &ext_tuple) {
+            int h = hm_table[get_index(ext_tuple)];
+            if (h == INF)
+                return false;
+            max = std::max(max, h);
+            return for_each_subset(
+                pre, m - static_cast<int>(ext_tuple.size()), subset,
+                [&](const Tuple &pre_tuple) {
+                    merged_tuple.clear();
+                    merge(pre_tuple.begin(), pre_tuple.end(),
+                          ext_tuple.begin(), ext_tuple.end(),
+                          back_inserter(merged_tuple));
+                    int merged_h = hm_table[get_index(merged_tuple)];
+                    if (merged_h == INF)
+                        return false;
+                    max = std::max(max, merged_h);
+                    return true;
+                });
+        });
+    return finite ? max : INF;
 }
 
 
-void HMHeuristic::generate_all_tuples_aux(int var, int sz, const Tuple &base) {
-    int num_variables = task_proxy.get_variables().size();
-    for (int i = var; i < num_variables; ++i) {
-        int domain_size = task_proxy.get_variables()[i].get_domain_size();
-        for (int j = 0; j < domain_size; ++j) {
-            Tuple tuple(base);
-            tuple.emplace_back(i, j);
-            hm_table[tuple] = 0;
-            if (sz > 1) {
-                generate_all_tuples_aux(i + 1, sz - 1, tuple);
+void HMHeuristic::update_hm_entry(const Tuple &t, int val) {
+    assert(has_distinct_variables(t));
+    int &entry = hm_table[get_index(t)];
+    if (entry > val) {
+        entry = val;
+        if (static_cast<int>(t.size()) < m) {
+            small_tuple_changed = true;
+        } else {
+            for (int fact : t) {
+                if (fact_change_marks[fact] != sweep_id) {
+                    fact_change_marks[fact] = sweep_id;
+                    changed_facts.push_back(fact);
+                }
             }
         }
     }
 }
 
 
-void HMHeuristic::generate_all_partial_tuples(
-    const Tuple &base_tuple, vector<Tuple> &res) const {
-    Tuple t;
-    generate_all_partial_tuples_aux(base_tuple, t, 0, m, res);
-}
-
-
-void HMHeuristic::generate_all_partial_tuples_aux(
-    const Tuple &base_tuple, const Tuple &t, int index, int sz, vector<Tuple> &res) const {
-    if (sz == 1) {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-        }
-    } else {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-            generate_all_partial_tuples_aux(base_tuple, tuple, i + 1, sz - 1, res);
-        }
-    }
-}
-
-
-void HMHeuristic::dump_table() const {
-    for (auto &hm_ent : hm_table) {
-        utils::g_log << "h(" << hm_ent.first << ") = " << hm_ent.second << endl;
-    }
-}
-
-
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis("h^m heuristic", "");
     parser.document_language_support("action costs", "supported");
@@ -3,10 +3,7 @@
 
 #include "../heuristic.h"
 
-#include <algorithm>
-#include <iostream>
-#include <map>
-#include <string>
+#include <cstddef>
 #include <vector>
 
 namespace options {
@@ -17,45 +14,77 @@ namespace hm_heuristic {
 /*
   Haslum's h^m heuristic family ("critical path heuristics").
 
-  This is a very slow implementation and should not be used for
-  speed benchmarks.
+  Facts are numbered consecutively and a tuple is a sorted vector of fact
+  IDs with pairwise different variables. The h^m table is a flat array
+  with one entry for each set of at most m facts: the k-element set
+  {f_1 < ... < f_k} is stored at position size_offsets[k] + sum_i C(f_i, i)
+  (the combinatorial number system), so looking up a tuple needs neither
+  hashing nor allocation.
+
+  The table is computed by sweeps over the operators until a fixpoint is
+  reached. After the first sweep, an operator is only considered again
+  if an entry that it reads has changed in the previous sweep.
 */
 
 class HMHeuristic : public Heuristic {
-    using Tuple = std::vector<FactPair>;
+    using Tuple = std::vector<int>;
     // parameters
     const int m;
     const bool has_cond_effects;
 
-    const Tuple goals;
+    std::vector<int> fact_id_offsets;
+    std::vector<int> fact_to_var;
+    Tuple goals;
+    std::vector<Tuple> operator_preconditions;
+    std::vector<Tuple> operator_effects;
+    std::vector<int> operator_costs;
+    std::vector<std::vector<int>> operators_by_precondition_fact;
 
-    // h^m table
-    std::map<Tuple, int> hm_table;
-    bool was_updated;
+    // binomials[k][n] = C(n, k) for 1 <= k <= m and 0 <= n < number of facts.
+    std::vector<std::vector<std::size_t>> binomials;
+    // Position of the first table entry for tuples of size k.
+    std::vector<std::size_t> size_offsets;
 
-    // auxiliary methods
-    void init_hm_table(const Tuple &t);
+    // h^m table
+    std::vector<int> hm_table;
+
+    /*
+      Change tracking for the current sweep: whether an entry for a tuple
+      with less than m facts changed, and the facts of all changed m-tuples.
+    */
+    bool small_tuple_changed;
+    std::vector<int> changed_facts;
+    std::vector<int> fact_change_marks;
+    std::vector<int> operator_marks;
+    int sweep_id;
+
+    /*
+      Precondition and effect values of the operator that is currently
+      applied, indexed by variable. UNDEFINED if the operator has no
+      precondition or effect on the variable, CONFLICT if it has effects
+      with different values on the variable.
+    */
+    std::vector<int> current_pre_values;
+    std::vector<int> current_eff_values;
+
+    // Scratch space to avoid allocations in the fixpoint computation.
+    Tuple subset;
+    Tuple effect_subset;
+    Tuple extension_subset;
+    Tuple extension;
+    Tuple new_extension_facts;
+    Tuple merged_tuple;
+
+    std::size_t get_index(const Tuple &tuple) const;
+    bool has_distinct_variables(const Tuple &tuple) const;
+    void init_hm_table(const Tuple &state_facts);
     void update_hm_table();
-    int eval(const Tuple &t) const;
-    int update_hm_entry(const Tuple &t, int val);
-    void extend_tuple(const Tuple &t, const OperatorProxy &op);
-
-    int check_tuple_in_tuple(const Tuple &tuple, const Tuple &big_tuple) const;
-
-    int get_operator_pre_value(const OperatorProxy &op, int var) const;
-    Tuple get_operator_pre(const OperatorProxy &op) const;
-    Tuple get_operator_eff(const OperatorProxy &op) const;
-    bool contradict_effect_of(const OperatorProxy &op, int var, int val) const;
-
-    void generate_all_tuples();
-    void generate_all_tuples_aux(int var, int sz, const Tuple &base);
-
-    void generate_all_partial_tuples(const Tuple &base_tuple,
-                                     std::vector<Tuple> &res) const;
-    void generate_all_partial_tuples_aux(const Tuple &base_tuple, const Tuple &t, int index,
-                                         int sz, std::vector<Tuple> &res) const;
-
-    void dump_table() const;
+    void apply_operator(int op_id);
+    int eval(const Tuple &t);
+    int eval_with_extension(const Tuple &pre, int c1);
+    void update_hm_entry(const Tuple &t, int val);
+    void extend_tuple(const Tuple &t, int op_id, int c1);
+    void extend_tuple_aux(const Tuple &t, int op_id, int c1, int first_var);
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
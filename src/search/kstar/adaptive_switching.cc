@@ -0,0 +1,35 @@
+#include "adaptive_switching.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace kstar {
+int AdaptiveSwitching::get_astar_phase_length(
+    int missing_plans, int fallback_length) const {
+    if (num_astar_expansions == 0 || last_astar_phase_length == 0)
+        return fallback_length;
+    double time_per_expansion = max(astar_time / num_astar_expansions, 1e-9);
+    double max_length = 2.0 * last_astar_phase_length;
+    double length = max_length;
+    if (last_yield > 0)
+        length = min(length, missing_plans / last_yield);
+    length = max(length, last_switch_time / time_per_expansion);
+    length = min(length, max_length);
+    length = min(length, static_cast<double>(numeric_limits<int>::max()));
+    return max(1, static_cast<int>(length));
+}
+
+void AdaptiveSwitching::report_astar_phase(int num_expansions, double time) {
+    num_astar_expansions += num_expansions;
+    astar_time += time;
+    last_astar_phase_length = num_expansions;
+}
+
+void AdaptiveSwitching::report_eppstein_phase(int num_new_plans, double switch_time) {
+    last_switch_time = switch_time;
+    if (last_astar_phase_length > 0)
+        last_yield = static_cast<double>(max(num_new_plans, 0)) / last_astar_phase_length;
+}
+}
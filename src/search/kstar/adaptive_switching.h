@@ -0,0 +1,43 @@
+#ifndef KSTAR_ADAPTIVE_SWITCHING_H
+#define KSTAR_ADAPTIVE_SWITCHING_H
+
+namespace kstar {
+enum class SwitchingPolicy {
+    // Switch after a fixed percentage of the expanded states.
+    FIXED,
+    // Choose the length of the A* phases from the measured throughput.
+    ADAPTIVE
+};
+
+/*
+  Chooses the number of A* expansions before K* switches to Eppstein's
+  algorithm again, based on the time per A* expansion, the time of the
+  last switch (rebuilding and restarting Eppstein's algorithm) and the
+  number of plans that the last Eppstein phase found per A* expansion of
+  the preceding A* phase.
+
+  A phase expands as many states as are predicted to yield the missing
+  plans, but at least as many states as fit into the time of the last
+  switch, so at most half of the time is spent switching. In any case, it
+  expands at most twice as many states as the previous phase, so the
+  number of switches grows logarithmically with the number of expansions.
+*/
+class AdaptiveSwitching {
+    int num_astar_expansions = 0;
+    double astar_time = 0;
+    int last_astar_phase_length = 0;
+    double last_switch_time = 0;
+    // Plans found per expansion of the previous A* phase; negative if unknown.
+    double last_yield = -1;
+
+public:
+    // Number of A* expansions for the next phase; fallback_length if nothing has been measured yet.
+    int get_astar_phase_length(int missing_plans, int fallback_length) const;
+
+    void report_astar_phase(int num_expansions, double time);
+    // Time of switching to Eppstein's algorithm (rebuilding and initialization).
+    void report_eppstein_phase(int num_new_plans, double switch_time);
+};
+}
+
+#endif
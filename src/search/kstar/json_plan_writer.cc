@@ -0,0 +1,86 @@
+#include "json_plan_writer.h"
+
+#include <cstdio>
+
+using namespace std;
+
+namespace kstar {
+static const size_t BUFFER_FLUSH_SIZE = 1 << 16;
+
+void append_escaped(const string &text, string &result) {
+    result += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[7];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                result += escaped;
+            } else {
+                result += c;
+            }
+        }
+    }
+    result += '"';
+}
+
+JsonPlanWriter::JsonPlanWriter(
+    ostream &os, const TaskProxy &task_proxy, Format format)
+    : os(os),
+      task_proxy(task_proxy),
+      format(format),
+      escaped_operator_names(task_proxy.get_operators().size()) {
+    buffer.reserve(BUFFER_FLUSH_SIZE);
+}
+
+JsonPlanWriter::~JsonPlanWriter() {
+    flush();
+}
+
+const string &JsonPlanWriter::get_escaped_operator_name(OperatorID op_id) {
+    string &escaped_name = escaped_operator_names[op_id.get_index()];
+    if (escaped_name.empty()) {
+        append_escaped(
+            task_proxy.get_operators()[op_id].get_name(), escaped_name);
+    }
+    return escaped_name;
+}
+
+void JsonPlanWriter::write_plan(
+    Plan::const_iterator begin, Plan::const_iterator end, int cost) {
+    bool multi_line = (format == Format::MULTI_LINE);
+    buffer += multi_line ? "{ \"cost\" : " : "{\"cost\": ";
+    buffer += to_string(cost);
+    buffer += multi_line ? ",\n\"actions\" : [\n" : ", \"actions\": [";
+    for (auto it = begin; it != end; ++it) {
+        if (it != begin)
+            buffer += ", ";
+        buffer += get_escaped_operator_name(*it);
+    }
+    buffer += "]}\n";
+    if (buffer.size() >= BUFFER_FLUSH_SIZE)
+        flush();
+}
+
+void JsonPlanWriter::write(const string &text) {
+    buffer += text;
+}
+
+void JsonPlanWriter::flush() {
+    os.write(buffer.data(), buffer.size());
+    os.flush();
+    buffer.clear();
+}
+}
@@ -0,0 +1,54 @@
+#ifndef KSTAR_JSON_PLAN_WRITER_H
+#define KSTAR_JSON_PLAN_WRITER_H
+
+#include "../plan_manager.h"
+#include "../task_proxy.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace kstar {
+// Append text to result as a quoted and escaped JSON string.
+extern void append_escaped(const std::string &text, std::string &result);
+
+/*
+  Writes plans as JSON objects of the form
+  { "cost" : 5, "actions" : ["op1", "op2"] }.
+
+  The output is collected in a buffer that is written to the stream when
+  it gets large or when flush() is called, so writing many plans does
+  not cause a system call per line. Operator names are escaped once,
+  when they first occur in a plan.
+*/
+class JsonPlanWriter {
+public:
+    enum class Format {
+        // Pretty-printed as in the "plans" list of the JSON plan file.
+        MULTI_LINE,
+        // One plan per line (NDJSON).
+        SINGLE_LINE
+    };
+
+private:
+    std::ostream &os;
+    TaskProxy task_proxy;
+    Format format;
+    std::string buffer;
+    // Empty for operators whose names have not been escaped yet.
+    std::vector<std::string> escaped_operator_names;
+
+    const std::string &get_escaped_operator_name(OperatorID op_id);
+public:
+    JsonPlanWriter(std::ostream &os, const TaskProxy &task_proxy, Format format);
+    ~JsonPlanWriter();
+
+    // Write the plan consisting of the operators in [begin, end).
+    void write_plan(
+        Plan::const_iterator begin, Plan::const_iterator end, int cost);
+    void write(const std::string &text);
+    void flush();
+};
+}
+
+#endif
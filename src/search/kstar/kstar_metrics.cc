@@ -0,0 +1,158 @@
+#include "kstar_metrics.h"
+
+#include "json_plan_writer.h"
+
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/profiling.h"
+#include "../utils/system.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+namespace kstar {
+static void write_profile(ostringstream &fields) {
+    vector<const utils::ProfilingComponent *> components = utils::get_profiling_components();
+    if (components.empty())
+        return;
+    fields << ", \"profile\": {";
+    for (size_t i = 0; i < components.size(); ++i) {
+        const utils::ProfilingComponent &component = *components[i];
+        if (i > 0)
+            fields << ", ";
+        string name;
+        append_escaped(component.get_name(), name);
+        fields << name << ": {"
+               << "\"count\": " << component.get_count()
+               << ", \"total\": " << component.get_total_time()
+               << ", \"p50\": " << component.get_percentile(0.5)
+               << ", \"p99\": " << component.get_percentile(0.99) << "}";
+    }
+    fields << "}";
+}
+
+KStarMetrics::KStarMetrics(const string &filename)
+    : rebuild_timer(false),
+      decoding_timer(false),
+      dedup_timer(false),
+      output_timer(false) {
+    if (!filename.empty()) {
+        file = utils::make_unique_ptr<ofstream>(filename);
+        if (!*file) {
+            cerr << "Failed to open metrics file: " << filename << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        utils::g_log << "Writing K* metrics to " << filename << endl;
+    }
+}
+
+void KStarMetrics::write_record(const ostringstream &fields) const {
+    *file << "{" << fields.str() << "}\n";
+}
+
+void KStarMetrics::report_iteration(
+    int iteration, int expanded, double astar_time, double eppstein_time,
+    bool reopen_occurred, int num_plans, int eppstein_queue_size) {
+    if (is_enabled()) {
+        double rebuild_time = rebuild_timer();
+        double decoding_time = decoding_timer();
+        double dedup_time = dedup_timer();
+        double output_time = output_timer();
+        ostringstream fields;
+        fields << "\"event\": \"iteration\""
+               << ", \"iteration\": " << iteration
+               << ", \"time\": " << static_cast<double>(utils::g_timer())
+               << ", \"expanded\": " << expanded - previous_expanded
+               << ", \"eppstein_pops\": " << eppstein_pops - previous_eppstein_pops
+               << ", \"path_graph_nodes\": " << path_graph_nodes - previous_path_graph_nodes
+               << ", \"plans_accepted\": " << plans_accepted - previous_plans_accepted
+               << ", \"plans_rejected\": " << plans_rejected - previous_plans_rejected
+               << ", \"plans\": " << num_plans
+               << ", \"reopen_occurred\": " << (reopen_occurred ? "true" : "false")
+               << ", \"astar_time\": " << astar_time - previous_astar_time
+               << ", \"eppstein_time\": " << eppstein_time - previous_eppstein_time
+               << ", \"rebuild_time\": " << rebuild_time - previous_rebuild_time
+               << ", \"decoding_time\": " << decoding_time - previous_decoding_time
+               << ", \"dedup_time\": " << dedup_time - previous_dedup_time
+               << ", \"output_time\": " << output_time - previous_output_time
+               << ", \"eppstein_queue_size\": " << eppstein_queue_size
+               << ", \"hin_lists_bytes\": " << hin_lists_memory
+               << ", \"htree_lists_bytes\": " << htree_lists_memory
+               << ", \"path_graph_bytes\": " << path_graph_memory;
+        write_record(fields);
+        // Iterations are rare, so we can afford to flush.
+        file->flush();
+
+        previous_rebuild_time = rebuild_time;
+        previous_decoding_time = decoding_time;
+        previous_dedup_time = dedup_time;
+        previous_output_time = output_time;
+    }
+    previous_expanded = expanded;
+    previous_eppstein_pops = eppstein_pops;
+    previous_path_graph_nodes = path_graph_nodes;
+    previous_plans_accepted = plans_accepted;
+    previous_plans_rejected = plans_rejected;
+    previous_astar_time = astar_time;
+    previous_eppstein_time = eppstein_time;
+}
+
+void KStarMetrics::report_plans(int num_plans, int cost) {
+    if (num_plans <= num_reported_plans)
+        return;
+    if (is_enabled()) {
+        double time = static_cast<double>(utils::g_timer());
+        for (int i = num_reported_plans + 1; i <= num_plans; ++i) {
+            ostringstream fields;
+            fields << "\"event\": \"plan\""
+                   << ", \"plan\": " << i
+                   << ", \"time\": " << time
+                   << ", \"cost\": " << cost;
+            write_record(fields);
+        }
+    }
+    num_reported_plans = num_plans;
+}
+
+void KStarMetrics::report_summary(
+    int iterations, int expanded, double astar_time, double eppstein_time,
+    int num_plans) const {
+    if (!is_enabled())
+        return;
+    ostringstream fields;
+    fields << "\"event\": \"summary\""
+           << ", \"time\": " << static_cast<double>(utils::g_timer())
+           << ", \"iterations\": " << iterations
+           << ", \"expanded\": " << expanded
+           << ", \"eppstein_pops\": " << eppstein_pops
+           << ", \"path_graph_nodes\": " << path_graph_nodes
+           << ", \"plans_accepted\": " << plans_accepted
+           << ", \"plans_rejected\": " << plans_rejected
+           << ", \"plans\": " << num_plans
+           << ", \"rebuilds\": " << num_rebuilds
+           << ", \"astar_time\": " << astar_time
+           << ", \"eppstein_time\": " << eppstein_time
+           << ", \"rebuild_time\": " << static_cast<double>(rebuild_timer())
+           << ", \"decoding_time\": " << static_cast<double>(decoding_timer())
+           << ", \"dedup_time\": " << static_cast<double>(dedup_timer())
+           << ", \"output_time\": " << static_cast<double>(output_timer())
+           << ", \"peak_memory_kb\": " << utils::get_peak_memory_in_kb();
+    write_profile(fields);
+    write_record(fields);
+    file->flush();
+}
+
+void KStarMetrics::print_statistics() const {
+    utils::g_log << "K* Eppstein pops: " << eppstein_pops << endl;
+    utils::g_log << "K* path graph nodes: " << path_graph_nodes << endl;
+    utils::g_log << "K* plans accepted: " << plans_accepted << endl;
+    utils::g_log << "K* plans rejected: " << plans_rejected << endl;
+    utils::g_log << "K* Eppstein rebuilds: " << num_rebuilds << endl;
+    utils::g_log << "K* rebuild time: " << rebuild_timer << endl;
+    utils::g_log << "K* plan decoding time: " << decoding_timer << endl;
+    utils::g_log << "K* duplicate plan check time: " << dedup_timer << endl;
+    utils::g_log << "K* plan output time: " << output_timer << endl;
+}
+}
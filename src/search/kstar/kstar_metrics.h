@@ -0,0 +1,88 @@
+#ifndef KSTAR_KSTAR_METRICS_H
+#define KSTAR_KSTAR_METRICS_H
+
+#include "../utils/timer.h"
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace kstar {
+/*
+  Counters and timers for the phases of K* that are not covered by the
+  search statistics. If a metrics file is given, the values are written to
+  it as JSON lines, so runs can be profiled without parsing the log:
+
+    {"event": "iteration", ...}  after each outer iteration (A* steps
+                                 followed by Eppstein steps) with the
+                                 values of this iteration
+    {"event": "plan", ...}       when i plans have been found for the
+                                 first time (restarts of Eppstein's
+                                 algorithm find the same plans again)
+    {"event": "summary", ...}    at the end of the search, including the
+                                 latency histograms of the profiling
+                                 scopes if built with USE_PROFILING
+
+  Times are in seconds. The field "time" is the time since the planner
+  started.
+*/
+class KStarMetrics {
+    std::unique_ptr<std::ofstream> file;
+
+    // Values at the end of the previous iteration.
+    int previous_expanded = 0;
+    int previous_eppstein_pops = 0;
+    int previous_path_graph_nodes = 0;
+    int previous_plans_accepted = 0;
+    int previous_plans_rejected = 0;
+    double previous_astar_time = 0;
+    double previous_eppstein_time = 0;
+    double previous_rebuild_time = 0;
+    double previous_decoding_time = 0;
+    double previous_dedup_time = 0;
+    double previous_output_time = 0;
+
+    int num_reported_plans = 0;
+
+    void write_record(const std::ostringstream &fields) const;
+public:
+    int eppstein_pops = 0;
+    // Path graph nodes pushed to the Eppstein queue.
+    int path_graph_nodes = 0;
+    int plans_accepted = 0;
+    // Plans that the plan selector rejected as duplicates.
+    int plans_rejected = 0;
+    int num_rebuilds = 0;
+
+    utils::Timer rebuild_timer;
+    utils::Timer decoding_timer;
+    utils::Timer dedup_timer;
+    utils::Timer output_timer;
+
+    // Memory estimates in bytes, set before each iteration is reported.
+    std::size_t hin_lists_memory = 0;
+    std::size_t htree_lists_memory = 0;
+    std::size_t path_graph_memory = 0;
+
+    // Write no metrics file if filename is empty.
+    explicit KStarMetrics(const std::string &filename);
+
+    bool is_enabled() const {
+        return file != nullptr;
+    }
+
+    void report_iteration(
+        int iteration, int expanded, double astar_time, double eppstein_time,
+        bool reopen_occurred, int num_plans, int eppstein_queue_size);
+    // Report plans num_reported_plans + 1, ..., num_plans with the given cost.
+    void report_plans(int num_plans, int cost);
+    void report_summary(
+        int iterations, int expanded, double astar_time, double eppstein_time,
+        int num_plans) const;
+    void print_statistics() const;
+};
+}
+
+#endif
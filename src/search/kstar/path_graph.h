@@ -43,25 +43,24 @@ public:
 
     void insert_ste_to_set(const SideTrackEdge& ste) 
     {
-        assert(ste.state_registry != nullptr);        
         this->ste_set.insert(ste);
     } 
 
-    void create_list_from_set(StateID pa_in_tree, OperatorID op_in_tree) 
+    void create_list_from_set(StateID pa_in_tree, OperatorID op_in_tree, SideTrackEdgeTable& ste_table) 
     {
         this->clear_list();
         assert (this->node_closed);
         for (const auto& ste: this->ste_set)
         {
             if (ste.get_from() != pa_in_tree || ste.get_op() != op_in_tree)
-                this->ste_handle_list.push_back(SideTrackEdgeHandle::create(ste));
+                this->ste_handle_list.push_back(ste_table.add(ste));
         }
         this->ste_handle_list.sort();
     }
 
-    void push_back_ste_handle_to_sorted_list(const SideTrackEdge& ste)
+    void push_back_ste_handle_to_sorted_list(const SideTrackEdge& ste, SideTrackEdgeTable& ste_table)
     {
-        SideTrackEdgeHandle ste_handle = SideTrackEdgeHandle::create(ste);
+        SideTrackEdgeHandle ste_handle = ste_table.add(ste);
         this->insert_ste_handle_to_sorted_list(ste_handle);
     }
 
@@ -107,6 +106,17 @@ public:
         return this->ste_handle_list.size();
     }
 
+    // Rough estimate of the memory used by the list and the set in bytes.
+    // The edges the handles point to are stored in the SideTrackEdgeTable.
+    std::size_t estimate_memory_usage() const {
+        const std::size_t list_node_size = sizeof(SideTrackEdgeHandle) + 2 * sizeof(void *);
+        const std::size_t set_node_size = sizeof(SideTrackEdge) + 2 * sizeof(void *);
+        return sizeof(HinList) +
+               ste_handle_list.size() * list_node_size +
+               ste_set.size() * set_node_size +
+               ste_set.bucket_count() * sizeof(void *);
+    }
+
     std::list<SideTrackEdgeHandle>::iterator get_first_it() 
     {
         return this->ste_handle_list.begin();
@@ -197,6 +207,13 @@ public:
         return this->hinroot_handles.size();
     }
 
+    // Rough estimate of the memory used by the list in bytes. The edges
+    // are stored in the SideTrackEdgeTable.
+    std::size_t estimate_memory_usage() const {
+        const std::size_t list_node_size = sizeof(SideTrackEdgeHandle) + 2 * sizeof(void *);
+        return sizeof(HtreeList) + hinroot_handles.size() * list_node_size;
+    }
+
     std::list<SideTrackEdgeHandle>::iterator get_first_it()
     {
         return hinroot_handles.begin();
@@ -230,88 +247,42 @@ public:
 
 struct PathGraphNode 
 {
-    StateID sid_htree = StateID::no_state;
     std::list<SideTrackEdgeHandle>::iterator it_htreelist{};
     std::list<SideTrackEdgeHandle>::iterator it_hinlist{};
     PathGraphNode* parent_node;
-    bool by_crossing_arc;
-    StateRegistry* state_registry;
-
-    int ste_delta = -1;
-    int edge_value = -1;
+    StateID sid_htree = StateID::no_state;
     int path_value = -1;
-    double creation_time = 0.0;
+    bool by_crossing_arc;
 
     PathGraphNode(StateID sid_htree, 
                   std::list<SideTrackEdgeHandle>::iterator it_htreelist,
                   std::list<SideTrackEdgeHandle>::iterator it_hinlist,
                   PathGraphNode* parent_node, 
-                  bool by_crossing_arc,
-                  StateRegistry* state_registry
+                  bool by_crossing_arc
     ) : 
-        sid_htree(sid_htree), 
         it_htreelist(it_htreelist),
         it_hinlist(it_hinlist),
         parent_node(parent_node),
-        by_crossing_arc(by_crossing_arc),
-        state_registry(state_registry)
+        sid_htree(sid_htree), 
+        by_crossing_arc(by_crossing_arc)
     { 
         this->compute_node_value();
     }
 
-    PathGraphNode(const PathGraphNode& other):
-        sid_htree(other.sid_htree), 
-        it_htreelist(other.it_htreelist), 
-        it_hinlist(other.it_hinlist),
-        parent_node(other.parent_node),
-        by_crossing_arc(other.by_crossing_arc),
-        state_registry(other.state_registry)
-    { 
-        ste_delta = other.ste_delta;
-        edge_value = other.edge_value;
-        path_value = other.path_value;
-        creation_time = other.creation_time;
-    }
-
-    ~PathGraphNode() = default;
-
-    bool operator<(const PathGraphNode& other) const {
-        // flip operator order and make max to min heap
-        if (this->path_value == other.path_value)
-            return this->creation_time > other.creation_time;
-        else
-            return this->path_value > other.path_value;
-    }
-
-    bool operator==(const PathGraphNode& other) const 
-    {
-        return (this->sid_htree == other.sid_htree) && \
-        (this->it_htreelist == other.it_htreelist) && \
-        (this->it_hinlist == other.it_hinlist) && \
-        (this->parent_node == other.parent_node) && \
-        (this->ste_delta == other.ste_delta) && \
-        (this->by_crossing_arc == other.by_crossing_arc) && \
-        (this->edge_value == other.edge_value) && \
-        (this->path_value == other.path_value);
-    }
-
-    bool operator!=(const PathGraphNode& other) const {
-        return (*this == other);
+    // The delta is stored once in the side-track edge.
+    int get_ste_delta() const {
+        return (*it_hinlist).ste_ptr->get_delta();
     }
 
-    std::size_t hash() const {
-        assert(this->state_registry);
-        return utils::get_hash(*this);        
+    int get_edge_value() const {
+        int edge_value = this->get_ste_delta();
+        if (!this->by_crossing_arc && this->parent_node != nullptr)
+            edge_value -= this->parent_node->get_ste_delta();
+        return edge_value;
     }
 
     void compute_node_value() {
-        this-> ste_delta = (*it_hinlist).ste_ptr->get_delta();
-
-        this->edge_value = this->ste_delta;
-        if (!this->by_crossing_arc && this->parent_node != nullptr)
-            this->edge_value -= this->parent_node->ste_delta;
-        
-        this->path_value = this->edge_value;
+        this->path_value = this->get_edge_value();
         if (this->parent_node != nullptr)
             this->path_value += this->parent_node->path_value;
     }
@@ -322,8 +293,8 @@ inline std::ostream &operator<<(std::ostream &os, PathGraphNode& pn) {
     os << "pn [htree sid=" << pn.sid_htree
        << " ste=" << *(*pn.it_hinlist).ste_ptr
        << " crossing=" <<  pn.by_crossing_arc
-       << " delta=" <<  pn.ste_delta
-       << " edge="  <<  pn.edge_value
+       << " delta=" <<  pn.get_ste_delta()
+       << " edge="  <<  pn.get_edge_value()
        << " path="  <<  pn.path_value;
     
     if (pn.parent_node != nullptr) 
@@ -332,27 +303,6 @@ inline std::ostream &operator<<(std::ostream &os, PathGraphNode& pn) {
         os << " pa=[nullptr]]";
     return os;
 }
-
-
-struct PathGraphNodeHasher {
-    std::size_t operator() (const PathGraphNode& node) const {
-        return node.hash();
-    }
-};
-}
-
-
-namespace utils {
-
-inline void feed(HashState &hash_state, const kstar::PathGraphNode &node) 
-{
-    feed(hash_state, *node.it_htreelist);
-    feed(hash_state, *node.it_hinlist);
-    feed(hash_state, node.by_crossing_arc);
-    feed(hash_state, node.ste_delta);   
-    feed(hash_state, node.edge_value);   
-    feed(hash_state, node.path_value);   
 }
 
-}
 #endif
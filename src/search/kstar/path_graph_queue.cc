@@ -0,0 +1,91 @@
+#include "path_graph_queue.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace kstar {
+static const int MAX_BUCKET_KEY = 1 << 16;
+
+PathGraphQueue::PathGraphQueue()
+    : min_key(0),
+      num_bucket_entries(0),
+      num_entries(0) {
+}
+
+void PathGraphQueue::push(const PathGraphNode &node) {
+    int key = node.path_value;
+    assert(key >= 0);
+    int id = nodes.size();
+    nodes.push_back(node);
+    ++num_entries;
+    if (key >= MAX_BUCKET_KEY) {
+        overflow_buckets[key].push_back(id);
+        return;
+    }
+    if (key >= static_cast<int>(buckets.size()))
+        buckets.resize(key + 1);
+    buckets[key].node_ids.push_back(id);
+    ++num_bucket_entries;
+    if (key < min_key)
+        min_key = key;
+}
+
+int PathGraphQueue::get_min_id() {
+    assert(!empty());
+    if (num_bucket_entries == 0)
+        return overflow_buckets.begin()->second.front();
+    while (buckets[min_key].empty())
+        ++min_key;
+    Bucket &bucket = buckets[min_key];
+    return bucket.node_ids[bucket.next];
+}
+
+PathGraphNode *PathGraphQueue::top() {
+    return &nodes[get_min_id()];
+}
+
+void PathGraphQueue::pop() {
+    assert(!empty());
+    --num_entries;
+    if (num_bucket_entries == 0) {
+        auto it = overflow_buckets.begin();
+        it->second.pop_front();
+        if (it->second.empty())
+            overflow_buckets.erase(it);
+        return;
+    }
+    get_min_id();
+    Bucket &bucket = buckets[min_key];
+    ++bucket.next;
+    --num_bucket_entries;
+    if (bucket.empty()) {
+        bucket.node_ids.clear();
+        bucket.next = 0;
+    }
+}
+
+void PathGraphQueue::clear() {
+    deque<PathGraphNode>().swap(nodes);
+    release_entries();
+}
+
+void PathGraphQueue::release_entries() {
+    vector<Bucket>().swap(buckets);
+    overflow_buckets.clear();
+    min_key = 0;
+    num_bucket_entries = 0;
+    num_entries = 0;
+}
+
+size_t PathGraphQueue::estimate_memory_usage() const {
+    size_t bucket_memory = buckets.capacity() * sizeof(Bucket);
+    for (const Bucket &bucket : buckets)
+        bucket_memory += bucket.node_ids.capacity() * sizeof(int);
+    size_t overflow_memory = 0;
+    for (const auto &entry : overflow_buckets)
+        overflow_memory += entry.second.size() * sizeof(int) + 4 * sizeof(void *);
+    return sizeof(PathGraphQueue) + nodes.size() * sizeof(PathGraphNode) +
+           bucket_memory + overflow_memory;
+}
+}
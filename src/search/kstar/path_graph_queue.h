@@ -0,0 +1,85 @@
+#ifndef KSTAR_PATH_GRAPH_QUEUE_H
+#define KSTAR_PATH_GRAPH_QUEUE_H
+
+#include "path_graph.h"
+
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace kstar {
+/*
+  Priority queue of path graph nodes ordered by path value with FIFO
+  tie-breaking, so nodes with equal path values are popped in the order
+  in which they were generated.
+
+  Path values are sums of non-negative deltas, and children have at least
+  the path value of their parent, so the queue is a monotone bucket queue
+  indexed by the path value. Pushing and popping takes constant amortized
+  time. Path values of at least MAX_BUCKET_KEY are stored in a map to
+  bound the number of buckets.
+
+  The queue owns the nodes, and the buckets hold their indices. Popped
+  nodes keep their addresses until the queue is cleared, because they
+  are the parents of the nodes generated from them.
+*/
+class PathGraphQueue {
+    /*
+      FIFO queue that keeps its memory when it runs empty, so refilling
+      a bucket does not allocate.
+    */
+    struct Bucket {
+        std::vector<int> node_ids;
+        std::size_t next;
+
+        Bucket() : next(0) {
+        }
+
+        bool empty() const {
+            return next == node_ids.size();
+        }
+    };
+
+    // A deque does not move its elements when it grows.
+    std::deque<PathGraphNode> nodes;
+    std::vector<Bucket> buckets;
+    // All buckets below min_key are empty.
+    int min_key;
+    int num_bucket_entries;
+    // Entries with path values of at least MAX_BUCKET_KEY.
+    std::map<int, std::deque<int>> overflow_buckets;
+    int num_entries;
+
+    int get_min_id();
+public:
+    PathGraphQueue();
+
+    void push(const PathGraphNode &node);
+    // The node with the lowest path value that was generated first.
+    PathGraphNode *top();
+    void pop();
+
+    bool empty() const {
+        return num_entries == 0;
+    }
+
+    // Number of nodes in the queue, not counting popped nodes.
+    std::size_t size() const {
+        return num_entries;
+    }
+
+    // Removes all nodes.
+    void clear();
+    /*
+      Removes all entries from the queue but keeps the nodes, which may
+      still be referenced as parents by the nodes of found plans.
+    */
+    void release_entries();
+
+    // Rough estimate of the memory used by the queue and the nodes in bytes.
+    std::size_t estimate_memory_usage() const;
+};
+}
+
+#endif
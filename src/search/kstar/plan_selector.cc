@@ -1,7 +1,11 @@
 #include "plan_selector.h"
 #include "../option_parser.h"
 
+#include "../utils/language.h"
 #include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <cassert>
 #include <string>
 #include <fstream>
 #include <iostream>
@@ -16,14 +20,29 @@ PlanSelector::PlanSelector(const Options &opts, const TaskProxy &task_proxy) :
             dump_plans(opts.get<bool>("dump_plans", true)),
             dump_plan_files(opts.get<bool>("dump_plan_files", true)),
             dump_json(opts.contains("json_file_to_dump")),
+            dump_ndjson(opts.contains("ndjson_file_to_dump")),
             use_regex(opts.contains("preserve_orders_actions_regex")),
-            decoded_plans(utils::make_unique_ptr<std::vector<Plan>>())
+            decoded_plans(utils::make_unique_ptr<std::vector<Plan>>()),
+            next_plan_to_stream(0),
+            num_cheaper_streamed_plans(0),
+            last_streamed_cost(-1)
             {
     utils::g_log << "Dumping plans to disk: " << (dump_plans ? "1" : "0") << std::endl;
     if (dump_json) {
         json_filename = opts.get<std::string>("json_file_to_dump");
         utils::g_log << "Dumping plans to a single json file " << json_filename << std::endl;
     }
+    if (dump_ndjson) {
+        std::string ndjson_filename = opts.get<std::string>("ndjson_file_to_dump");
+        ndjson_file = utils::make_unique_ptr<std::ofstream>(ndjson_filename);
+        if (!*ndjson_file) {
+            std::cerr << "Failed to open NDJSON plan file: " << ndjson_filename << std::endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        ndjson_writer = utils::make_unique_ptr<JsonPlanWriter>(
+            *ndjson_file, task_proxy, JsonPlanWriter::Format::SINGLE_LINE);
+        utils::g_log << "Streaming plans to the NDJSON file " << ndjson_filename << std::endl;
+    }
     if (use_regex) {
         std::string action_name_regex_expression = opts.get<std::string>("preserve_orders_actions_regex");
         set_regex(action_name_regex_expression);
@@ -31,10 +50,16 @@ PlanSelector::PlanSelector(const Options &opts, const TaskProxy &task_proxy) :
     }
 }
 
-int PlanSelector::add_plan_if_necessary(const Plan& plan) {
+void PlanSelector::check_plan_cost(const Plan &plan, int cost) const {
+    assert(cost == calculate_plan_cost(plan, task_proxy));
+    utils::unused_variable(plan);
+    utils::unused_variable(cost);
+}
+
+int PlanSelector::add_plan_if_necessary(const Plan& plan, int cost) {
     PlanCanonical canonical(plan, keep_plans_unordered, to_preserve);
     if (plans_sets.insert(canonical).second) {
-        decoded_plans->push_back(plan);
+        add_plan_no_duplicate_check(plan, cost);
         return 1;
     }
     return 0;
@@ -62,30 +87,57 @@ bool PlanSelector::is_ordering_preserved(OperatorID id) const {
 }
 
 
-void PlanSelector::save_plans(PlanManager& plan_manager) const {
-    std::ofstream os(json_filename.c_str());
-    bool first_dumped = false;
+void PlanSelector::stream_new_plans() {
+    for (; next_plan_to_stream < decoded_plans->size(); ++next_plan_to_stream) {
+        size_t i = next_plan_to_stream;
+        const Plan &plan = (*decoded_plans)[i];
+        int cost = decoded_plan_costs[i];
+        if (i < num_cheaper_streamed_plans) {
+            assert(cost < last_streamed_cost);
+            continue;
+        }
+        assert(cost >= last_streamed_cost);
+        if (cost > last_streamed_cost) {
+            num_cheaper_streamed_plans += streamed_plans_with_last_cost.size();
+            streamed_plans_with_last_cost.clear();
+            last_streamed_cost = cost;
+        }
+        if (streamed_plans_with_last_cost.insert(plan).second) {
+            ndjson_writer->write_plan(plan.begin(), plan.end() - 1, cost);
+        }
+    }
+    ndjson_writer->flush();
+}
+
+void PlanSelector::save_plans(PlanManager& plan_manager) {
+    if (dump_ndjson)
+        stream_new_plans();
+
+    std::unique_ptr<std::ofstream> json_file;
+    std::unique_ptr<JsonPlanWriter> json_writer;
     if (dump_json) {
         // Writing plans to JSON
-        os << "{ \"plans\" : [" << std::endl;
+        json_file = utils::make_unique_ptr<std::ofstream>(json_filename);
+        json_writer = utils::make_unique_ptr<JsonPlanWriter>(
+            *json_file, task_proxy, JsonPlanWriter::Format::MULTI_LINE);
+        json_writer->write("{ \"plans\" : [\n");
     }
-    for (auto it = decoded_plans->begin(); it != decoded_plans->end(); ++it)
-    {
-        Plan p {*it};
-        p.pop_back();
-        if (dump_plan_files)
-            plan_manager.save_plan(p, this->task_proxy, true);
+    Plan plan_without_dummy_action;
+    for (size_t i = 0; i < decoded_plans->size(); ++i) {
+        const Plan &plan = (*decoded_plans)[i];
+        if (dump_plan_files) {
+            plan_without_dummy_action.assign(plan.begin(), plan.end() - 1);
+            plan_manager.save_plan(plan_without_dummy_action, this->task_proxy, true);
+        }
 
         if (dump_json) {
-            if (first_dumped) {
-                os << "," << std::endl;
-            }
-            first_dumped = true;
-            plan_manager.write_plan_json(p, os, task_proxy);
+            if (i > 0)
+                json_writer->write(",\n");
+            json_writer->write_plan(plan.begin(), plan.end() - 1, decoded_plan_costs[i]);
         }
     }
     if (dump_json) {
-        os << "]}" << std::endl;
+        json_writer->write("]}\n");
     }
 }
 
@@ -6,6 +6,9 @@
 
 #include "../plan_manager.h"
 
+#include "json_plan_writer.h"
+
+#include <fstream>
 #include <string>
 #include <regex>
 
@@ -91,9 +94,33 @@ private:
     bool dump_plan_files;
     bool dump_json;
     std::string json_filename;
+    bool dump_ndjson;
 
     bool use_regex;
     std::unique_ptr<std::vector<Plan>> decoded_plans;
+    // Costs of the decoded plans (without the dummy goal action).
+    std::vector<int> decoded_plan_costs;
+
+    /*
+      Plans are streamed to the NDJSON file (one plan per line) whenever
+      plans are saved, so other tools can read them while the search is
+      running. Only the decoded plans after next_plan_to_stream are
+      considered. Eppstein's algorithm finds plans in order of cost, so
+      after it is restarted, the first num_cheaper_streamed_plans plans it
+      finds again are the streamed plans that are cheaper than
+      last_streamed_cost. Only the streamed plans with the last cost can
+      be found again in a different order, so we remember them to write
+      each plan at most once.
+    */
+    std::unique_ptr<std::ofstream> ndjson_file;
+    std::unique_ptr<JsonPlanWriter> ndjson_writer;
+    size_t next_plan_to_stream;
+    size_t num_cheaper_streamed_plans;
+    int last_streamed_cost;
+    utils::HashSet<Plan> streamed_plans_with_last_cost;
+
+    void check_plan_cost(const Plan &plan, int cost) const;
+    void stream_new_plans();
 
 public:
     PlanSelector(const options::Options &opts, const TaskProxy &task_proxy);
@@ -102,23 +129,28 @@ public:
 
     bool is_ordering_preserved(OperatorID id) const;
 
-    int add_plan_if_necessary(const Plan& plan);
+    // The plan includes the dummy goal action, the cost is the plan cost.
+    int add_plan_if_necessary(const Plan& plan, int cost);
     
     void set_regex(std::string re);
 
     void clear() {
         plans_sets.clear();
         decoded_plans = utils::make_unique_ptr<std::vector<Plan>>();
+        decoded_plan_costs.clear();
+        next_plan_to_stream = 0;
     }
 
     size_t num_decoded_plans() const { return decoded_plans->size(); }
 
 
-    void add_plan_no_duplicate_check(const Plan& plan) {
+    void add_plan_no_duplicate_check(const Plan& plan, int cost) {
+        check_plan_cost(plan, cost);
         decoded_plans->push_back(plan);
+        decoded_plan_costs.push_back(cost);
     }
 
-    void save_plans(PlanManager& plan_manager) const;
+    void save_plans(PlanManager& plan_manager);
 
     bool decode_plans_upfront() const { return keep_plans_unordered || use_regex; }
     bool is_dump_plans() const { return dump_plans; }
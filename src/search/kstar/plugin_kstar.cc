@@ -5,6 +5,8 @@
 #include "../plugin.h"
 #include "../structural_symmetries/group.h"
 
+#include "../utils/parallel.h"
+
 using namespace std;
 
 namespace plugin_kstar {
@@ -24,6 +26,15 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         "--search kstartiebreaking([sum([g(), h]), h], unsafe_pruning=false),\n"
         "               reopen_closed=true, f_eval=sum([g(), h]))\n"
         "```\n", true);
+    parser.document_note(
+        "Determinism",
+        "For the same task and options, K* finds the same plans in the same order "
+        "on every run and machine. Plans of equal cost are ordered by the order in "
+        "which Eppstein's algorithm generates them, which only depends on state and "
+        "operator ids. The exception is the ADAPTIVE switching policy and the "
+        "memory_budget option, which decide when to switch based on time and memory "
+        "measurements. They can change the order of plans with equal cost and which "
+        "plans of the highest cost are returned.");
     parser.add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
     parser.add_option<shared_ptr<Evaluator>>(
         "lazy_evaluator",
@@ -36,6 +47,23 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.add_option<int>("openlist_inc_percent_ub", "astar expand at most this amount, default 5 percent", "5");
     parser.add_option<bool>("switch_on_goal", "switch to eppstein when astar reached a goal", "false");
     parser.add_option<bool>("restart_eppstein", "extract plans more and restart eppstein", "true");
+    vector<string> switching_policies;
+    vector<string> switching_policies_doc;
+    switching_policies.push_back("FIXED");
+    switching_policies_doc.push_back(
+        "switch to eppstein after expanding openlist_inc_percent_lb to "
+        "openlist_inc_percent_ub percent of the expanded states, depending on "
+        "switch_on_goal and the threshold of the last eppstein phase");
+    switching_policies.push_back("ADAPTIVE");
+    switching_policies_doc.push_back(
+        "choose the number of astar expansions from the measured time per "
+        "expansion, the time of the last switch to eppstein and the number of "
+        "plans found per expansion, ignoring openlist_inc_percent_ub and "
+        "switch_on_goal");
+    parser.add_enum_option<kstar::SwitchingPolicy>(
+        "switching_policy", switching_policies,
+        "when to switch from astar to eppstein", "FIXED",
+        switching_policies_doc);
     parser.add_option<bool>("dump_plans", "dump intermediate plan files", "true");
     parser.add_option<int>("report_period", "report number of plans found so far in sec", "540");
     parser.add_option<bool>("find_unordered_plans", "find unordered plans by skipping reordered plans", "false");
@@ -44,11 +72,42 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.add_option<string>("json_file_to_dump",
         "A path to the json file to use for dumping",
         OptionParser::NONE);
+    parser.add_option<string>("ndjson_file_to_dump",
+        "A path to a file to which plans are streamed while searching, one JSON "
+        "object per line. Each plan is written once, when it is first reported",
+        OptionParser::NONE);
+    parser.add_option<string>("metrics_file",
+        "A path to a file to which per-iteration metrics of the A* and Eppstein "
+        "phases, the time to find each number of plans and a summary are "
+        "written as JSON lines",
+        OptionParser::NONE);
     parser.add_option<string>("preserve_orders_actions_regex",
         "A regex expression for specifying actions whose orders are not to be ignored",
         OptionParser::NONE);
     parser.add_option<bool>("allow_greedy_por", "Allow for partial order reduction when preserve_orders_actions_regex is used", "false");
+    parser.add_option<int>("memory_padding",
+        "amount of extra memory in MB that is reserved at the start of the search. "
+        "If the search runs out of memory, the padding is released, the search "
+        "stops and the plans found so far are saved, and the planner exits with "
+        "SEARCH_PLAN_FOUND_AND_OUT_OF_MEMORY. Use 0 to exit without saving "
+        "plans instead",
+        "75",
+        Bounds("0", "infinity"));
+    parser.add_option<int>("memory_budget",
+        "amount of memory in MB that the planner may use. Once the peak memory "
+        "exceeds 80% of the budget after the first plan was found, A* stops and "
+        "the remaining plans are extracted from the explored state space, so they "
+        "are not guaranteed to be the cheapest ones. Once the budget is exceeded, "
+        "the search stops and the plans found so far are saved. In both cases, the "
+        "planner exits with SEARCH_PLAN_FOUND_AND_OUT_OF_MEMORY",
+        "infinity",
+        Bounds("0", "infinity"));
     parser.add_option<bool>("write_dot", "Write a dot file kstar_search_space.dot", "false");
+    utils::add_num_threads_option_to_parser(parser);
+    parser.add_option<bool>("bucket_open_list",
+        "use a two-level bucket open list on (f, h) for the A* phase instead of "
+        "a map-based tie-breaking open list (both expand states in the same order)",
+        "true");
         
     parser.add_option<shared_ptr<Group>>(
         "symmetries",
@@ -67,7 +126,9 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
                 utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
             }
         }
-        auto temp = search_common::create_astar_open_list_factory_and_f_eval(opts);
+        auto temp = opts.get<bool>("bucket_open_list") ?
+            search_common::create_astar_bucket_open_list_factory_and_f_eval(opts) :
+            search_common::create_astar_open_list_factory_and_f_eval(opts);
         opts.set("open", temp.first);
         opts.set("f_eval", temp.second);        
         opts.set("reopen_closed", true);
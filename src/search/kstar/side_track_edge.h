@@ -9,6 +9,7 @@
 
 #include <fstream>
 #include <algorithm>
+#include <deque>
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
@@ -26,33 +27,9 @@ struct SideTrackEdge {
     int g_to;
     int cost_op;
 
-    StateRegistry* state_registry;
-
-    SideTrackEdge(const SideTrackEdge& other) 
-        : from(other.from), to(other.to), op(other.op), delta(other.delta), 
-        g_from(other.g_from), g_to(other.g_to), cost_op(other.cost_op),
-        state_registry(other.state_registry) {
-    }
-
-    SideTrackEdge(SideTrackEdge& other) 
-        : from(other.from), to(other.to), op(other.op), delta(other.delta), 
-        g_from(other.g_from), g_to(other.g_to), cost_op(other.cost_op),
-        state_registry(other.state_registry) {
-    }
-    
     SideTrackEdge(StateID from, StateID to, OperatorID op)
         : from(from), to(to), op(op), delta(0), 
-        g_from(0), g_to(0), cost_op(0),
-        state_registry(nullptr) {   
-    }
-
-    SideTrackEdge(StateID from, StateID to, OperatorID op, StateRegistry* state_registry)
-        : from(from), to(to), op(op), delta(0), 
-        g_from(0), g_to(0), cost_op(0),
-        state_registry(state_registry) {    
-    }
-
-    ~SideTrackEdge() {
+        g_from(0), g_to(0), cost_op(0) {   
     }
 
     StateID get_from() const { return this->from; }
@@ -67,28 +44,18 @@ struct SideTrackEdge {
 
     int get_op_cost() const { return this->cost_op; }
 
-    void set_state_registry(StateRegistry* state_registry) { 
-        this->state_registry = state_registry;
-    }
-
-    SideTrackEdge operator=(const SideTrackEdge& other) {        
-        this->from = other.from;
-        this->to = other.to;
-        this->op = other.op;
-        this->delta = other.delta;
-        this->g_from = other.g_from;
-        this->g_to = other.g_to;
-        this->state_registry = other.state_registry;
-        return *this;
-    }
-
+    // Total order on distinct edges, so sorting does not depend on the order of a hash set.
     bool operator<(const SideTrackEdge& other) const {
         if (this->delta != other.delta)
             return this->delta < other.delta;
         else if (this->g_from != other.g_from)
             return this->g_from < other.g_from;
-        else
+        else if (this->from != other.from)
             return this->from < other.from;
+        else if (this->to != other.to)
+            return this->to < other.to;
+        else
+            return this->op.get_index() < other.op.get_index();
     }
     
     bool operator<=(const SideTrackEdge& other) const {
@@ -132,7 +99,7 @@ struct SideTrackEdge {
         return this->g_from + this->cost_op - this->g_to;
     }
 
-    int get_delta() {
+    int get_delta() const {
         return this->delta;
     }
 
@@ -161,13 +128,10 @@ struct SideTrackEdgeHasher {
 };
 
 
+// Points to an edge stored in a SideTrackEdgeTable.
 struct SideTrackEdgeHandle{
-    std::shared_ptr<SideTrackEdge> ste_ptr;
-    SideTrackEdgeHandle(const std::shared_ptr<SideTrackEdge>& ptr): ste_ptr(ptr) {}
-
-    static SideTrackEdgeHandle create(const SideTrackEdge& ste) {
-        return std::make_shared<SideTrackEdge>(ste);
-    }
+    const SideTrackEdge* ste_ptr;
+    explicit SideTrackEdgeHandle(const SideTrackEdge* ptr): ste_ptr(ptr) {}
 
     bool operator< (const SideTrackEdgeHandle& other) const {
         return *ste_ptr < *other.ste_ptr;
@@ -209,22 +173,47 @@ struct SideTrackEdgeHandleHasher {
         return ste_handle.hash();
     }
 };
+
+
+/*
+  Stores the side-track edges in the Hin lists, so that handles are plain
+  pointers instead of separately allocated shared edges. Edges are only
+  removed all at once when the lists are rebuilt.
+*/
+class SideTrackEdgeTable {
+    // A deque does not move its elements when it grows, so handles stay valid.
+    std::deque<SideTrackEdge> edges;
+public:
+    SideTrackEdgeHandle add(const SideTrackEdge& ste) {
+        this->edges.push_back(ste);
+        return SideTrackEdgeHandle(&this->edges.back());
+    }
+
+    // Invalidates all handles.
+    void clear() {
+        std::deque<SideTrackEdge>().swap(this->edges);
+    }
+
+    std::size_t size() const {
+        return this->edges.size();
+    }
+
+    std::size_t estimate_memory_usage() const {
+        return sizeof(SideTrackEdgeTable) + this->edges.size() * sizeof(SideTrackEdge);
+    }
+};
 }
 
 namespace utils {
 inline void feed(HashState &hash_state, const kstar::SideTrackEdge &ste) {
-    State s_from = ste.state_registry->lookup_state(ste.from);      
-    State s_to = ste.state_registry->lookup_state(ste.to);
-    s_from.unpack();
-    s_to.unpack();
-    feed(hash_state, s_from);
-    feed(hash_state, s_to);
+    // State IDs identify registered states, so there is no need to unpack them.
+    feed(hash_state, ste.from.hash());
+    feed(hash_state, ste.to.hash());
     feed(hash_state, ste.op);
 }
 
 inline void feed(HashState &hash_state, const kstar::SideTrackEdgeHandle &ste_handle) {
-    kstar::SideTrackEdge ste = *ste_handle.ste_ptr;
-    feed(hash_state, ste);
+    feed(hash_state, *ste_handle.ste_ptr);
 }
 
 }
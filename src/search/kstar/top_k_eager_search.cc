@@ -17,12 +17,15 @@
 #include "../structural_symmetries/group.h"
 #include "../structural_symmetries/operator_permutation.h"
 #include "../utils/countdown_timer.h"
+#include "../utils/parallel.h"
 #include "../utils/timer.h"
 #include "../utils/memory.h"
+#include "../utils/profiling.h"
 #include "../utils/collections.h"
 
 #include <cassert>
 #include <cstdlib>
+#include <limits>
 #include <vector>
 #include <stack>
 #include <memory>
@@ -36,9 +39,21 @@ using namespace std;
 
 namespace kstar
 {
+    // Reading the peak memory from /proc is too expensive to do in every step.
+    static const int MEMORY_BUDGET_CHECK_INTERVAL = 1000;
+    // Fraction of the memory budget at which A* stops growing the search space.
+    static const double MEMORY_BUDGET_DRAIN_FRACTION = 0.8;
+    // Number of plans decoded at once when saving the plans.
+    static const size_t DECODING_BATCH_SIZE = 4096;
+
     TopKEagerSearch::TopKEagerSearch(const Options &opts)
         : SearchEngine(opts),
           report_period(opts.get<int>("report_period", 540)),
+          memory_padding_mb(opts.get<int>("memory_padding")),
+          memory_budget_kb(opts.get<int>("memory_budget") == numeric_limits<int>::max() ?
+                           numeric_limits<int64_t>::max() :
+                           static_cast<int64_t>(opts.get<int>("memory_budget")) * 1024),
+          num_decoding_threads(utils::get_num_threads_from_options(opts)),
           reopen_closed_nodes(opts.get<bool>("reopen_closed", true)),
           target_k(opts.get<int>("k", -1)),
           target_q(opts.get<double>("q", 0.0)),
@@ -47,6 +62,8 @@ namespace kstar
           openlist_inc_percent_ub(opts.get<int>("openlist_inc_percent_ub", 5)),
           switch_on_goal(opts.get<bool>("switch_on_goal", false)),
           restart_eppstein(opts.get<bool>("restart_eppstein", true)),
+          switching_policy(opts.get<SwitchingPolicy>("switching_policy")),
+          metrics(opts.contains("metrics_file") ? opts.get<string>("metrics_file") : ""),
           open_list(opts.get<shared_ptr<OpenListFactory>>("open")->create_state_open_list()),
           f_evaluator(opts.get<shared_ptr<Evaluator>>("f_eval", nullptr)),
           preferred_operator_evaluators(opts.get_list<shared_ptr<Evaluator>>("preferred")),
@@ -80,8 +97,14 @@ namespace kstar
             cerr << "lazy_evaluator must cache its estimates" << endl;
             utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
         }
+        if (num_decoding_threads > 1 && task_properties::has_axioms(task_proxy))
+        {
+            // the axiom evaluator used for computing successor states is shared
+            utils::g_log << "Decoding plans on a single thread because the task has axioms" << endl;
+            num_decoding_threads = 1;
+        }
         timer = utils::make_unique_ptr<utils::CountdownTimer>(max_time);
-        open_list_eppstein = utils::make_unique_ptr<std::priority_queue<PathGraphNode>>();
+        open_list_eppstein = utils::make_unique_ptr<PathGraphQueue>();
         solution_path_nodes = utils::make_unique_ptr<std::vector<PathGraphNode>>();
         goal_root = nullptr;
         this->plan_manager.set_plan_dirname("found_plans");
@@ -206,6 +229,8 @@ namespace kstar
 
     void TopKEagerSearch::search()
     {
+        if (this->memory_padding_mb > 0)
+            utils::reserve_extra_memory_padding(this->memory_padding_mb);
         initialize();
         SearchStatus status = IN_PROGRESS;
         this->outer_step_iter = 0;
@@ -213,13 +238,26 @@ namespace kstar
         {
             this->outer_step_iter++;
             status = step();
+            report_iteration_metrics();
             if (timer->is_expired())
             {
                 utils::g_log << "search::time limit" << std::endl;
                 utils::g_log << "search::normal_termination=" << 0 << std::endl;
                 status = TIMEOUT;
             }            
+            else if (out_of_memory())
+            {
+                utils::g_log << "search::memory limit" << std::endl;
+                utils::g_log << "search::normal_termination=" << 0 << std::endl;
+                this->memory_limit_reached = true;
+                status = FAILED;
+            }
         }
+        if (utils::extra_memory_padding_is_reserved())
+            utils::release_extra_memory_padding();
+        // Stopping A* early only leaves the run incomplete if plans are missing.
+        if (this->astar_stopped_by_memory_budget && (this->ignore_k || this->number_of_plans < this->target_k))
+            this->memory_limit_reached = true;
         utils::g_log << "search::total_step_iter=" << this->outer_step_iter << std::endl;
         utils::g_log << "search::total_num_astar_calls=" << this->num_astar_calls << std::endl;
         utils::g_log << "search::total_num_eppstein_calls=" << this->num_eppstein_calls << std::endl;
@@ -237,6 +275,10 @@ namespace kstar
         this->reopen_occurred = false;
         this->goal_node_generated = false;            
 
+        // the budget may have been nearly reached during the last Eppstein phase
+        if (this->first_goal_reached && this->memory_budget_nearly_reached && !this->open_list->empty())
+            stop_astar();
+
         if (!this->open_list->empty())
         {
             SearchStatus astar_status = IN_PROGRESS;
@@ -249,6 +291,15 @@ namespace kstar
             int target_steps_upper = int(double(this->statistics.get_expanded()) * double(this->openlist_inc_percent_ub) / 100.0);
             target_steps_low = (target_steps_low < 1) ? 1 : target_steps_low;
             target_steps_upper = (target_steps_upper < 1) ? 1 : target_steps_upper;
+            int astar_phase_length = 0;
+            if (this->switching_policy == SwitchingPolicy::ADAPTIVE && this->first_goal_reached && !this->ignore_k)
+            {
+                astar_phase_length = adaptive_switching.get_astar_phase_length(
+                    this->target_k - this->number_of_plans, target_steps_low);
+                utils::g_log << "step[" << this->outer_step_iter << "]::"
+                             << "astar_phase_length=" << astar_phase_length << std::endl;
+            }
+            double astar_time_before_phase = this->astar_search_timer();
             while(astar_status == IN_PROGRESS)
             {
                 this->astar_search_timer.resume();
@@ -278,7 +329,8 @@ namespace kstar
                     }
 
                     if (plan_selector->decode_plans_upfront()) {
-                        plan_selector->add_plan_if_necessary(get_plan());
+                        plan_selector->add_plan_if_necessary(
+                            get_plan(), get_plan_cost(get_plan(), this->optimal_cost));
                         assert(plan_selector->num_decoded_plans() == 1);
                     }
 
@@ -286,6 +338,7 @@ namespace kstar
                         this->target_cost_bound = (int) std::floor(this->target_q * (double) this->optimal_cost);
                     }
                     this->number_of_plans = 1;
+                    metrics.report_plans(this->number_of_plans, this->optimal_cost);
 
                     if (!this->ignore_k && this->number_of_plans >= this->target_k) {
                         utils::g_log << "step[1]::normal_termination=" << 1 << std::endl;
@@ -313,6 +366,15 @@ namespace kstar
                 {
                     return TIMEOUT;
                 }
+                else if (out_of_memory())
+                {
+                    return FAILED;
+                }
+                else if (this->first_goal_reached && this->memory_budget_nearly_reached)
+                {
+                    stop_astar();
+                    break;
+                }
                 
                 if (this->first_goal_reached)
                 {
@@ -322,7 +384,14 @@ namespace kstar
                     if (!this->ignore_quality && this->target_cost_bound < this->min_f_open_list)
                         break;
 
-                    if (!this->ignore_k)
+                    if (!this->ignore_k && this->switching_policy == SwitchingPolicy::ADAPTIVE)
+                    {
+                        // also expand until Eppstein's algorithm can extract at least one plan
+                        if (step_astar_iter >= astar_phase_length &&
+                            (this->eppstein_thr < 0 || eppstein_thr_below_min_f()))
+                            break;
+                    }
+                    else if (!this->ignore_k)
                     {
                         if (step_astar_iter == target_steps_upper || (this->switch_on_goal && this->goal_node_generated))
                             break;
@@ -331,13 +400,7 @@ namespace kstar
                         {
                             if (this->eppstein_thr >= 0)    // assumed there's no negative cost plan
                             {
-                                bool thr_lt_min_f;
-                                if (this->restart_eppstein)
-                                    thr_lt_min_f = this->eppstein_thr + this->optimal_cost <= this->min_f_open_list;
-                                else
-                                    thr_lt_min_f = this->eppstein_thr + this->optimal_cost < this->min_f_open_list;
-
-                                if (thr_lt_min_f)   // ensure extracting at least one plan
+                                if (eppstein_thr_below_min_f())   // ensure extracting at least one plan
                                     break;
                             }
                             else if (step_astar_iter >= target_steps_low)   // don't know eppstein_thr, so switch after expanding steps_low
@@ -348,13 +411,7 @@ namespace kstar
                         {
                             if (this->eppstein_thr >= 0)
                             {
-                                bool thr_lt_min_f;
-                                if (this->restart_eppstein)
-                                    thr_lt_min_f = this->eppstein_thr + this->optimal_cost <= this->min_f_open_list;
-                                else
-                                    thr_lt_min_f = this->eppstein_thr + this->optimal_cost < this->min_f_open_list;
-
-                                if (thr_lt_min_f)   // ensure extracting at least one plan
+                                if (eppstein_thr_below_min_f())   // ensure extracting at least one plan
                                     break;
                             }
                             else    // don't know eppstein_thr, so switch after expanding steps_low 
@@ -363,18 +420,27 @@ namespace kstar
                     }
                 }       // break conditions after reaching the first goal
             }           // while astar status
+            adaptive_switching.report_astar_phase(
+                step_astar_iter, this->astar_search_timer() - astar_time_before_phase);
         }               // astar steps
 
+        double eppstein_time_before_phase = this->eppstein_search_timer();
+        int plans_before_phase = this->number_of_plans;
         if (this->reopen_occurred)
         {
             this->eppstein_search_timer.resume();
+            metrics.rebuild_timer.resume();
             rebuild_eppstein();
+            metrics.rebuild_timer.stop();
+            ++metrics.num_rebuilds;
             this->eppstein_search_timer.stop();
         }
         
         this->eppstein_search_timer.resume();
         initialize_eppstein();
         this->eppstein_search_timer.stop();
+        // Extracting plans is not part of the cost of switching.
+        double switch_time = this->eppstein_search_timer() - eppstein_time_before_phase;
 
         if (!this->open_list_eppstein->empty())
         {
@@ -396,8 +462,12 @@ namespace kstar
                 }
                 else if (timer->is_expired())
                     return TIMEOUT;
+                else if (out_of_memory())
+                    return FAILED;
             }
         }
+        adaptive_switching.report_eppstein_phase(
+            this->number_of_plans - plans_before_phase, switch_time);
 
         if (this->open_list_eppstein->empty())
         {
@@ -429,6 +499,7 @@ namespace kstar
 
     SearchStatus TopKEagerSearch::step_astar()
     {
+        PROFILE_SCOPE("kstar astar step");
         tl::optional<SearchNode> node;
         while (true)
         {
@@ -437,7 +508,11 @@ namespace kstar
                 utils::g_log << "Completely explored state space -- no solution!" << endl;
                 return FAILED;
             }
-            StateID id = open_list->remove_min();
+            StateID id = StateID::no_state;
+            {
+                PROFILE_SCOPE("open list removal");
+                id = open_list->remove_min();
+            }
             State s = state_registry.lookup_state(id);
             node.emplace(search_space.get_node(s));
 
@@ -498,7 +573,7 @@ namespace kstar
         {
             const SearchNodeInfo &info = this->search_space.look_up_search_node_info(s.get_id());
             HinLists[s].update_ste_delta(s.get_id(), this->state_registry, this->search_space);
-            HinLists[s].create_list_from_set(info.parent_state_id, info.creating_operator);
+            HinLists[s].create_list_from_set(info.parent_state_id, info.creating_operator, this->ste_table);
         }
 
         if (!this->first_goal_reached && task_properties::is_goal_state(task_proxy, s)) 
@@ -689,7 +764,7 @@ namespace kstar
                 // TODO: using extending with sym, we don't need to add all stes
                 // we can skip stes with operator symmetry and recover with extender 
                 // rather than generating all ste per transitions
-                SideTrackEdge ste(s.get_id(), succ_state.get_id(), op_id, &this->state_registry);
+                SideTrackEdge ste(s.get_id(), succ_state.get_id(), op_id);
                 ste.update_cost_op(get_adjusted_cost(op));
                 ste.update_g_from(node->get_g());
                 ste.update_g_to(succ_g);
@@ -741,7 +816,7 @@ namespace kstar
                         */
                         this->open_list->insert(succ_eval_context, succ_state.get_id());
 
-                        SideTrackEdge ste(s.get_id(), succ_state.get_id(), op_id, &this->state_registry);
+                        SideTrackEdge ste(s.get_id(), succ_state.get_id(), op_id);
                         ste.update_cost_op(get_adjusted_cost(op));
                         ste.update_g_from(node->get_g());
                         ste.update_g_to(node->get_g() + get_adjusted_cost(op));
@@ -766,7 +841,7 @@ namespace kstar
                     if (this->switch_on_goal && task_properties::is_goal_state(this->task_proxy, s))
                         this->goal_node_generated = true;
 
-                    SideTrackEdge ste(s.get_id(), succ_state.get_id(), op_id, &this->state_registry);
+                    SideTrackEdge ste(s.get_id(), succ_state.get_id(), op_id);
                     ste.update_cost_op(get_adjusted_cost(op));
                     ste.update_g_from(node->get_g());
                     ste.update_g_to(succ_node.get_g());
@@ -775,7 +850,7 @@ namespace kstar
                     this->HinLists[succ_state].insert_ste_to_set(ste);
                     
                     if (!this->reopen_occurred && HinLists[succ_state].node_closed)
-                        this->HinLists[succ_state].push_back_ste_handle_to_sorted_list(ste);
+                        this->HinLists[succ_state].push_back_ste_handle_to_sorted_list(ste, this->ste_table);
                     if (write_dot)
                         ste_for_dump.push_back(ste);
                 }
@@ -786,6 +861,9 @@ namespace kstar
 
     void TopKEagerSearch::rebuild_eppstein()
     {
+        PROFILE_SCOPE("kstar eppstein rebuild");
+        // All lists are created anew, so the edges of the old lists are no longer referenced.
+        this->ste_table.clear();
         for (auto it = this->state_registry.begin(); it != this->state_registry.end(); ++it)
         {
             StateID sid = *it;
@@ -800,11 +878,11 @@ namespace kstar
                 this->HinLists[s].node_closed = true;
                 this->HinLists[s].update_ste_delta(sid, this->state_registry, this->search_space);
                 const SearchNodeInfo &info = this->search_space.look_up_search_node_info(sid);
-                this->HinLists[s].create_list_from_set(info.parent_state_id, info.creating_operator);
+                this->HinLists[s].create_list_from_set(info.parent_state_id, info.creating_operator, this->ste_table);
             }
             this->HtreeLists[s].clear_list();
         }        
-        this->open_list_eppstein = utils::make_unique_ptr<std::priority_queue<PathGraphNode>>();
+        this->open_list_eppstein->clear();
         this->solution_path_nodes = utils::make_unique_ptr<std::vector<PathGraphNode>>();
         if (this->goal_root != nullptr) 
             this->goal_root.reset();
@@ -858,10 +936,9 @@ namespace kstar
             return;
 
         // purge eppstein queues with nodes generated in the previous eppstein iteration
-        if (!this->open_list_eppstein->empty())
-            this->open_list_eppstein = utils::make_unique_ptr<std::priority_queue<PathGraphNode>>();
         if (!this->solution_path_nodes->empty())
             this->solution_path_nodes = utils::make_unique_ptr<std::vector<PathGraphNode>>();
+        this->open_list_eppstein->clear();
         if (this->goal_root != nullptr) 
             this->goal_root.reset();
         
@@ -871,7 +948,8 @@ namespace kstar
         if (plan_selector->decode_plans_upfront())
         {
             // plan_selector does not remove dummy action!
-            plan_selector->add_plan_if_necessary(get_plan());
+            plan_selector->add_plan_if_necessary(
+                get_plan(), get_plan_cost(get_plan(), this->optimal_cost));
         }
 
         const State& goal_state = this->state_registry.lookup_state(this->goal_state_id);
@@ -887,10 +965,7 @@ namespace kstar
 
             this->goal_root = utils::make_unique_ptr<PathGraphNode>(
                 this->goal_state_id, it_htreelist, it_hinlist,
-                nullptr, false, &this->state_registry);
-
-            if (!this->restart_eppstein)
-                this->goal_root->creation_time = (double) this->timer->get_elapsed_time();
+                nullptr, false);
 
             bool thr_lt_min_f;
             if (this->restart_eppstein)
@@ -900,16 +975,19 @@ namespace kstar
 
             if (this->open_list->empty() || thr_lt_min_f) {
                 this->open_list_eppstein->push(*this->goal_root);
+                ++metrics.path_graph_nodes;
             }
         }
     }        
 
     SearchStatus TopKEagerSearch::step_eppstein()
     {
+        PROFILE_SCOPE("kstar eppstein step");
         if (this->open_list_eppstein->empty())
             return FAILED;
 
-        PathGraphNode *temp_ptr = new PathGraphNode(this->open_list_eppstein->top());
+        // the node stays in the queue as the parent of its children after it is popped
+        PathGraphNode *temp_ptr = this->open_list_eppstein->top();
         std::vector<PathGraphNode> children_nodes;
         generate_eppstein_children(temp_ptr, children_nodes);
         if (!this->restart_eppstein)
@@ -943,23 +1021,38 @@ namespace kstar
 
         // process one valid path graph node to count plans found so far
         this->open_list_eppstein->pop();
+        ++metrics.eppstein_pops;
 
         // push to solution_path_nodes only if the path graph node is within the cost bound
         if (temp_ptr->path_value + this->optimal_cost <= this->target_cost_bound) 
         {
+            int num_new_plans = 1;
             if (plan_selector->decode_plans_upfront()) {
                 // decode path graph node here to know the number of symmetric plans
+                metrics.decoding_timer.resume();
                 Plan decoded_plan = this->decode_actual_plan(temp_ptr);
-                this->number_of_plans += plan_selector->add_plan_if_necessary(decoded_plan);
+                metrics.decoding_timer.stop();
+                int plan_cost = get_plan_cost(decoded_plan, this->optimal_cost + temp_ptr->path_value);
+                metrics.dedup_timer.resume();
+                num_new_plans = plan_selector->add_plan_if_necessary(decoded_plan, plan_cost);
+                metrics.dedup_timer.stop();
             }
             else {
                 this->solution_path_nodes->push_back(*temp_ptr);
-                this->number_of_plans += 1;     // don't decode path graph node now, do it later
+                // don't decode path graph node now, do it later
+            }
+            this->number_of_plans += num_new_plans;
+            if (num_new_plans > 0) {
+                ++metrics.plans_accepted;
+                metrics.report_plans(this->number_of_plans, this->optimal_cost + temp_ptr->path_value);
+            } else {
+                ++metrics.plans_rejected;
             }
     
             for (auto &ch : children_nodes) {
                 this->open_list_eppstein->push(ch);
             }
+            metrics.path_graph_nodes += children_nodes.size();
         }
             
         if (!this->ignore_k && this->number_of_plans >= this->target_k)
@@ -991,11 +1084,8 @@ namespace kstar
             auto ch_hin_it = this->HinLists[ch_s_hin].get_first_it();
             
             PathGraphNode ch (pn->sid_htree, ch_htree_it, ch_hin_it, 
-                              pn, false, pn->state_registry);
+                              pn, false);
 
-            if (!this->restart_eppstein)
-                ch.creation_time = (double) this->timer->get_elapsed_time();
-            
             if (this->ignore_quality)  {
                 children_nodes.push_back(ch);
             }
@@ -1012,9 +1102,7 @@ namespace kstar
             PathGraphNode ch (pn->sid_htree, 
                               pn->it_htreelist, 
                               ch_hin_it,
-                              pn, false, pn->state_registry);
-            if (!this->restart_eppstein)
-                ch.creation_time = (double) this->timer->get_elapsed_time();
+                              pn, false);
 
             if (this->ignore_quality) {
                 children_nodes.push_back(ch);
@@ -1035,10 +1123,7 @@ namespace kstar
             auto ch_hin_it = this->HinLists[ch_s_hin].get_first_it();
 
             PathGraphNode ch (sid_from, it_htree_first, ch_hin_it,
-                              pn, true, pn->state_registry);
-            
-            if (!this->restart_eppstein)
-                ch.creation_time = (double) this->timer->get_elapsed_time();
+                              pn, true);
 
             if (this->ignore_quality) {
                 children_nodes.push_back(ch);
@@ -1049,12 +1134,12 @@ namespace kstar
         }
     }
 
-    void TopKEagerSearch::decode_plan_from_path_graph_node(PathGraphNode *pn, Plan &plan, vector<StateID>& decoded_states)
+    void TopKEagerSearch::decode_plan_from_path_graph_node(const PathGraphNode *pn, Plan &plan, vector<StateID>& decoded_states)
     {
         std::stack<SideTrackEdgeHandle> active_deviations;
         bool active = true;
 
-        PathGraphNode *current = pn;
+        const PathGraphNode *current = pn;
         while (current != nullptr && current->sid_htree != StateID::no_state)
         {
             if (active) {
@@ -1099,20 +1184,22 @@ namespace kstar
         std::reverse(decoded_states.begin(), decoded_states.end());
     }
 
-    SideTrackEdgeHandle TopKEagerSearch::get_ste_from_path_graph_node(PathGraphNode* pn) {
+    SideTrackEdgeHandle TopKEagerSearch::get_ste_from_path_graph_node(const PathGraphNode* pn) {
         return *pn->it_hinlist;
     }
 
+    bool TopKEagerSearch::eppstein_thr_below_min_f() const
+    {
+        if (this->restart_eppstein)
+            return this->eppstein_thr + this->optimal_cost <= this->min_f_open_list;
+        else
+            return this->eppstein_thr + this->optimal_cost < this->min_f_open_list;
+    }
+
     int TopKEagerSearch::get_astar_head_value()
     {
-        StateID id = this->open_list->remove_min();
-        State s = this->state_registry.lookup_state(id);
-        tl::optional<SearchNode> node;
-        node.emplace(search_space.get_node(s));
-        EvaluationContext eval_context(s, node->get_g(), false, &this->statistics);
-        this->open_list->insert(eval_context, id);
-        int f_value = eval_context.get_evaluator_value(this->f_evaluator.get());
-        return f_value;
+        // Both A* open lists of K* are ordered by f first.
+        return this->open_list->get_min_primary_key();
     }
 
     void TopKEagerSearch::print_statistics() const
@@ -1120,6 +1207,24 @@ namespace kstar
         this->statistics.print_detailed_statistics();
         this->search_space.print_statistics();
         this->pruning_method->print_statistics();
+
+        vector<Evaluator *> evals;
+        this->open_list->get_involved_evaluators(evals);
+        for (const shared_ptr<Evaluator> &evaluator : this->preferred_operator_evaluators)
+            evaluator->get_involved_evaluators(evals);
+        if (this->f_evaluator)
+            this->f_evaluator->get_involved_evaluators(evals);
+        if (this->lazy_evaluator)
+            this->lazy_evaluator->get_involved_evaluators(evals);
+        for (Evaluator *evaluator : evals)
+            evaluator->print_statistics();
+
+        this->metrics.print_statistics();
+        // Written here rather than at the end of search to include the time for saving the plans.
+        this->metrics.report_summary(
+            this->outer_step_iter, this->statistics.get_expanded(),
+            this->astar_search_timer(), this->eppstein_search_timer(),
+            this->number_of_plans);
     }
 
     void TopKEagerSearch::report_intermediate_plans()
@@ -1135,8 +1240,32 @@ namespace kstar
         }
     }
 
+    std::vector<Plan> TopKEagerSearch::decode_actual_plans(
+        const std::vector<PathGraphNode> &nodes, size_t begin, size_t end)
+    {
+        PROFILE_SCOPE("kstar plan decoding");
+        int num_plans = end - begin;
+        std::vector<Plan> surrogate_plans(num_plans);
+        std::vector<std::vector<StateID>> decoded_states(num_plans);
+        // Tracing the paths reads the search space, which is not thread-safe.
+        for (int i = 0; i < num_plans; ++i)
+            decode_plan_from_path_graph_node(&nodes[begin + i], surrogate_plans[i], decoded_states[i]);
+        if (!use_dks() && !use_oss())
+            return surrogate_plans;
+
+        // Mapping the surrogate plans to actual plans only reads the search space.
+        // No profiling scopes or logging on the worker threads.
+        std::vector<Plan> actual_plans(num_plans);
+        utils::parallel_for(this->num_decoding_threads, num_plans, [&](int i) {
+            this->search_space.surrogate_trace_to_plan(
+                decoded_states[i], surrogate_plans[i], actual_plans[i], this->task, this->group);
+        });
+        return actual_plans;
+    }
+
     Plan TopKEagerSearch::decode_actual_plan(PathGraphNode* pn)
     {
+        PROFILE_SCOPE("kstar plan decoding");
         Plan actual_plan;
         Plan surrogate_plan;
         vector<StateID> decoded_states;
@@ -1149,11 +1278,86 @@ namespace kstar
         return actual_plan;
     }
 
+    int TopKEagerSearch::get_plan_cost(const Plan &plan, int adjusted_cost) const
+    {
+        // Path values are sums of adjusted costs, which are the plan costs for cost_type=normal.
+        if (cost_type == OperatorCost::NORMAL)
+            return adjusted_cost;
+        return calculate_plan_cost(plan, task_proxy);
+    }
+
+    bool TopKEagerSearch::memory_padding_used() const
+    {
+        return this->memory_padding_mb > 0 && !utils::extra_memory_padding_is_reserved();
+    }
+
+    void TopKEagerSearch::check_memory_budget()
+    {
+        if (this->memory_budget_kb == numeric_limits<int64_t>::max() || --this->steps_until_memory_check > 0)
+            return;
+        this->steps_until_memory_check = MEMORY_BUDGET_CHECK_INTERVAL;
+        int memory_kb = utils::get_peak_memory_in_kb();
+        if (memory_kb >= this->memory_budget_kb)
+        {
+            utils::g_log << "Memory budget of " << this->memory_budget_kb << " KB exhausted" << std::endl;
+            this->memory_budget_exceeded = true;
+        }
+        else if (memory_kb >= MEMORY_BUDGET_DRAIN_FRACTION * this->memory_budget_kb)
+        {
+            this->memory_budget_nearly_reached = true;
+        }
+    }
+
+    bool TopKEagerSearch::out_of_memory()
+    {
+        check_memory_budget();
+        return memory_padding_used() || this->memory_budget_exceeded;
+    }
+
+    void TopKEagerSearch::stop_astar()
+    {
+        update_memory_estimates();
+        utils::g_log << "Memory budget nearly exhausted, stopping A* and extracting the remaining plans "
+                     << "from the explored part of the state space" << std::endl;
+        utils::g_log << "Memory of registered states: "
+                     << this->state_registry.size() * this->state_registry.get_state_size_in_bytes() / 1024
+                     << " KB" << std::endl;
+        utils::g_log << "Memory of Hin lists: " << metrics.hin_lists_memory / 1024 << " KB" << std::endl;
+        utils::g_log << "Memory of Htree lists: " << metrics.htree_lists_memory / 1024 << " KB" << std::endl;
+        utils::g_log << "Memory of path graph nodes: " << metrics.path_graph_memory / 1024 << " KB" << std::endl;
+        utils::g_log << "Decoded plans: " << plan_selector->num_decoded_plans() << std::endl;
+
+        // Without A*, Eppstein's algorithm is no longer bounded by the f-value of the open list.
+        this->open_list->clear();
+        if (write_dot)
+        {
+            utils::g_log << "Not writing the dot file to save memory" << std::endl;
+            this->write_dot = false;
+            std::vector<SideTrackEdge>().swap(this->ste_for_dump);
+        }
+        // The remaining plans are not guaranteed to be the cheapest ones.
+        this->astar_stopped_by_memory_budget = true;
+    }
+
+    void TopKEagerSearch::release_search_memory()
+    {
+        // Decoding plans only needs the search space and the path graph nodes of the found plans.
+        this->open_list->clear();
+        this->open_list_eppstein->release_entries();
+    }
+
     void TopKEagerSearch::save_plan_if_necessary()
     {
         if (!plan_selector->is_dump_plans())
             return; 
 
+        if (this->memory_limit_reached || this->astar_stopped_by_memory_budget)
+        {
+            utils::g_log << "Releasing the open lists to save the " << this->number_of_plans
+                         << " plans found before reaching the memory limit" << std::endl;
+            release_search_memory();
+        }
+
         if (this->number_of_plans > 0 && !plan_selector->decode_plans_upfront() && this->number_of_plans != (int) plan_selector->num_decoded_plans())
         {
             int count_plans = 0;
@@ -1166,25 +1370,30 @@ namespace kstar
             {
                 // TODO: When we move things into the plan extender, we can change its behavior to not check for duplicates
                 //       and store plans in the case when no decoding upfront was performed.
-                plan_selector->add_plan_no_duplicate_check(get_plan());
+                plan_selector->add_plan_no_duplicate_check(
+                    get_plan(), get_plan_cost(get_plan(), this->optimal_cost));
                 count_plans = 1;
             }
             
             // process kstar plans
-            while (count_plans < this->target_k)
+            const std::vector<PathGraphNode> &nodes = *this->solution_path_nodes;
+            size_t batch_begin = 0;
+            while (count_plans < this->target_k && batch_begin < nodes.size())
             {
-                auto it = this->solution_path_nodes->begin();
-                for (; it != this->solution_path_nodes->end(); ++it)
+                // decode in batches to bound the memory of plans that are not handed to the plan selector yet
+                size_t batch_end = std::min(nodes.size(), batch_begin + DECODING_BATCH_SIZE);
+                metrics.decoding_timer.resume();
+                std::vector<Plan> decoded_plans = this->decode_actual_plans(nodes, batch_begin, batch_end);
+                metrics.decoding_timer.stop();
+                for (size_t i = batch_begin; i < batch_end; ++i)
                 {
-                    PathGraphNode pn = *it;
-                    Plan decoded_plan;
-                    decoded_plan = this->decode_actual_plan(&pn);       // all cases are divided inside this method
+                    const Plan &decoded_plan = decoded_plans[i - batch_begin];
                     // TODO: here as well, as in todo above, when we move things to the plan extender, ensure correct behavior. 
-                    plan_selector->add_plan_no_duplicate_check(decoded_plan);
+                    plan_selector->add_plan_no_duplicate_check(
+                        decoded_plan, get_plan_cost(decoded_plan, this->optimal_cost + nodes[i].path_value));
                     count_plans++;
                 }
-                if (it == this->solution_path_nodes->end())
-                    break;
+                batch_begin = batch_end;
             }
             if (!this->ignore_k) {
                 assert ((int) plan_selector->num_decoded_plans() <= this->target_k);
@@ -1197,7 +1406,40 @@ namespace kstar
         this->plan_manager.move_plans("found_plans", "found_plans/done");
         this->plan_manager.set_num_previously_generated_plans(0);
 
+        PROFILE_SCOPE("kstar plan output");
+        metrics.output_timer.resume();
         plan_selector->save_plans(plan_manager);
+        metrics.output_timer.stop();
+    }
+
+    void TopKEagerSearch::update_memory_estimates()
+    {
+        // The const accessors do not create entries for states without lists.
+        const PerStateInformation<HinList> &hin_lists = this->HinLists;
+        const PerStateInformation<HtreeList> &htree_lists = this->HtreeLists;
+        metrics.hin_lists_memory = 0;
+        metrics.htree_lists_memory = 0;
+        for (StateID sid : this->state_registry) {
+            State s = this->state_registry.lookup_state(sid);
+            metrics.hin_lists_memory += hin_lists[s].estimate_memory_usage();
+            metrics.htree_lists_memory += htree_lists[s].estimate_memory_usage();
+        }
+        metrics.hin_lists_memory += this->ste_table.estimate_memory_usage();
+        size_t num_stored_nodes = this->solution_path_nodes->size() + (this->goal_root ? 1 : 0);
+        metrics.path_graph_memory = this->open_list_eppstein->estimate_memory_usage() +
+            num_stored_nodes * sizeof(PathGraphNode);
+    }
+
+    void TopKEagerSearch::report_iteration_metrics()
+    {
+        // Walking over all states is expensive, so only do it if the metrics are written.
+        if (metrics.is_enabled())
+            update_memory_estimates();
+        metrics.report_iteration(
+            this->outer_step_iter, this->statistics.get_expanded(),
+            this->astar_search_timer(), this->eppstein_search_timer(),
+            this->reopen_occurred, this->number_of_plans,
+            this->open_list_eppstein->size());
     }
 
     void TopKEagerSearch::reward_progress()
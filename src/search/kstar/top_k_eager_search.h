@@ -2,6 +2,7 @@
 #define KSTAR_TOP_K_EAGER_SEARCH_H
 
 #include "path_graph.h"
+#include "path_graph_queue.h"
 
 #include "../open_list.h"
 #include "../open_list_factory.h"
@@ -12,12 +13,14 @@
 #include "../utils/countdown_timer.h"
 #include "../utils/timer.h"
 
+#include "adaptive_switching.h"
+#include "kstar_metrics.h"
 #include "plan_selector.h"
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <unordered_map>
-#include <queue>
 
 
 class Evaluator;
@@ -36,6 +39,15 @@ class TopKEagerSearch : public SearchEngine {
     bool ignore_quality = true;         // if target_q is less than 1, target_k is the only criteria
     bool ignore_k = false;              // if target_k is less than 1, target_q is the only criteria
     int report_period;
+    int memory_padding_mb;
+    // Peak memory in KB at which the search stops; std::numeric_limits<int64_t>::max() for no budget.
+    int64_t memory_budget_kb;
+    int steps_until_memory_check = 0;
+    bool memory_budget_nearly_reached = false;
+    bool memory_budget_exceeded = false;
+    // True once A* was stopped early because the memory budget was nearly exhausted.
+    bool astar_stopped_by_memory_budget = false;
+    int num_decoding_threads;
     const bool reopen_closed_nodes;
     std::shared_ptr<Group> group;
     int target_k;                    // number of k plans
@@ -46,6 +58,8 @@ class TopKEagerSearch : public SearchEngine {
     int openlist_inc_percent_ub;
     bool switch_on_goal;
     bool restart_eppstein;
+    SwitchingPolicy switching_policy;
+    AdaptiveSwitching adaptive_switching;
     int outer_step_iter = 0;
     int num_astar_calls = 0;
     int num_eppstein_calls = 0;
@@ -61,6 +75,7 @@ class TopKEagerSearch : public SearchEngine {
     std::unique_ptr<utils::CountdownTimer> timer;
     utils::Timer astar_search_timer;
     utils::Timer eppstein_search_timer;
+    KStarMetrics metrics;
 
     // A*
     std::unique_ptr<StateOpenList> open_list;
@@ -83,8 +98,9 @@ class TopKEagerSearch : public SearchEngine {
     std::vector<SideTrackEdge> ste_for_dump;
 
     // EA   
-    std::unique_ptr<std::priority_queue<PathGraphNode>> open_list_eppstein;
+    std::unique_ptr<PathGraphQueue> open_list_eppstein;
     std::unique_ptr<std::vector<PathGraphNode>> solution_path_nodes;
+    SideTrackEdgeTable ste_table;       // edges referenced by the HinLists and HtreeLists
     PerStateInformation<HinList> HinLists;
     PerStateInformation<HtreeList> HtreeLists;
     
@@ -99,6 +115,8 @@ class TopKEagerSearch : public SearchEngine {
     void reward_progress();
 
     int get_astar_head_value();
+    // True if the threshold of the last Eppstein phase is below the f-value of the A* open list.
+    bool eppstein_thr_below_min_f() const;
     void initialize_astar();
     void initialize_eppstein();
     void rebuild_eppstein();
@@ -107,10 +125,25 @@ class TopKEagerSearch : public SearchEngine {
     SearchStatus step_eppstein();
     void build_htree_list(StateID sid);
     void generate_eppstein_children(PathGraphNode* pn, std::vector<PathGraphNode>& children_nodes);
-    void decode_plan_from_path_graph_node(PathGraphNode* pn, Plan& plan, std::vector<StateID>& decoded_states);
-    SideTrackEdgeHandle get_ste_from_path_graph_node(PathGraphNode* pn);
+    void decode_plan_from_path_graph_node(const PathGraphNode* pn, Plan& plan, std::vector<StateID>& decoded_states);
+    SideTrackEdgeHandle get_ste_from_path_graph_node(const PathGraphNode* pn);
     void report_intermediate_plans();
+    void report_iteration_metrics();
+    // True if an allocation failed and the memory padding reserved for decoding the plans found so far was used.
+    bool memory_padding_used() const;
+    // Compares the peak memory with the budget in every MEMORY_BUDGET_CHECK_INTERVAL-th call.
+    void check_memory_budget();
+    // True if the memory padding was used or the memory budget is exceeded.
+    bool out_of_memory();
+    // Stops growing the search space, so Eppstein's algorithm extracts the remaining plans from it.
+    void stop_astar();
+    void update_memory_estimates();
+    void release_search_memory();
     Plan decode_actual_plan(PathGraphNode* pn);
+    // Decodes nodes[begin, end) in order, mapping surrogate plans to actual plans on num_threads threads.
+    std::vector<Plan> decode_actual_plans(const std::vector<PathGraphNode> &nodes, size_t begin, size_t end);
+    // Cost of a decoded plan whose cost in terms of adjusted costs is known.
+    int get_plan_cost(const Plan &plan, int adjusted_cost) const;
 
     void write_dot_file() const;
 
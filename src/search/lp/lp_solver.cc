@@ -148,7 +148,10 @@ LPSolver::LPSolver(LPSolverType solver_type)
       is_mip(false),
       is_solved(false),
       num_permanent_constraints(0),
-      has_temporary_constraints_(false) {
+      has_temporary_constraints_(false),
+      use_warm_start(true),
+      num_solves(0),
+      num_simplex_iterations(0) {
     try {
         lp_solver = create_lp_solver(solver_type);
     } catch (CoinError &error) {
@@ -362,6 +365,35 @@ void LPSolver::set_constraint_upper_bound(int index, double bound) {
     is_solved = false;
 }
 
+void LPSolver::set_constraint_lower_bounds(
+    const vector<int> &indices, const vector<double> &bounds) {
+    assert(indices.size() == bounds.size());
+    changed_indices.clear();
+    changed_bounds.clear();
+    try {
+        const double *row_lower = lp_solver->getRowLower();
+        const double *row_upper = lp_solver->getRowUpper();
+        for (size_t i = 0; i < indices.size(); ++i) {
+            int index = indices[i];
+            assert(index < get_num_constraints());
+            if (row_lower[index] != bounds[i]) {
+                changed_indices.push_back(index);
+                changed_bounds.push_back(bounds[i]);
+                changed_bounds.push_back(row_upper[index]);
+            }
+        }
+        if (!changed_indices.empty()) {
+            lp_solver->setRowSetBounds(
+                changed_indices.data(),
+                changed_indices.data() + changed_indices.size(),
+                changed_bounds.data());
+            is_solved = false;
+        }
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+
 void LPSolver::set_variable_lower_bound(int index, double bound) {
     assert(index < get_num_variables());
     try {
@@ -386,9 +418,17 @@ void LPSolver::set_mip_gap(double gap) {
     lp::set_mip_gap(lp_solver.get(), gap);
 }
 
+void LPSolver::set_use_warm_start(bool use_warm_start) {
+    this->use_warm_start = use_warm_start;
+}
+
 void LPSolver::solve() {
     try {
         if (is_initialized) {
+            if (!use_warm_start) {
+                // Passing a null pointer resets the basis to the slack basis.
+                lp_solver->setWarmStart(nullptr);
+            }
             lp_solver->resolve();
         } else {
             lp_solver->initialSolve();
@@ -404,6 +444,8 @@ void LPSolver::solve() {
                  << "Reasons include \"numerical difficulties\" and running out of memory." << endl;
             utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
         }
+        ++num_solves;
+        num_simplex_iterations += lp_solver->getIterationCount();
         is_solved = true;
     } catch (CoinError &error) {
         handle_coin_error(error);
@@ -499,9 +541,25 @@ int LPSolver::has_temporary_constraints() const {
     return has_temporary_constraints_;
 }
 
+int64_t LPSolver::get_num_solves() const {
+    return num_solves;
+}
+
+int64_t LPSolver::get_num_simplex_iterations() const {
+    return num_simplex_iterations;
+}
+
 void LPSolver::print_statistics() const {
     utils::g_log << "LP variables: " << get_num_variables() << endl;
     utils::g_log << "LP constraints: " << get_num_constraints() << endl;
+    utils::g_log << "LP warm starts: " << (use_warm_start ? "yes" : "no") << endl;
+    utils::g_log << "LPs solved: " << num_solves << endl;
+    utils::g_log << "Simplex iterations: " << num_simplex_iterations << endl;
+    if (num_solves > 0) {
+        utils::g_log << "Simplex iterations per LP: "
+                     << static_cast<double>(num_simplex_iterations) / num_solves
+                     << endl;
+    }
 }
 
 #endif
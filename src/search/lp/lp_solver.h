@@ -5,6 +5,7 @@
 #include "../utils/language.h"
 #include "../utils/system.h"
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -122,6 +123,9 @@ class LPSolver {
     bool is_solved;
     int num_permanent_constraints;
     bool has_temporary_constraints_;
+    bool use_warm_start;
+    int64_t num_solves;
+    int64_t num_simplex_iterations;
 #ifdef USE_LP
     std::unique_ptr<OsiSolverInterface> lp_solver;
 #endif
@@ -139,6 +143,8 @@ class LPSolver {
     std::vector<double> row_lb;
     std::vector<double> row_ub;
     std::vector<CoinPackedVectorBase *> rows;
+    std::vector<int> changed_indices;
+    std::vector<double> changed_bounds;
     void clear_temporary_data();
 public:
     LP_METHOD(explicit LPSolver(LPSolverType solver_type))
@@ -159,11 +165,27 @@ public:
     LP_METHOD(void set_objective_coefficient(int index, double coefficient))
     LP_METHOD(void set_constraint_lower_bound(int index, double bound))
     LP_METHOD(void set_constraint_upper_bound(int index, double bound))
+    /*
+      Set the lower bounds of several constraints at once. Bounds that
+      already have the given value are skipped, and the remaining ones are
+      passed to the solver in a single call.
+    */
+    LP_METHOD(void set_constraint_lower_bounds(
+                  const std::vector<int> &indices,
+                  const std::vector<double> &bounds))
     LP_METHOD(void set_variable_lower_bound(int index, double bound))
     LP_METHOD(void set_variable_upper_bound(int index, double bound))
 
     LP_METHOD(void set_mip_gap(double gap))
 
+    /*
+      With warm starts (the default), solve() reoptimizes from the basis of
+      the previous call, which is usually much cheaper than solving from
+      scratch if only few bounds or temporary constraints changed. Without
+      them, every call starts from the slack basis.
+    */
+    LP_METHOD(void set_use_warm_start(bool use_warm_start))
+
     LP_METHOD(void solve())
     LP_METHOD(void write_lp(const std::string &filename) const)
     LP_METHOD(void print_failure_analysis() const)
@@ -197,6 +219,8 @@ public:
     LP_METHOD(int get_num_variables() const)
     LP_METHOD(int get_num_constraints() const)
     LP_METHOD(int has_temporary_constraints() const)
+    LP_METHOD(int64_t get_num_solves() const)
+    LP_METHOD(int64_t get_num_simplex_iterations() const)
     LP_METHOD(void print_statistics() const)
 };
 #ifdef __GNUG__
@@ -87,25 +87,17 @@ MergeAndShrinkRepresentationMerge::MergeAndShrinkRepresentationMerge(
                                    right_child_->get_domain_size()),
       left_child(move(left_child_)),
       right_child(move(right_child_)),
-      lookup_table(left_child->get_domain_size(),
-                   vector<int>(right_child->get_domain_size())) {
-    int counter = 0;
-    for (vector<int> &row : lookup_table) {
-        for (int &entry : row) {
-            entry = counter;
-            ++counter;
-        }
-    }
+      num_right_values(right_child->get_domain_size()),
+      lookup_table(domain_size) {
+    iota(lookup_table.begin(), lookup_table.end(), 0);
 }
 
 void MergeAndShrinkRepresentationMerge::set_distances(
     const Distances &distances) {
     assert(distances.are_goal_distances_computed());
-    for (vector<int> &row : lookup_table) {
-        for (int &entry : row) {
-            if (entry != PRUNED_STATE) {
-                entry = distances.get_goal_distance(entry);
-            }
+    for (int &entry : lookup_table) {
+        if (entry != PRUNED_STATE) {
+            entry = distances.get_goal_distance(entry);
         }
     }
 }
@@ -113,12 +105,10 @@ void MergeAndShrinkRepresentationMerge::set_distances(
 void MergeAndShrinkRepresentationMerge::apply_abstraction_to_lookup_table(
     const vector<int> &abstraction_mapping) {
     int new_domain_size = 0;
-    for (vector<int> &row : lookup_table) {
-        for (int &entry : row) {
-            if (entry != PRUNED_STATE) {
-                entry = abstraction_mapping[entry];
-                new_domain_size = max(new_domain_size, entry + 1);
-            }
+    for (int &entry : lookup_table) {
+        if (entry != PRUNED_STATE) {
+            entry = abstraction_mapping[entry];
+            new_domain_size = max(new_domain_size, entry + 1);
         }
     }
     domain_size = new_domain_size;
@@ -127,18 +117,18 @@ void MergeAndShrinkRepresentationMerge::apply_abstraction_to_lookup_table(
 int MergeAndShrinkRepresentationMerge::get_value(
     const State &state) const {
     int state1 = left_child->get_value(state);
+    if (state1 == PRUNED_STATE)
+        return PRUNED_STATE;
     int state2 = right_child->get_value(state);
-    if (state1 == PRUNED_STATE || state2 == PRUNED_STATE)
+    if (state2 == PRUNED_STATE)
         return PRUNED_STATE;
-    return lookup_table[state1][state2];
+    return lookup_table[state1 * num_right_values + state2];
 }
 
 bool MergeAndShrinkRepresentationMerge::is_total() const {
-    for (const vector<int> &row : lookup_table) {
-        for (int entry : row) {
-            if (entry == PRUNED_STATE) {
-                return false;
-            }
+    for (int entry : lookup_table) {
+        if (entry == PRUNED_STATE) {
+            return false;
         }
     }
     return left_child->is_total() && right_child->is_total();
@@ -146,11 +136,11 @@ bool MergeAndShrinkRepresentationMerge::is_total() const {
 
 void MergeAndShrinkRepresentationMerge::dump(utils::LogProxy &log) const {
     log << "lookup table (merge): " << endl;
-    for (const auto &row : lookup_table) {
-        for (const auto &value : row) {
-            log << value << ", ";
+    for (size_t i = 0; i < lookup_table.size(); ++i) {
+        log << lookup_table[i] << ", ";
+        if ((static_cast<int>(i) + 1) % num_right_values == 0) {
+            log << endl;
         }
-        log << endl;
     }
     log << "left child:" << endl;
     left_child->dump(log);
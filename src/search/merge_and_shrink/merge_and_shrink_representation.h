@@ -60,7 +60,14 @@ public:
 class MergeAndShrinkRepresentationMerge : public MergeAndShrinkRepresentation {
     std::unique_ptr<MergeAndShrinkRepresentation> left_child;
     std::unique_ptr<MergeAndShrinkRepresentation> right_child;
-    std::vector<std::vector<int>> lookup_table;
+    /*
+      The children are not modified after merging, so the table has a fixed
+      number of columns (the domain size of the right child). It is stored
+      in row-major order in a single vector: the entry for the pair of child
+      values (left, right) is lookup_table[left * num_right_values + right].
+    */
+    int num_right_values;
+    std::vector<int> lookup_table;
 public:
     MergeAndShrinkRepresentationMerge(
         std::unique_ptr<MergeAndShrinkRepresentation> left_child,
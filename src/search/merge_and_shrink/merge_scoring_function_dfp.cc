@@ -7,15 +7,23 @@
 #include "transition_system.h"
 
 #include "../options/option_parser.h"
+#include "../options/options.h"
 #include "../options/plugin.h"
 
+#include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
 
 #include <cassert>
 
 using namespace std;
 
 namespace merge_and_shrink {
+MergeScoringFunctionDFP::MergeScoringFunctionDFP(
+    const options::Options &options)
+    : num_threads(utils::get_num_threads_from_options(options)) {
+}
+
 vector<int> MergeScoringFunctionDFP::compute_label_ranks(
     const FactoredTransitionSystem &fts, int index) const {
     const TransitionSystem &ts = fts.get_transition_system(index);
@@ -66,36 +74,50 @@ vector<double> MergeScoringFunctionDFP::compute_scores(
     const vector<pair<int, int>> &merge_candidates) {
     int num_ts = fts.get_size();
 
+    vector<bool> is_candidate_ts(num_ts, false);
+    for (pair<int, int> merge_candidate : merge_candidates) {
+        is_candidate_ts[merge_candidate.first] = true;
+        is_candidate_ts[merge_candidate.second] = true;
+    }
+    vector<int> candidate_ts_indices;
+    for (int ts_index = 0; ts_index < num_ts; ++ts_index) {
+        if (is_candidate_ts[ts_index]) {
+            candidate_ts_indices.push_back(ts_index);
+        }
+    }
+
     vector<vector<int>> transition_system_label_ranks(num_ts);
-    vector<double> scores;
-    scores.reserve(merge_candidates.size());
+    utils::parallel_for(
+        num_threads, candidate_ts_indices.size(),
+        [&](int i) {
+            int ts_index = candidate_ts_indices[i];
+            transition_system_label_ranks[ts_index] =
+                compute_label_ranks(fts, ts_index);
+        });
 
     // Go over all pairs of transition systems and compute their weight.
-    for (pair<int, int> merge_candidate : merge_candidates) {
-        int ts_index1 = merge_candidate.first;
-        int ts_index2 = merge_candidate.second;
-
-        vector<int> &label_ranks1 = transition_system_label_ranks[ts_index1];
-        if (label_ranks1.empty()) {
-            label_ranks1 = compute_label_ranks(fts, ts_index1);
-        }
-        vector<int> &label_ranks2 = transition_system_label_ranks[ts_index2];
-        if (label_ranks2.empty()) {
-            label_ranks2 = compute_label_ranks(fts, ts_index2);
-        }
-        assert(label_ranks1.size() == label_ranks2.size());
-
-        // Compute the weight associated with this pair
-        int pair_weight = INF;
-        for (size_t i = 0; i < label_ranks1.size(); ++i) {
-            if (label_ranks1[i] != -1 && label_ranks2[i] != -1) {
-                // label is relevant in both transition_systems
-                int max_label_rank = max(label_ranks1[i], label_ranks2[i]);
-                pair_weight = min(pair_weight, max_label_rank);
+    int num_candidates = merge_candidates.size();
+    vector<double> scores(num_candidates);
+    utils::parallel_for(
+        num_threads, num_candidates,
+        [&](int candidate_index) {
+            const vector<int> &label_ranks1 =
+                transition_system_label_ranks[merge_candidates[candidate_index].first];
+            const vector<int> &label_ranks2 =
+                transition_system_label_ranks[merge_candidates[candidate_index].second];
+            assert(label_ranks1.size() == label_ranks2.size());
+
+            // Compute the weight associated with this pair
+            int pair_weight = INF;
+            for (size_t i = 0; i < label_ranks1.size(); ++i) {
+                if (label_ranks1[i] != -1 && label_ranks2[i] != -1) {
+                    // label is relevant in both transition_systems
+                    int max_label_rank = max(label_ranks1[i], label_ranks2[i]);
+                    pair_weight = min(pair_weight, max_label_rank);
+                }
             }
-        }
-        scores.push_back(pair_weight);
-    }
+            scores[candidate_index] = pair_weight;
+        });
     return scores;
 }
 
@@ -103,6 +125,11 @@ string MergeScoringFunctionDFP::name() const {
     return "dfp";
 }
 
+void MergeScoringFunctionDFP::dump_function_specific_options(
+    utils::LogProxy &log) const {
+    log << "Number of threads: " << num_threads << endl;
+}
+
 static shared_ptr<MergeScoringFunction>_parse(options::OptionParser &parser) {
     parser.document_synopsis(
         "DFP scoring",
@@ -129,11 +156,13 @@ static shared_ptr<MergeScoringFunction>_parse(options::OptionParser &parser) {
         "atomic_before_product=true)])),shrink_strategy=shrink_bisimulation("
         "greedy=false),label_reduction=exact(before_shrinking=true,"
         "before_merging=false),max_states=50000,threshold_before_merge=1)\n}}}");
+    utils::add_num_threads_option_to_parser(parser);
 
+    options::Options options = parser.parse();
     if (parser.dry_run())
         return nullptr;
 
-    return make_shared<MergeScoringFunctionDFP>();
+    return make_shared<MergeScoringFunctionDFP>(options);
 }
 
 static options::Plugin<MergeScoringFunction> _plugin("dfp", _parse);
@@ -3,15 +3,30 @@
 
 #include "merge_scoring_function.h"
 
+namespace options {
+class Options;
+}
+
 namespace merge_and_shrink {
 class MergeScoringFunctionDFP : public MergeScoringFunction {
+    // Number of threads for computing label ranks and scores.
+    const int num_threads;
+
     std::vector<int> compute_label_ranks(
         const FactoredTransitionSystem &fts, int index) const;
 protected:
     virtual std::string name() const override;
+    virtual void dump_function_specific_options(
+        utils::LogProxy &log) const override;
 public:
-    MergeScoringFunctionDFP() = default;
+    explicit MergeScoringFunctionDFP(const options::Options &options);
     virtual ~MergeScoringFunctionDFP() override = default;
+    /*
+      The label ranks of all transition systems occurring in merge_candidates
+      are computed first, then all candidates are scored. Both steps are
+      independent per transition system or candidate and use num_threads
+      threads.
+    */
     virtual std::vector<double> compute_scores(
         const FactoredTransitionSystem &fts,
         const std::vector<std::pair<int, int>> &merge_candidates) override;
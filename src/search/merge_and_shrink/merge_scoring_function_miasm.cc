@@ -13,6 +13,7 @@
 
 #include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
 
 using namespace std;
 
@@ -23,50 +24,54 @@ MergeScoringFunctionMIASM::MergeScoringFunctionMIASM(
       max_states(options.get<int>("max_states")),
       max_states_before_merge(options.get<int>("max_states_before_merge")),
       shrink_threshold_before_merge(options.get<int>("threshold_before_merge")),
+      num_threads(utils::get_num_threads_from_options(options)),
       silent_log(utils::get_silent_log()) {
 }
 
 vector<double> MergeScoringFunctionMIASM::compute_scores(
     const FactoredTransitionSystem &fts,
     const vector<pair<int, int>> &merge_candidates) {
-    vector<double> scores;
-    scores.reserve(merge_candidates.size());
-    for (pair<int, int> merge_candidate : merge_candidates) {
-        int index1 = merge_candidate.first;
-        int index2 = merge_candidate.second;
-        unique_ptr<TransitionSystem> product = shrink_before_merge_externally(
-            fts,
-            index1,
-            index2,
-            *shrink_strategy,
-            max_states,
-            max_states_before_merge,
-            shrink_threshold_before_merge,
-            silent_log);
-
-        // Compute distances for the product and count the alive states.
-        unique_ptr<Distances> distances = utils::make_unique_ptr<Distances>(*product);
-        const bool compute_init_distances = true;
-        const bool compute_goal_distances = true;
-        distances->compute_distances(compute_init_distances, compute_goal_distances, silent_log);
-        int num_states = product->get_size();
-        int alive_states_count = 0;
-        for (int state = 0; state < num_states; ++state) {
-            if (distances->get_init_distance(state) != INF &&
-                distances->get_goal_distance(state) != INF) {
-                ++alive_states_count;
+    int num_candidates = merge_candidates.size();
+    vector<double> scores(num_candidates);
+    int num_scoring_threads = shrink_strategy->uses_rng() ? 1 : num_threads;
+    utils::parallel_for(
+        num_scoring_threads, num_candidates,
+        [&](int candidate_index) {
+            int index1 = merge_candidates[candidate_index].first;
+            int index2 = merge_candidates[candidate_index].second;
+            utils::LogProxy log(silent_log);
+            unique_ptr<TransitionSystem> product = shrink_before_merge_externally(
+                fts,
+                index1,
+                index2,
+                *shrink_strategy,
+                max_states,
+                max_states_before_merge,
+                shrink_threshold_before_merge,
+                log);
+
+            // Compute distances for the product and count the alive states.
+            unique_ptr<Distances> distances = utils::make_unique_ptr<Distances>(*product);
+            const bool compute_init_distances = true;
+            const bool compute_goal_distances = true;
+            distances->compute_distances(compute_init_distances, compute_goal_distances, log);
+            int num_states = product->get_size();
+            int alive_states_count = 0;
+            for (int state = 0; state < num_states; ++state) {
+                if (distances->get_init_distance(state) != INF &&
+                    distances->get_goal_distance(state) != INF) {
+                    ++alive_states_count;
+                }
             }
-        }
-
-        /*
-          Compute the score as the ratio of alive states of the product
-          compared to the number of states of the full product.
-        */
-        assert(num_states);
-        double score = static_cast<double>(alive_states_count) /
-            static_cast<double>(num_states);
-        scores.push_back(score);
-    }
+
+            /*
+              Compute the score as the ratio of alive states of the product
+              compared to the number of states of the full product.
+            */
+            assert(num_states);
+            scores[candidate_index] = static_cast<double>(alive_states_count) /
+                static_cast<double>(num_states);
+        });
     return scores;
 }
 
@@ -74,6 +79,11 @@ string MergeScoringFunctionMIASM::name() const {
     return "miasm";
 }
 
+void MergeScoringFunctionMIASM::dump_function_specific_options(
+    utils::LogProxy &log) const {
+    log << "Number of threads: " << num_threads << endl;
+}
+
 static shared_ptr<MergeScoringFunction>_parse(options::OptionParser &parser) {
     parser.document_synopsis(
         "MIASM",
@@ -127,6 +137,7 @@ static shared_ptr<MergeScoringFunction>_parse(options::OptionParser &parser) {
         "We recommend setting this to match the shrink strategy configuration "
         "given to {{{merge_and_shrink}}}, see note below.");
     add_transition_system_size_limit_options_to_parser(parser);
+    utils::add_num_threads_option_to_parser(parser);
 
     options::Options options = parser.parse();
     if (parser.help_mode()) {
@@ -14,12 +14,21 @@ class MergeScoringFunctionMIASM : public MergeScoringFunction {
     const int max_states;
     const int max_states_before_merge;
     const int shrink_threshold_before_merge;
+    // Number of threads for scoring candidates; see compute_scores.
+    const int num_threads;
     utils::LogProxy silent_log;
 protected:
     virtual std::string name() const override;
+    virtual void dump_function_specific_options(
+        utils::LogProxy &log) const override;
 public:
     explicit MergeScoringFunctionMIASM(const options::Options &options);
     virtual ~MergeScoringFunctionMIASM() override = default;
+    /*
+      Candidates are scored independently with num_threads threads, unless
+      the shrink strategy uses randomization, in which case they are scored
+      sequentially to keep the scores reproducible.
+    */
     virtual std::vector<double> compute_scores(
         const FactoredTransitionSystem &fts,
         const std::vector<std::pair<int, int>> &merge_candidates) override;
@@ -58,6 +58,11 @@ public:
         const Distances &distances,
         int target_size,
         utils::LogProxy &log) const override;
+
+    virtual bool uses_rng() const override {
+        return true;
+    }
+
     static void add_options_to_parser(options::OptionParser &parser);
 };
 }
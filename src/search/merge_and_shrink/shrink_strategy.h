@@ -44,6 +44,15 @@ public:
     virtual bool requires_init_distances() const = 0;
     virtual bool requires_goal_distances() const = 0;
 
+    /*
+      Return true iff compute_equivalence_relation draws from a random number
+      generator. Such strategies must not be called concurrently, as the
+      result would depend on the order of the calls.
+    */
+    virtual bool uses_rng() const {
+        return false;
+    }
+
     void dump_options(utils::LogProxy &log) const;
     std::string get_name() const;
 };
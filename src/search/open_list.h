@@ -2,10 +2,14 @@
 #define OPEN_LIST_H
 
 #include <set>
+#include <vector>
 
 #include "evaluation_context.h"
 #include "operator_id.h"
 
+#include "utils/profiling.h"
+#include "utils/system.h"
+
 class StateID;
 
 
@@ -55,6 +59,18 @@ public:
     // Return true if the open list is empty.
     virtual bool empty() const = 0;
 
+    /*
+      Return the primary key (the value of the first evaluator) of the
+      entry that remove_min would return, without removing it. The
+      open list must not be empty.
+
+      The default implementation aborts. Open lists that order their
+      entries by a sequence of evaluator values can support this
+      cheaply; it is used by K* to compare the f-value of the next A*
+      expansion against the Eppstein queue.
+    */
+    virtual int get_min_primary_key();
+
     /*
       Remove all elements from the open list.
 
@@ -90,6 +106,14 @@ public:
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) = 0;
 
+    /*
+      Append all evaluators that this open list uses (directly or
+      indirectly) to the result vector, skipping those that are already
+      contained.
+    */
+    virtual void get_involved_evaluators(
+        std::vector<Evaluator *> &evals) = 0;
+
     /*
       Accessor method for only_preferred.
 
@@ -138,6 +162,11 @@ OpenList<Entry>::OpenList(bool only_preferred)
     : only_preferred(only_preferred) {
 }
 
+template<class Entry>
+int OpenList<Entry>::get_min_primary_key() {
+    ABORT("This open list does not support get_min_primary_key.");
+}
+
 template<class Entry>
 void OpenList<Entry>::boost_preferred() {
 }
@@ -145,6 +174,7 @@ void OpenList<Entry>::boost_preferred() {
 template<class Entry>
 void OpenList<Entry>::insert(
     EvaluationContext &eval_context, const Entry &entry) {
+    PROFILE_SCOPE("open list insertion");
     if (only_preferred && !eval_context.is_preferred())
         return;
     if (!is_dead_end(eval_context))
@@ -42,9 +42,11 @@ public:
     virtual ~TieBreakingOpenList() override = default;
 
     virtual Entry remove_min() override;
+    virtual int get_min_primary_key() override;
     virtual bool empty() const override;
     virtual void clear() override;
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual void get_involved_evaluators(vector<Evaluator *> &evals) override;
     virtual bool is_dead_end(
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
@@ -86,6 +88,12 @@ Entry TieBreakingOpenList<Entry>::remove_min() {
     return result;
 }
 
+template<class Entry>
+int TieBreakingOpenList<Entry>::get_min_primary_key() {
+    assert(size > 0);
+    return buckets.begin()->first[0];
+}
+
 template<class Entry>
 bool TieBreakingOpenList<Entry>::empty() const {
     return size == 0;
@@ -109,6 +117,13 @@ void TieBreakingOpenList<Entry>::get_path_dependent_evaluators(
         evaluator->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+void TieBreakingOpenList<Entry>::get_involved_evaluators(
+    vector<Evaluator *> &evals) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        evaluator->get_involved_evaluators(evals);
+}
+
 template<class Entry>
 bool TieBreakingOpenList<Entry>::is_dead_end(
     EvaluationContext &eval_context) const {
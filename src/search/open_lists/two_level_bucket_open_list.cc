@@ -0,0 +1,312 @@
+#include "two_level_bucket_open_list.h"
+
+#include "../evaluator.h"
+#include "../open_list.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../utils/memory.h"
+
+#include <cassert>
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace two_level_bucket_open_list {
+/*
+  Entries whose keys are at least this large (or negative) are stored in
+  a map instead of the bucket vectors to bound the size of the vectors.
+*/
+static const int MAX_BUCKET_KEY = 1 << 14;
+
+template<class Entry>
+class TwoLevelBucketOpenList : public OpenList<Entry> {
+    using Key = pair<int, int>;
+
+    /*
+      FIFO queue that keeps its memory when it runs empty, so refilling
+      a bucket does not allocate.
+    */
+    struct Bucket {
+        vector<Entry> entries;
+        size_t next;
+
+        Bucket() : next(0) {
+        }
+    };
+
+    /*
+      Buckets with the same primary key, indexed by the secondary key.
+      All buckets with a secondary key below min_key are empty.
+    */
+    struct Level {
+        vector<Bucket> buckets;
+        int min_key;
+        int size;
+
+        Level() : min_key(0), size(0) {
+        }
+    };
+
+    // Levels indexed by the primary key. All levels below min_key are empty.
+    vector<Level> levels;
+    int min_key;
+    int num_bucket_entries;
+
+    // Entries with keys outside of [0, MAX_BUCKET_KEY).
+    map<Key, deque<Entry>> overflow_buckets;
+    int size;
+
+    shared_ptr<Evaluator> primary_evaluator;
+    shared_ptr<Evaluator> secondary_evaluator;
+    /*
+      If allow_unsafe_pruning is true, we ignore (don't insert) states
+      which the primary evaluator considers a dead end, even if it is
+      not a safe heuristic.
+    */
+    bool allow_unsafe_pruning;
+
+    static bool is_bucket_key(const Key &key);
+    Key get_min_bucket_key();
+    bool overflow_bucket_is_min();
+    Entry remove_from_buckets(const Key &key);
+    Entry remove_from_overflow_buckets();
+
+protected:
+    virtual void do_insertion(EvaluationContext &eval_context,
+                              const Entry &entry) override;
+
+public:
+    explicit TwoLevelBucketOpenList(const Options &opts);
+    virtual ~TwoLevelBucketOpenList() override = default;
+
+    virtual Entry remove_min() override;
+    virtual int get_min_primary_key() override;
+    virtual bool empty() const override;
+    virtual void clear() override;
+    virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual void get_involved_evaluators(vector<Evaluator *> &evals) override;
+    virtual bool is_dead_end(
+        EvaluationContext &eval_context) const override;
+    virtual bool is_reliable_dead_end(
+        EvaluationContext &eval_context) const override;
+};
+
+
+template<class Entry>
+TwoLevelBucketOpenList<Entry>::TwoLevelBucketOpenList(const Options &opts)
+    : OpenList<Entry>(opts.get<bool>("pref_only")),
+      min_key(0),
+      num_bucket_entries(0),
+      size(0),
+      primary_evaluator(opts.get<shared_ptr<Evaluator>>("primary")),
+      secondary_evaluator(opts.get<shared_ptr<Evaluator>>("secondary")),
+      allow_unsafe_pruning(opts.get<bool>("unsafe_pruning")) {
+}
+
+template<class Entry>
+bool TwoLevelBucketOpenList<Entry>::is_bucket_key(const Key &key) {
+    return key.first >= 0 && key.first < MAX_BUCKET_KEY &&
+           key.second >= 0 && key.second < MAX_BUCKET_KEY;
+}
+
+template<class Entry>
+void TwoLevelBucketOpenList<Entry>::do_insertion(
+    EvaluationContext &eval_context, const Entry &entry) {
+    Key key(
+        eval_context.get_evaluator_value_or_infinity(primary_evaluator.get()),
+        eval_context.get_evaluator_value_or_infinity(secondary_evaluator.get()));
+    ++size;
+    if (!is_bucket_key(key)) {
+        overflow_buckets[key].push_back(entry);
+        return;
+    }
+
+    if (key.first >= static_cast<int>(levels.size()))
+        levels.resize(key.first + 1);
+    Level &level = levels[key.first];
+    if (key.second >= static_cast<int>(level.buckets.size()))
+        level.buckets.resize(key.second + 1);
+    level.buckets[key.second].entries.push_back(entry);
+
+    if (level.size == 0 || key.second < level.min_key)
+        level.min_key = key.second;
+    ++level.size;
+    if (num_bucket_entries == 0 || key.first < min_key)
+        min_key = key.first;
+    ++num_bucket_entries;
+}
+
+template<class Entry>
+typename TwoLevelBucketOpenList<Entry>::Key
+TwoLevelBucketOpenList<Entry>::get_min_bucket_key() {
+    assert(num_bucket_entries > 0);
+    while (levels[min_key].size == 0)
+        ++min_key;
+    Level &level = levels[min_key];
+    while (level.buckets[level.min_key].entries.empty())
+        ++level.min_key;
+    return Key(min_key, level.min_key);
+}
+
+template<class Entry>
+Entry TwoLevelBucketOpenList<Entry>::remove_from_buckets(const Key &key) {
+    Level &level = levels[key.first];
+    Bucket &bucket = level.buckets[key.second];
+    assert(bucket.next < bucket.entries.size());
+    Entry result = bucket.entries[bucket.next++];
+    if (bucket.next == bucket.entries.size()) {
+        bucket.entries.clear();
+        bucket.next = 0;
+    }
+    --level.size;
+    --num_bucket_entries;
+    return result;
+}
+
+template<class Entry>
+Entry TwoLevelBucketOpenList<Entry>::remove_from_overflow_buckets() {
+    auto it = overflow_buckets.begin();
+    assert(it != overflow_buckets.end());
+    deque<Entry> &bucket = it->second;
+    assert(!bucket.empty());
+    Entry result = bucket.front();
+    bucket.pop_front();
+    if (bucket.empty())
+        overflow_buckets.erase(it);
+    return result;
+}
+
+template<class Entry>
+bool TwoLevelBucketOpenList<Entry>::overflow_bucket_is_min() {
+    if (num_bucket_entries == 0)
+        return true;
+    return !overflow_buckets.empty() &&
+           overflow_buckets.begin()->first < get_min_bucket_key();
+}
+
+template<class Entry>
+Entry TwoLevelBucketOpenList<Entry>::remove_min() {
+    assert(size > 0);
+    --size;
+    if (overflow_bucket_is_min())
+        return remove_from_overflow_buckets();
+    return remove_from_buckets(get_min_bucket_key());
+}
+
+template<class Entry>
+int TwoLevelBucketOpenList<Entry>::get_min_primary_key() {
+    assert(size > 0);
+    if (overflow_bucket_is_min())
+        return overflow_buckets.begin()->first.first;
+    return get_min_bucket_key().first;
+}
+
+template<class Entry>
+bool TwoLevelBucketOpenList<Entry>::empty() const {
+    return size == 0;
+}
+
+template<class Entry>
+void TwoLevelBucketOpenList<Entry>::clear() {
+    levels.clear();
+    min_key = 0;
+    num_bucket_entries = 0;
+    overflow_buckets.clear();
+    size = 0;
+}
+
+template<class Entry>
+void TwoLevelBucketOpenList<Entry>::get_path_dependent_evaluators(
+    set<Evaluator *> &evals) {
+    primary_evaluator->get_path_dependent_evaluators(evals);
+    secondary_evaluator->get_path_dependent_evaluators(evals);
+}
+
+template<class Entry>
+void TwoLevelBucketOpenList<Entry>::get_involved_evaluators(
+    vector<Evaluator *> &evals) {
+    primary_evaluator->get_involved_evaluators(evals);
+    secondary_evaluator->get_involved_evaluators(evals);
+}
+
+template<class Entry>
+bool TwoLevelBucketOpenList<Entry>::is_dead_end(
+    EvaluationContext &eval_context) const {
+    // Same semantics as for the tie-breaking open list.
+    if (is_reliable_dead_end(eval_context))
+        return true;
+    bool primary_infinite =
+        eval_context.is_evaluator_value_infinite(primary_evaluator.get());
+    if (allow_unsafe_pruning && primary_infinite)
+        return true;
+    return primary_infinite &&
+           eval_context.is_evaluator_value_infinite(secondary_evaluator.get());
+}
+
+template<class Entry>
+bool TwoLevelBucketOpenList<Entry>::is_reliable_dead_end(
+    EvaluationContext &eval_context) const {
+    for (Evaluator *evaluator :
+         {primary_evaluator.get(), secondary_evaluator.get()}) {
+        if (eval_context.is_evaluator_value_infinite(evaluator) &&
+            evaluator->dead_ends_are_reliable())
+            return true;
+    }
+    return false;
+}
+
+TwoLevelBucketOpenListFactory::TwoLevelBucketOpenListFactory(
+    const Options &options)
+    : options(options) {
+}
+
+unique_ptr<StateOpenList>
+TwoLevelBucketOpenListFactory::create_state_open_list() {
+    return utils::make_unique_ptr<TwoLevelBucketOpenList<StateOpenListEntry>>(options);
+}
+
+unique_ptr<EdgeOpenList>
+TwoLevelBucketOpenListFactory::create_edge_open_list() {
+    return utils::make_unique_ptr<TwoLevelBucketOpenList<EdgeOpenListEntry>>(options);
+}
+
+static shared_ptr<OpenListFactory> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Two-level bucket open list",
+        "Open list that orders entries by the values of two evaluators "
+        "lexicographically and uses FIFO tiebreaking. It orders entries "
+        "like {{{tiebreaking([primary, secondary])}}}.");
+    parser.document_note(
+        "Implementation Notes",
+        "Entries are stored in buckets indexed directly by the pair of "
+        "evaluator values, and the open list remembers a lower bound on the "
+        "smallest non-empty bucket. Inserting an entry takes constant "
+        "amortized time and removing the minimum takes constant amortized "
+        "time as long as the minimum key does not decrease often, as in A* "
+        "with a consistent heuristic. Buckets reuse their memory. Entries "
+        "with negative, infinite or very large values are kept in a "
+        "map-based fallback.");
+    parser.add_option<shared_ptr<Evaluator>>("primary", "primary evaluator");
+    parser.add_option<shared_ptr<Evaluator>>(
+        "secondary", "evaluator for breaking ties among equal primary values");
+    parser.add_option<bool>(
+        "pref_only",
+        "insert only nodes generated by preferred operators", "false");
+    parser.add_option<bool>(
+        "unsafe_pruning",
+        "allow unsafe pruning when the primary evaluator regards a state a "
+        "dead end",
+        "true");
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<TwoLevelBucketOpenListFactory>(opts);
+}
+
+static Plugin<OpenListFactory> _plugin("two_level_buckets", _parse);
+}
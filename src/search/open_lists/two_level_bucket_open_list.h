@@ -0,0 +1,28 @@
+#ifndef OPEN_LISTS_TWO_LEVEL_BUCKET_OPEN_LIST_H
+#define OPEN_LISTS_TWO_LEVEL_BUCKET_OPEN_LIST_H
+
+#include "../open_list_factory.h"
+#include "../option_parser_util.h"
+
+
+/*
+  Open list indexed by two non-negative ints (usually f and h), ordered
+  lexicographically and using FIFO tie-breaking. It orders entries
+  exactly like a tie-breaking open list with two evaluators.
+
+  Implemented as a vector of vectors of buckets indexed by the two keys.
+*/
+
+namespace two_level_bucket_open_list {
+class TwoLevelBucketOpenListFactory : public OpenListFactory {
+    Options options;
+public:
+    explicit TwoLevelBucketOpenListFactory(const Options &options);
+    virtual ~TwoLevelBucketOpenListFactory() override = default;
+
+    virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
+    virtual std::unique_ptr<EdgeOpenList> create_edge_open_list() override;
+};
+}
+
+#endif
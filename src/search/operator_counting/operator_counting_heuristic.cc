@@ -5,6 +5,7 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../utils/logging.h"
 #include "../utils/markup.h"
 
 #include <cmath>
@@ -19,6 +20,7 @@ OperatorCountingHeuristic::OperatorCountingHeuristic(const Options &opts)
       lp_solver(opts.get<lp::LPSolverType>("lpsolver")),
       use_integer_operator_counts(opts.get<bool>("use_integer_operator_counts")) {
     lp_solver.set_mip_gap(0);
+    lp_solver.set_use_warm_start(opts.get<bool>("warm_start"));
     named_vector::NamedVector<lp::LPVariable> variables;
     double infinity = lp_solver.get_infinity();
     for (OperatorProxy op : task_proxy.get_operators()) {
@@ -32,7 +34,9 @@ OperatorCountingHeuristic::OperatorCountingHeuristic(const Options &opts)
     lp_solver.load_problem(lp);
 }
 
-OperatorCountingHeuristic::~OperatorCountingHeuristic() {
+void OperatorCountingHeuristic::print_statistics() const {
+    utils::g_log << "Operator-counting LP statistics:" << endl;
+    lp_solver.print_statistics();
 }
 
 int OperatorCountingHeuristic::compute_heuristic(const State &ancestor_state) {
@@ -110,6 +114,14 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "increase the runtime.",
         "false");
 
+    parser.add_option<bool>(
+        "warm_start",
+        "reoptimize each LP from the basis of the previously solved LP. "
+        "Consecutive states usually share most bounds, so this saves most "
+        "simplex iterations. Turn this off to compare the numbers of simplex "
+        "iterations reported at the end of the search.",
+        "true");
+
     lp::add_lp_solver_option_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
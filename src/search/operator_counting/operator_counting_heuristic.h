@@ -23,7 +23,8 @@ protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     explicit OperatorCountingHeuristic(const options::Options &opts);
-    ~OperatorCountingHeuristic();
+
+    virtual void print_statistics() const override;
 };
 }
 
@@ -53,6 +53,8 @@ void PhOConstraints::initialize_constraints(
 bool PhOConstraints::update_constraints(const State &state,
                                         lp::LPSolver &lp_solver) {
     state.unpack();
+    constraint_indices.clear();
+    lower_bounds.clear();
     for (size_t i = 0; i < pdbs->size(); ++i) {
         int constraint_id = constraint_offset + i;
         shared_ptr<pdbs::PatternDatabase> pdb = (*pdbs)[i];
@@ -60,8 +62,10 @@ bool PhOConstraints::update_constraints(const State &state,
         if (h == numeric_limits<int>::max()) {
             return true;
         }
-        lp_solver.set_constraint_lower_bound(constraint_id, h);
+        constraint_indices.push_back(constraint_id);
+        lower_bounds.push_back(h);
     }
+    lp_solver.set_constraint_lower_bounds(constraint_indices, lower_bounds);
     return false;
 }
 
@@ -8,6 +8,7 @@
 #include "../pdbs/types.h"
 
 #include <memory>
+#include <vector>
 
 namespace options {
 class Options;
@@ -23,6 +24,8 @@ class PhOConstraints : public ConstraintGenerator {
 
     int constraint_offset;
     std::shared_ptr<pdbs::PDBCollection> pdbs;
+    std::vector<int> constraint_indices;
+    std::vector<double> lower_bounds;
 public:
     explicit PhOConstraints(const options::Options &opts);
 
@@ -87,6 +87,8 @@ void StateEquationConstraints::initialize_constraints(
 bool StateEquationConstraints::update_constraints(const State &state,
                                                   lp::LPSolver &lp_solver) {
     // Compute the bounds for the rows in the LP.
+    constraint_indices.clear();
+    lower_bounds.clear();
     for (size_t var = 0; var < propositions.size(); ++var) {
         int num_values = propositions[var].size();
         for (int value = 0; value < num_values; ++value) {
@@ -104,11 +106,12 @@ bool StateEquationConstraints::update_constraints(const State &state,
                 if (goal_state[var] == value) {
                     ++lower_bound;
                 }
-                lp_solver.set_constraint_lower_bound(
-                    prop.constraint_index, lower_bound);
+                constraint_indices.push_back(prop.constraint_index);
+                lower_bounds.push_back(lower_bound);
             }
         }
     }
+    lp_solver.set_constraint_lower_bounds(constraint_indices, lower_bounds);
     return false;
 }
 
@@ -4,6 +4,7 @@
 #include "constraint_generator.h"
 
 #include <set>
+#include <vector>
 
 class TaskProxy;
 
@@ -29,6 +30,10 @@ class StateEquationConstraints : public ConstraintGenerator {
     std::vector<std::vector<Proposition>> propositions;
     // Map goal variables to their goal value and other variables to max int.
     std::vector<int> goal_state;
+    /* Indices and lower bounds of all constraints. We keep the vectors
+       around to avoid recreating them in every state. */
+    std::vector<int> constraint_indices;
+    std::vector<double> lower_bounds;
 
     void build_propositions(const TaskProxy &task_proxy);
     void add_constraints(named_vector::NamedVector<lp::LPConstraint> &constraints, double infinity);
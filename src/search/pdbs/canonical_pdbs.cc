@@ -41,4 +41,50 @@ int CanonicalPDBs::get_value(const State &state) const {
     }
     return max_h;
 }
+
+void CanonicalPDBs::get_values(
+    const vector<vector<int>> &values_by_var, vector<int> &h_values) const {
+    assert(!pattern_cliques->empty());
+    assert(!values_by_var.empty());
+    const int infinity = numeric_limits<int>::max();
+    int num_states = values_by_var[0].size();
+    int num_pdbs = pdbs->size();
+
+    /*
+      Dead ends are recorded separately and their PDB values are replaced by
+      0, so that the clique sums below never overflow and need no branches.
+    */
+    vector<bool> is_dead_end(num_states, false);
+    vector<vector<int>> h_values_by_pdb(num_pdbs);
+    for (int pdb_index = 0; pdb_index < num_pdbs; ++pdb_index) {
+        vector<int> &pdb_h_values = h_values_by_pdb[pdb_index];
+        (*pdbs)[pdb_index]->get_values(values_by_var, pdb_h_values);
+        for (int j = 0; j < num_states; ++j) {
+            if (pdb_h_values[j] == infinity) {
+                is_dead_end[j] = true;
+                pdb_h_values[j] = 0;
+            }
+        }
+    }
+
+    h_values.assign(num_states, 0);
+    vector<int> clique_h(num_states);
+    for (const PatternClique &clique : *pattern_cliques) {
+        fill(clique_h.begin(), clique_h.end(), 0);
+        for (PatternID pdb_index : clique) {
+            const int *pdb_h_values = h_values_by_pdb[pdb_index].data();
+            for (int j = 0; j < num_states; ++j) {
+                clique_h[j] += pdb_h_values[j];
+            }
+        }
+        for (int j = 0; j < num_states; ++j) {
+            h_values[j] = max(h_values[j], clique_h[j]);
+        }
+    }
+    for (int j = 0; j < num_states; ++j) {
+        if (is_dead_end[j]) {
+            h_values[j] = infinity;
+        }
+    }
+}
 }
@@ -4,6 +4,7 @@
 #include "types.h"
 
 #include <memory>
+#include <vector>
 
 class State;
 
@@ -19,6 +20,15 @@ public:
     ~CanonicalPDBs() = default;
 
     int get_value(const State &state) const;
+
+    /*
+      Batch version of get_value for states in structure-of-arrays form (see
+      PatternDatabase::get_values). The maximum over the pattern cliques is
+      computed for all states at once.
+    */
+    void get_values(
+        const std::vector<std::vector<int>> &values_by_var,
+        std::vector<int> &h_values) const;
 };
 }
 
@@ -51,6 +51,12 @@ int IncrementalCanonicalPDBs::get_value(const State &state) const {
     return canonical_pdbs.get_value(state);
 }
 
+void IncrementalCanonicalPDBs::get_values(
+    const vector<vector<int>> &values_by_var, vector<int> &h_values) const {
+    CanonicalPDBs canonical_pdbs(pattern_databases, pattern_cliques);
+    canonical_pdbs.get_values(values_by_var, h_values);
+}
+
 bool IncrementalCanonicalPDBs::is_dead_end(const State &state) const {
     state.unpack();
     for (const shared_ptr<PatternDatabase> &pdb : *pattern_databases)
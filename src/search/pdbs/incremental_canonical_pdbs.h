@@ -41,6 +41,11 @@ public:
 
     int get_value(const State &state) const;
 
+    // See CanonicalPDBs::get_values.
+    void get_values(
+        const std::vector<std::vector<int>> &values_by_var,
+        std::vector<int> &h_values) const;
+
     /*
       The following method offers a quick dead-end check for the sampling
       procedure of iPDB-hillclimbing. This exists because we can much more
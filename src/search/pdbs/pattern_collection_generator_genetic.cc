@@ -12,6 +12,7 @@
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
@@ -33,6 +34,7 @@ PatternCollectionGeneratorGenetic::PatternCollectionGeneratorGenetic(
       num_episodes(opts.get<int>("num_episodes")),
       mutation_probability(opts.get<double>("mutation_probability")),
       disjoint_patterns(opts.get<bool>("disjoint")),
+      num_threads(utils::get_num_threads_from_options(opts)),
       rng(utils::parse_rng_from_options(opts)) {
 }
 
@@ -162,13 +164,16 @@ bool PatternCollectionGeneratorGenetic::mark_used_variables(
 
 void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values) {
     TaskProxy task_proxy(*task);
-    for (size_t i = 0; i < pattern_collections.size(); ++i) {
+    int num_pattern_collections = pattern_collections.size();
+    // Valid pattern collections to evaluate; nullptr for invalid ones.
+    vector<shared_ptr<PatternCollection>> valid_pattern_collections(
+        num_pattern_collections);
+    for (int i = 0; i < num_pattern_collections; ++i) {
         const auto &collection = pattern_collections[i];
         if (log.is_at_least_debug()) {
             log << "evaluate pattern collection " << (i + 1) << " of "
                 << pattern_collections.size() << endl;
         }
-        double fitness = 0;
         bool pattern_valid = true;
         vector<bool> variables_used(task_proxy.get_variables().size(), false);
         shared_ptr<PatternCollection> pattern_collection = make_shared<PatternCollection>();
@@ -197,23 +202,36 @@ void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values)
             remove_irrelevant_variables(pattern);
             pattern_collection->push_back(pattern);
         }
-        if (!pattern_valid) {
-            /* Set fitness to a very small value to cover cases in which all
-               patterns are invalid. */
-            fitness = 0.001;
-        } else {
-            /* Generate the pattern collection heuristic and get its fitness
-               value. */
-            ZeroOnePDBs zero_one_pdbs(task_proxy, *pattern_collection);
-            fitness = zero_one_pdbs.compute_approx_mean_finite_h();
-            // Update the best heuristic found so far.
-            if (fitness > best_fitness) {
-                best_fitness = fitness;
-                if (log.is_at_least_normal()) {
-                    log << "best_fitness = " << best_fitness << endl;
-                }
-                best_patterns = pattern_collection;
+        if (pattern_valid) {
+            valid_pattern_collections[i] = pattern_collection;
+        }
+    }
+
+    /* Generate the pattern collection heuristics and get their fitness
+       values. The collections are independent of each other. Invalid
+       collections get a very small value to cover cases in which all
+       patterns are invalid. */
+    vector<double> new_fitness_values(num_pattern_collections, 0.001);
+    utils::parallel_for(
+        num_threads, num_pattern_collections,
+        [&](int i) {
+            if (valid_pattern_collections[i]) {
+                ZeroOnePDBs zero_one_pdbs(
+                    task_proxy, *valid_pattern_collections[i]);
+                new_fitness_values[i] =
+                    zero_one_pdbs.compute_approx_mean_finite_h();
+            }
+        });
+
+    for (int i = 0; i < num_pattern_collections; ++i) {
+        double fitness = new_fitness_values[i];
+        // Update the best heuristic found so far.
+        if (valid_pattern_collections[i] && fitness > best_fitness) {
+            best_fitness = fitness;
+            if (log.is_at_least_normal()) {
+                log << "best_fitness = " << best_fitness << endl;
             }
+            best_patterns = valid_pattern_collections[i];
         }
         fitness_values.push_back(fitness);
     }
@@ -382,6 +400,7 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "fitness) if its patterns are not disjoint",
         "false");
 
+    utils::add_num_threads_option_to_parser(parser);
     utils::add_rng_options(parser);
     add_generator_options_to_parser(parser);
 
@@ -29,6 +29,8 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
     /* Specifies whether patterns in each pattern collection need to be disjoint
        or not. */
     const bool disjoint_patterns;
+    // Number of threads for evaluating the pattern collections.
+    const int num_threads;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     std::shared_ptr<AbstractTask> task;
@@ -73,8 +75,9 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
       only causally relevant variables remain in the patterns. Then the zero one
       partitioning pattern collection heuristic is constructed and its fitness
       ( = summed up mean h-values (dead ends are ignored) of all PDBs in the
-      collection) computed. The overall best heuristic is eventually updated and
-      saved for further episodes.
+      collection) computed. The heuristics of different pattern collections
+      are computed with num_threads threads. The overall best heuristic is
+      eventually updated and saved for further episodes.
     */
     void evaluate(std::vector<double> &fitness_values);
     bool is_pattern_too_large(const Pattern &pattern) const;
@@ -18,11 +18,13 @@
 #include "../utils/markup.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -37,6 +39,11 @@ namespace pdbs {
 class HillClimbingTimeout {
 };
 
+/* Thrown if the PDBs of the candidates do not fit into memory. Only the
+   candidates are lost, so we can keep the current collection. */
+class HillClimbingOutOfMemory {
+};
+
 static vector<int> get_goal_variables(const TaskProxy &task_proxy) {
     vector<int> goal_vars;
     GoalsProxy goals = task_proxy.get_goals();
@@ -120,6 +127,7 @@ PatternCollectionGeneratorHillclimbing::PatternCollectionGeneratorHillclimbing(c
       num_samples(opts.get<int>("num_samples")),
       min_improvement(opts.get<int>("min_improvement")),
       max_time(opts.get<double>("max_time")),
+      num_threads(utils::get_num_threads_from_options(opts)),
       rng(utils::parse_rng_from_options(opts)),
       num_rejected(0),
       hill_climbing_timer(0) {
@@ -133,7 +141,7 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     PDBCollection &candidate_pdbs) {
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
-    int max_pdb_size = 0;
+    PatternCollection new_patterns;
     for (int pattern_var : pattern) {
         assert(utils::in_bounds(pattern_var, relevant_neighbours));
         const vector<int> &connected_vars = relevant_neighbours[pattern_var];
@@ -160,16 +168,31 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                       surpass the size limit.
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        make_shared<PatternDatabase>(task_proxy, new_pattern));
-                    max_pdb_size = max(max_pdb_size,
-                                       candidate_pdbs.back()->get_size());
+                    new_patterns.push_back(move(new_pattern));
                 }
             } else {
                 ++num_rejected;
             }
         }
     }
+
+    int num_new_pdbs = new_patterns.size();
+    PDBCollection new_pdbs(num_new_pdbs);
+    utils::ParallelForStatus status = utils::try_parallel_for(
+        num_threads, num_new_pdbs,
+        [&](int i) {
+            new_pdbs[i] = make_shared<PatternDatabase>(
+                task_proxy, new_patterns[i]);
+        });
+    if (status == utils::ParallelForStatus::OUT_OF_MEMORY) {
+        throw HillClimbingOutOfMemory();
+    }
+
+    int max_pdb_size = 0;
+    for (shared_ptr<PatternDatabase> &new_pdb : new_pdbs) {
+        max_pdb_size = max(max_pdb_size, new_pdb->get_size());
+        candidate_pdbs.push_back(move(new_pdb));
+    }
     return max_pdb_size;
 }
 
@@ -193,7 +216,7 @@ void PatternCollectionGeneratorHillclimbing::sample_states(
 }
 
 pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
-    const vector<State> &samples,
+    const vector<vector<int>> &samples_by_var,
     const vector<int> &samples_h_values,
     PDBCollection &candidate_pdbs) {
     /*
@@ -206,50 +229,92 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     int improvement = 0;
     int best_pdb_index = -1;
 
-    // Iterate over all candidates and search for the best improving pattern/pdb
-    for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
-        const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
-        if (!pdb) {
-            /* candidate pattern is too large or has already been added to
-               the canonical heuristic. */
-            continue;
+    /*
+      The h-values of the samples under the PDBs of the current collection do
+      not depend on the candidate, so we look them up once instead of once per
+      candidate.
+    */
+    const PDBCollection &current_pdb_collection =
+        *current_pdbs->get_pattern_databases();
+    vector<vector<int>> samples_pdb_values(num_samples);
+    vector<int> pdb_h_values;
+    for (const shared_ptr<PatternDatabase> &p : current_pdb_collection) {
+        p->get_values(samples_by_var, pdb_h_values);
+        for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
+            samples_pdb_values[sample_id].push_back(pdb_h_values[sample_id]);
         }
-        /*
-          If a candidate's size added to the current collection's size exceeds
-          the maximum collection size, then forget the pdb.
-        */
-        int combined_size = current_pdbs->get_size() + pdb->get_size();
-        if (combined_size > collection_max_size) {
-            candidate_pdbs[i] = nullptr;
-            continue;
+    }
+    vector<bool> is_dead_end_for_collection(num_samples);
+    for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
+        const vector<int> &pdb_values = samples_pdb_values[sample_id];
+        is_dead_end_for_collection[sample_id] =
+            find(pdb_values.begin(), pdb_values.end(),
+                 numeric_limits<int>::max()) != pdb_values.end();
+    }
+
+    /*
+      If a candidate's size added to the current collection's size exceeds
+      the maximum collection size, then forget the pdb.
+    */
+    for (shared_ptr<PatternDatabase> &pdb : candidate_pdbs) {
+        if (pdb && current_pdbs->get_size() + pdb->get_size() > collection_max_size) {
+            pdb = nullptr;
         }
+    }
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        vector<PatternClique> pattern_cliques =
-            current_pdbs->get_pattern_cliques(pdb->get_pattern());
-        for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
-            const State &sample = samples[sample_id];
-            assert(utils::in_bounds(sample_id, samples_h_values));
-            int h_collection = samples_h_values[sample_id];
-            if (is_heuristic_improved(
-                    *pdb, sample, h_collection,
-                    *current_pdbs->get_pattern_databases(), pattern_cliques)) {
-                ++count;
+    /*
+      Calculate the "counting approximation" for all sample states: count
+      the number of samples for which the current pattern collection
+      heuristic would be improved if the new pattern was included into it.
+    */
+    /*
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    int num_candidates = candidate_pdbs.size();
+    vector<int> counts(num_candidates, 0);
+    atomic<bool> timeout(false);
+    utils::ParallelForStatus status = utils::try_parallel_for(
+        num_threads, num_candidates,
+        [&](int i) {
+            const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
+            if (!pdb) {
+                /* candidate pattern is too large or has already been added to
+                   the canonical heuristic. */
+                return;
             }
-        }
+            if (timeout || hill_climbing_timer->is_expired()) {
+                timeout = true;
+                return;
+            }
+            int count = 0;
+            vector<PatternClique> pattern_cliques =
+                current_pdbs->get_pattern_cliques(pdb->get_pattern());
+            vector<int> h_patterns;
+            pdb->get_values(samples_by_var, h_patterns);
+            for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
+                assert(utils::in_bounds(sample_id, samples_h_values));
+                int h_collection = samples_h_values[sample_id];
+                if (is_heuristic_improved(
+                        h_patterns[sample_id], h_collection,
+                        is_dead_end_for_collection[sample_id],
+                        samples_pdb_values[sample_id], pattern_cliques)) {
+                    ++count;
+                }
+            }
+            counts[i] = count;
+        });
+    if (status == utils::ParallelForStatus::OUT_OF_MEMORY) {
+        throw HillClimbingOutOfMemory();
+    }
+    if (timeout) {
+        throw HillClimbingTimeout();
+    }
+
+    // Search for the best improving pattern/pdb in the order of candidates.
+    for (int i = 0; i < num_candidates; ++i) {
+        int count = counts[i];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -264,12 +329,10 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
 }
 
 bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
-    const PatternDatabase &pdb, const State &sample, int h_collection,
-    const PDBCollection &pdbs, const vector<PatternClique> &pattern_cliques) {
-    const vector<int> &sample_data = sample.get_unpacked_values();
+    int h_pattern, int h_collection, bool is_dead_end_for_collection,
+    const vector<int> &pdb_values,
+    const vector<PatternClique> &pattern_cliques) const {
     // h_pattern: h-value of the new pattern
-    int h_pattern = pdb.get_value(sample_data);
-
     if (h_pattern == numeric_limits<int>::max()) {
         return true;
     }
@@ -278,18 +341,13 @@ bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
     if (h_collection == numeric_limits<int>::max())
         return false;
 
-    vector<int> h_values;
-    h_values.reserve(pdbs.size());
-    for (const shared_ptr<PatternDatabase> &p : pdbs) {
-        int h = p->get_value(sample_data);
-        if (h == numeric_limits<int>::max())
-            return false;
-        h_values.push_back(h);
-    }
+    if (is_dead_end_for_collection)
+        return false;
+
     for (const PatternClique &clilque : pattern_cliques) {
         int h_clique = 0;
         for (PatternID pattern_id : clilque) {
-            h_clique += h_values[pattern_id];
+            h_clique += pdb_values[pattern_id];
         }
         if (h_pattern + h_clique > h_collection) {
             /*
@@ -321,21 +379,6 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
     PDBCollection candidate_pdbs;
     // The maximum size over all PDBs in candidate_pdbs.
     int max_pdb_size = 0;
-    for (const shared_ptr<PatternDatabase> &current_pdb :
-         *(current_pdbs->get_pattern_databases())) {
-        int new_max_pdb_size = generate_candidate_pdbs(
-            task_proxy, relevant_neighbours, *current_pdb, generated_patterns,
-            candidate_pdbs);
-        max_pdb_size = max(max_pdb_size, new_max_pdb_size);
-    }
-    /*
-      NOTE: The initial set of candidate patterns (in generated_patterns) is
-      guaranteed to be "normalized" in the sense that there are no duplicates
-      and patterns are sorted.
-    */
-    if (log.is_at_least_normal()) {
-        log << "Done calculating initial candidate PDBs" << endl;
-    }
 
     int num_iterations = 0;
     State initial_state = task_proxy.get_initial_state();
@@ -345,6 +388,22 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
     vector<int> samples_h_values;
 
     try {
+        for (const shared_ptr<PatternDatabase> &current_pdb :
+             *(current_pdbs->get_pattern_databases())) {
+            int new_max_pdb_size = generate_candidate_pdbs(
+                task_proxy, relevant_neighbours, *current_pdb,
+                generated_patterns, candidate_pdbs);
+            max_pdb_size = max(max_pdb_size, new_max_pdb_size);
+        }
+        /*
+          NOTE: The initial set of candidate patterns (in generated_patterns)
+          is guaranteed to be "normalized" in the sense that there are no
+          duplicates and patterns are sorted.
+        */
+        if (log.is_at_least_normal()) {
+            log << "Done calculating initial candidate PDBs" << endl;
+        }
+
         while (true) {
             ++num_iterations;
             int init_h = current_pdbs->get_value(initial_state);
@@ -364,14 +423,14 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
             }
 
             samples.clear();
-            samples_h_values.clear();
             sample_states(sampler, init_h, samples);
-            for (const State &sample : samples) {
-                samples_h_values.push_back(current_pdbs->get_value(sample));
-            }
+            vector<vector<int>> samples_by_var =
+                compute_values_by_variable(task_proxy, samples);
+            current_pdbs->get_values(samples_by_var, samples_h_values);
 
             pair<int, int> improvement_and_index =
-                find_best_improving_pdb(samples, samples_h_values, candidate_pdbs);
+                find_best_improving_pdb(
+                    samples_by_var, samples_h_values, candidate_pdbs);
             int improvement = improvement_and_index.first;
             int best_pdb_index = improvement_and_index.second;
 
@@ -416,6 +475,12 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
         if (log.is_at_least_normal()) {
             log << "Time limit reached. Abort hill climbing." << endl;
         }
+    } catch (HillClimbingOutOfMemory &) {
+        // Free the candidates so that the remaining steps have some memory.
+        utils::release_vector_memory(candidate_pdbs);
+        if (log.is_at_least_normal()) {
+            log << "Memory limit reached. Abort hill climbing." << endl;
+        }
     }
 
     if (log.is_at_least_normal()) {
@@ -552,6 +617,7 @@ void add_hillclimbing_options(OptionParser &parser) {
         "spent for pruning dominated patterns.",
         "infinity",
         Bounds("0.0", "infinity"));
+    utils::add_num_threads_option_to_parser(parser);
     utils::add_rng_options(parser);
     add_generator_options_to_parser(parser);
 }
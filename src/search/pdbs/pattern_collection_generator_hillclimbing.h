@@ -35,6 +35,8 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     // minimal improvement required for hill climbing to continue search
     const int min_improvement;
     const double max_time;
+    // number of threads for building and evaluating candidate pdbs
+    const int num_threads;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     std::unique_ptr<IncrementalCanonicalPDBs> current_pdbs;
@@ -48,9 +50,13 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       relevant variable are considered as candidate patterns. If the candidate
       pattern has not been previously considered (not contained in
       generated_patterns) and if building a PDB for it does not surpass the
-      size limit, then the PDB is built and added to candidate_pdbs.
+      size limit, then the PDB is built and added to candidate_pdbs. The new
+      PDBs are independent of each other and are built with num_threads
+      threads; they are added in the order of their patterns.
 
       The method returns the size of the largest PDB added to candidate_pdbs.
+      If the new PDBs do not fit into memory, it throws
+      HillClimbingOutOfMemory.
     */
     int generate_candidate_pdbs(
         const TaskProxy &task_proxy,
@@ -76,26 +82,32 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
 
     /*
       Searches for the best improving pdb in candidate_pdbs according to the
-      counting approximation and the given samples. Returns the improvement and
-      the index of the best pdb in candidate_pdbs.
+      counting approximation and the given samples (in the structure-of-arrays
+      form of compute_values_by_variable). Returns the improvement and
+      the index of the best pdb in candidate_pdbs, which is -1 if no
+      candidate improves the heuristic. Candidates are evaluated with
+      num_threads threads; ties are broken in favour of the lowest index,
+      so the result does not depend on the number of threads.
     */
     std::pair<int, int> find_best_improving_pdb(
-        const std::vector<State> &samples,
+        const std::vector<std::vector<int>> &samples_by_var,
         const std::vector<int> &samples_h_values,
         PDBCollection &candidate_pdbs);
 
     /*
-      Returns true iff the h-value of the new pattern (from pdb) plus the
+      Returns true iff the h-value of the new pattern (h_pattern) plus the
       h-value of all pattern cliques from the current pattern
       collection heuristic if the new pattern was added to it is greater than
-      the h-value of the current pattern collection.
+      the h-value of the current pattern collection. pdb_values holds the
+      h-values of the sample under all PDBs of the current collection and
+      is_dead_end_for_collection is true iff one of them is infinite.
     */
     bool is_heuristic_improved(
-        const PatternDatabase &pdb,
-        const State &sample,
+        int h_pattern,
         int h_collection,
-        const PDBCollection &pdbs,
-        const std::vector<PatternClique> &pattern_cliques);
+        bool is_dead_end_for_collection,
+        const std::vector<int> &pdb_values,
+        const std::vector<PatternClique> &pattern_cliques) const;
 
     /*
       This is the core algorithm of this class. The initial PDB collection
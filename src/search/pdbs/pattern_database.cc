@@ -369,6 +369,27 @@ int PatternDatabase::get_value(const vector<int> &state) const {
     return distances[hash_index(state)];
 }
 
+void PatternDatabase::get_values(
+    const vector<vector<int>> &values_by_var, vector<int> &h_values) const {
+    assert(!values_by_var.empty());
+    int num_states = values_by_var[0].size();
+    // Accumulate the hash indices in h_values, then replace them by distances.
+    h_values.assign(num_states, 0);
+    int *indices = h_values.data();
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        assert(utils::in_bounds(pattern[i], values_by_var));
+        const int *values = values_by_var[pattern[i]].data();
+        int multiplier = hash_multipliers[i];
+        for (int j = 0; j < num_states; ++j) {
+            indices[j] += multiplier * values[j];
+        }
+    }
+    const int *dist = distances.data();
+    for (int j = 0; j < num_states; ++j) {
+        indices[j] = dist[indices[j]];
+    }
+}
+
 double PatternDatabase::compute_mean_finite_h() const {
     double sum = 0;
     int size = 0;
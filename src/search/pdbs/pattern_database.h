@@ -186,6 +186,18 @@ public:
 
     int get_value(const std::vector<int> &state) const;
 
+    /*
+      Batch version of get_value. The states are given in structure-of-arrays
+      form: values_by_var[var][i] is the value of var in the i-th state (see
+      compute_values_by_variable in utils.h). Sets h_values[i] to the h-value
+      of the i-th state. The hash indices are accumulated one pattern
+      variable at a time over contiguous arrays, which the compiler can
+      vectorize.
+    */
+    void get_values(
+        const std::vector<std::vector<int>> &values_by_var,
+        std::vector<int> &h_values) const;
+
     // Returns the pattern (i.e. all variables used) of the PDB
     const Pattern &get_pattern() const {
         return pattern;
@@ -87,6 +87,23 @@ vector<vector<int>> compute_cg_neighbors(
     return cg_neighbors;
 }
 
+vector<vector<int>> compute_values_by_variable(
+    const TaskProxy &task_proxy, const vector<State> &states) {
+    int num_variables = task_proxy.get_variables().size();
+    vector<vector<int>> values_by_var(num_variables);
+    for (vector<int> &values : values_by_var) {
+        values.reserve(states.size());
+    }
+    for (const State &state : states) {
+        state.unpack();
+        const vector<int> &state_values = state.get_unpacked_values();
+        for (int var = 0; var < num_variables; ++var) {
+            values_by_var[var].push_back(state_values[var]);
+        }
+    }
+    return values_by_var;
+}
+
 PatternCollectionInformation get_pattern_collection_info(
     const TaskProxy &task_proxy, const shared_ptr<PDBCollection> &pdbs) {
     shared_ptr<PatternCollection> patterns = make_shared<PatternCollection>();
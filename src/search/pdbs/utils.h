@@ -36,6 +36,14 @@ extern std::vector<std::vector<int>> compute_cg_neighbors(
     const std::shared_ptr<AbstractTask> &task,
     bool bidirectional);
 
+/*
+  Transpose the given states into structure-of-arrays form as used by the
+  batch lookups of PatternDatabase and CanonicalPDBs: the result maps each
+  variable to the vector of its values in all states.
+*/
+extern std::vector<std::vector<int>> compute_values_by_variable(
+    const TaskProxy &task_proxy, const std::vector<State> &states);
+
 extern PatternCollectionInformation get_pattern_collection_info(
     const TaskProxy &task_proxy, const std::shared_ptr<PDBCollection> &pdbs);
 
@@ -65,12 +65,12 @@ void PlanManager::save_plan(
     OperatorsProxy operators = task_proxy.get_operators();
     for (OperatorID op_id : plan) {
         // cout << operators[op_id].get_name() << " (" << operators[op_id].get_cost() << ")" << endl;
-        outfile << "(" << operators[op_id].get_name() << ")" << endl;
+        outfile << "(" << operators[op_id].get_name() << ")\n";
     }
     int plan_cost = calculate_plan_cost(plan, task_proxy);
     bool is_unit_cost = task_properties::is_unit_cost(task_proxy);
     outfile << "; cost = " << plan_cost << " ("
-            << (is_unit_cost ? "unit cost" : "general cost") << ")" << endl;
+            << (is_unit_cost ? "unit cost" : "general cost") << ")\n";
     outfile.close();
     // utils::g_log << "Plan length: " << plan.size() << " step(s)." << endl;
     // utils::g_log << "Plan cost: " << plan_cost << endl;
@@ -102,19 +102,3 @@ void PlanManager::move_plans(const std::string& source_dirname, const std::strin
         std::rename(source_planfile.c_str(), dest_planfile.c_str());
     }
 }
-
-void PlanManager::write_plan_json(Plan plan, std::ostream& os, const TaskProxy &task_proxy) const {
-    int plan_cost = calculate_plan_cost(plan, task_proxy);
-    os << "{ ";
-    os << "\"cost\" : " << plan_cost << "," << endl; 
-    os << "\"actions\" : [" << endl;
-    OperatorsProxy operators = task_proxy.get_operators();
-    if (plan.size() > 0) {
-        os << "\""  << operators[plan[0]].get_name() << "\"";
-        for (size_t i = 1; i < plan.size(); ++i) {
-            os << ", \"" << operators[plan[i]].get_name() << "\"";
-        }
-    }
-    os << "]";
-    os << "}" << endl;
-}
@@ -33,7 +33,6 @@ public:
     void delete_plans(const std::string &plan_dirname);
 
     void move_plans(const std::string& source_dirname, const std::string& dest_dirname);
-    void write_plan_json(Plan plan, std::ostream& os, const TaskProxy &task_proxy) const;
 };
 
 extern int calculate_plan_cost(const Plan &plan, const TaskProxy &task_proxy);
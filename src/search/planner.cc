@@ -6,6 +6,7 @@
 #include "tasks/root_task.h"
 #include "task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "utils/profiling.h"
 #include "utils/system.h"
 #include "utils/timer.h"
 
@@ -58,12 +59,20 @@ int main(int argc, const char **argv) {
     engine->save_plan_if_necessary();
     utils::g_timer.stop();
     engine->print_statistics();
+    utils::print_profiling_statistics();
     utils::g_log << "Search time: " << search_timer << endl;
     utils::g_log << "Total time: " << utils::g_timer << endl;
 
-    ExitCode exitcode = engine->found_solution()
-        ? ExitCode::SUCCESS
-        : ExitCode::SEARCH_UNSOLVED_INCOMPLETE;
+    ExitCode exitcode;
+    if (engine->found_solution()) {
+        exitcode = engine->reached_memory_limit()
+            ? ExitCode::SEARCH_PLAN_FOUND_AND_OUT_OF_MEMORY
+            : ExitCode::SUCCESS;
+    } else {
+        exitcode = engine->reached_memory_limit()
+            ? ExitCode::SEARCH_OUT_OF_MEMORY
+            : ExitCode::SEARCH_UNSOLVED_INCOMPLETE;
+    }
     utils::report_exit_code_reentrant(exitcode);
     return static_cast<int>(exitcode);
 }
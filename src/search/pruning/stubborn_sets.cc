@@ -42,6 +42,7 @@ void StubbornSets::initialize(const shared_ptr<AbstractTask> &task) {
 
     has_conditional_effects = task_properties::has_conditional_effects(task_proxy);
     num_operators = task_proxy.get_operators().size();
+    stubborn.assign(num_operators, false);
     sorted_goals = utils::sorted<FactPair>(
         task_properties::get_fact_pairs(task_proxy.get_goals()));
 
@@ -108,6 +109,7 @@ void StubbornSets::compute_achievers(const TaskProxy &task_proxy) {
 bool StubbornSets::mark_as_stubborn(int op_no) {
     if (!stubborn[op_no]) {
         stubborn[op_no] = true;
+        stubborn_ops.push_back(op_no);
         stubborn_queue.push_back(op_no);
         return true;
     }
@@ -116,7 +118,10 @@ bool StubbornSets::mark_as_stubborn(int op_no) {
 
 void StubbornSets::prune(const State &state, vector<OperatorID> &op_ids) {
     // Clear stubborn set from previous call.
-    stubborn.assign(num_operators, false);
+    for (int op_no : stubborn_ops) {
+        stubborn[op_no] = false;
+    }
+    stubborn_ops.clear();
     assert(stubborn_queue.empty());
 
     initialize_stubborn_set(state);
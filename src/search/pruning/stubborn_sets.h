@@ -40,6 +40,11 @@ protected:
     /* stubborn[op_no] is true iff the operator with operator index
        op_no is contained in the stubborn set */
     std::vector<bool> stubborn;
+    /* stubborn_ops contains the operator indices of all operators in the
+       stubborn set, so it can be cleared without touching all operators.
+       Derived classes that set entries of stubborn directly must also
+       add them here. */
+    std::vector<int> stubborn_ops;
 
     bool can_disable(int op1_no, int op2_no) const;
     bool can_conflict(int op1_no, int op2_no) const;
@@ -7,12 +7,30 @@
 #include "../utils/markup.h"
 #include "../utils/memory.h"
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
 using namespace std;
 
 namespace stubborn_sets_atom_centric {
+/*
+  Caching is switched off if less than this fraction of the first lookups
+  are hits, since storing the stubborn sets is not free.
+*/
+static const int CACHE_LOOKUPS_BEFORE_CHECKING_HIT_RATIO = 1000;
+static const double MIN_CACHE_HIT_RATIO = 0.1;
+
 StubbornSetsAtomCentric::StubbornSetsAtomCentric(const options::Options &opts)
     : use_sibling_shortcut(opts.get<bool>("use_sibling_shortcut")),
-      atom_selection_strategy(opts.get<AtomSelectionStrategy>("atom_selection_strategy")) {
+      atom_selection_strategy(opts.get<AtomSelectionStrategy>("atom_selection_strategy")),
+      max_cached_stubborn_sets(opts.get<int>("max_cached_stubborn_sets")),
+      use_cache(max_cached_stubborn_sets > 0),
+      generation(0),
+      state_values(nullptr),
+      num_cached_stubborn_sets(0),
+      num_cache_hits(0),
+      num_cache_misses(0) {
 }
 
 void StubbornSetsAtomCentric::initialize(const shared_ptr<AbstractTask> &task) {
@@ -22,56 +40,127 @@ void StubbornSetsAtomCentric::initialize(const shared_ptr<AbstractTask> &task) {
     TaskProxy task_proxy(*task);
 
     int num_variables = task_proxy.get_variables().size();
-    marked_producers.reserve(num_variables);
-    marked_consumers.reserve(num_variables);
+    int num_facts = 0;
+    fact_id_offsets.reserve(num_variables);
+    domain_sizes.reserve(num_variables);
     for (VariableProxy var : task_proxy.get_variables()) {
-        marked_producers.emplace_back(var.get_domain_size(), false);
-        marked_consumers.emplace_back(var.get_domain_size(), false);
+        fact_id_offsets.push_back(num_facts);
+        domain_sizes.push_back(var.get_domain_size());
+        num_facts += var.get_domain_size();
     }
 
+    producer_marks.resize(num_facts, 0);
+    consumer_marks.resize(num_facts, 0);
     if (use_sibling_shortcut) {
         marked_producer_variables.resize(num_variables, MARKED_VALUES_NONE);
         marked_consumer_variables.resize(num_variables, MARKED_VALUES_NONE);
+        producer_variable_marks.resize(num_variables, 0);
+        consumer_variable_marks.resize(num_variables, 0);
+    }
+    if (use_cache) {
+        read_variable_marks.resize(num_variables, 0);
     }
 
-    compute_consumers(task_proxy);
+    compute_producers_and_consumers(task_proxy);
 }
 
-void StubbornSetsAtomCentric::compute_consumers(const TaskProxy &task_proxy) {
-    consumers.reserve(task_proxy.get_variables().size());
-    for (VariableProxy var : task_proxy.get_variables()) {
-        consumers.emplace_back(var.get_domain_size());
+void StubbornSetsAtomCentric::compute_producers_and_consumers(
+    const TaskProxy &task_proxy) {
+    int num_facts = producer_marks.size();
+    vector<int> num_producers(num_facts, 0);
+    vector<int> num_consumers(num_facts, 0);
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        for (EffectProxy effect : op.get_effects()) {
+            ++num_producers[get_fact_id(effect.get_fact().get_pair())];
+        }
+        for (FactProxy fact : op.get_preconditions()) {
+            ++num_consumers[get_fact_id(fact.get_pair())];
+        }
     }
 
+    producer_starts.resize(num_facts + 1);
+    consumer_starts.resize(num_facts + 1);
+    producer_starts[0] = 0;
+    consumer_starts[0] = 0;
+    for (int fact_id = 0; fact_id < num_facts; ++fact_id) {
+        producer_starts[fact_id + 1] = producer_starts[fact_id] + num_producers[fact_id];
+        consumer_starts[fact_id + 1] = consumer_starts[fact_id] + num_consumers[fact_id];
+    }
+
+    /*
+      Fill the tables in operator order, so the operators of each fact are
+      enumerated in the same order as before.
+    */
+    producer_ops.resize(producer_starts[num_facts]);
+    consumer_ops.resize(consumer_starts[num_facts]);
+    vector<int> next_producer(producer_starts.begin(), producer_starts.end() - 1);
+    vector<int> next_consumer(consumer_starts.begin(), consumer_starts.end() - 1);
     for (OperatorProxy op : task_proxy.get_operators()) {
         int op_id = op.get_id();
-        for (FactProxy fact_proxy : op.get_preconditions()) {
-            FactPair fact = fact_proxy.get_pair();
-            consumers[fact.var][fact.value].push_back(op_id);
+        for (EffectProxy effect : op.get_effects()) {
+            producer_ops[next_producer[get_fact_id(effect.get_fact().get_pair())]++] = op_id;
         }
+        for (FactProxy fact : op.get_preconditions()) {
+            consumer_ops[next_consumer[get_fact_id(fact.get_pair())]++] = op_id;
+        }
+    }
+
+    // The nested achiever lists are replaced by the flat producer table.
+    vector<vector<vector<int>>>().swap(achievers);
+}
+
+int StubbornSetsAtomCentric::get_value(int var) {
+    int value = (*state_values)[var];
+    if (use_cache && read_variable_marks[var] != generation) {
+        read_variable_marks[var] = generation;
+        read_facts.emplace_back(var, value);
     }
+    return value;
+}
 
-    for (auto &outer : consumers) {
-        for (auto &inner : outer) {
-            inner.shrink_to_fit();
+int &StubbornSetsAtomCentric::get_variable_mark(
+    vector<int> &marked_variables, vector<int> &marks, int var) {
+    if (marks[var] != generation) {
+        marks[var] = generation;
+        marked_variables[var] = MARKED_VALUES_NONE;
+    }
+    return marked_variables[var];
+}
+
+void StubbornSetsAtomCentric::start_new_generation() {
+    if (generation == numeric_limits<int>::max()) {
+        // Reset all stamps instead of overflowing.
+        generation = 0;
+        for (vector<int> *marks : {&producer_marks, &consumer_marks,
+                                   &producer_variable_marks,
+                                   &consumer_variable_marks,
+                                   &read_variable_marks}) {
+            marks->assign(marks->size(), 0);
         }
     }
+    ++generation;
 }
 
-bool StubbornSetsAtomCentric::operator_is_applicable(int op, const State &state) const {
-    return find_unsatisfied_precondition(op, state) == FactPair::no_fact;
+bool StubbornSetsAtomCentric::operator_is_applicable(int op) {
+    for (const FactPair &precondition : sorted_op_preconditions[op]) {
+        if (!is_satisfied(precondition))
+            return false;
+    }
+    return true;
 }
 
 void StubbornSetsAtomCentric::enqueue_producers(const FactPair &fact) {
-    if (!marked_producers[fact.var][fact.value]) {
-        marked_producers[fact.var][fact.value] = true;
+    int &mark = producer_marks[get_fact_id(fact)];
+    if (mark != generation) {
+        mark = generation;
         producer_queue.push_back(fact);
     }
 }
 
 void StubbornSetsAtomCentric::enqueue_consumers(const FactPair &fact) {
-    if (!marked_consumers[fact.var][fact.value]) {
-        marked_consumers[fact.var][fact.value] = true;
+    int &mark = consumer_marks[get_fact_id(fact)];
+    if (mark != generation) {
+        mark = generation;
         consumer_queue.push_back(fact);
     }
 }
@@ -83,13 +172,15 @@ void StubbornSetsAtomCentric::enqueue_sibling_producers(const FactPair &fact) {
       given fact v=d.
     */
     int dummy_mark = MARKED_VALUES_NONE;
-    int &mark = use_sibling_shortcut ? marked_producer_variables[fact.var] : dummy_mark;
+    int &mark = use_sibling_shortcut ?
+        get_variable_mark(marked_producer_variables, producer_variable_marks, fact.var) :
+        dummy_mark;
     if (mark == MARKED_VALUES_NONE) {
         /*
           If we don't have marking info for variable v, enqueue all sibling
           producers of v=d and remember that we marked all siblings.
         */
-        int domain_size = consumers[fact.var].size();
+        int domain_size = domain_sizes[fact.var];
         for (int value = 0; value < domain_size; ++value) {
             if (value != fact.value) {
                 enqueue_producers(FactPair(fact.var, value));
@@ -109,9 +200,11 @@ void StubbornSetsAtomCentric::enqueue_sibling_producers(const FactPair &fact) {
 void StubbornSetsAtomCentric::enqueue_sibling_consumers(const FactPair &fact) {
     // For documentation, see enqueue_sibling_producers().
     int dummy_mark = MARKED_VALUES_NONE;
-    int &mark = use_sibling_shortcut ? marked_consumer_variables[fact.var] : dummy_mark;
+    int &mark = use_sibling_shortcut ?
+        get_variable_mark(marked_consumer_variables, consumer_variable_marks, fact.var) :
+        dummy_mark;
     if (mark == MARKED_VALUES_NONE) {
-        int domain_size = consumers[fact.var].size();
+        int domain_size = domain_sizes[fact.var];
         for (int value = 0; value < domain_size; ++value) {
             if (value != fact.value) {
                 enqueue_consumers(FactPair(fact.var, value));
@@ -124,19 +217,23 @@ void StubbornSetsAtomCentric::enqueue_sibling_consumers(const FactPair &fact) {
     }
 }
 
-FactPair StubbornSetsAtomCentric::select_fact(
-    const vector<FactPair> &facts, const State &state) const {
+FactPair StubbornSetsAtomCentric::select_fact(const vector<FactPair> &facts) {
     FactPair fact = FactPair::no_fact;
     if (atom_selection_strategy == AtomSelectionStrategy::FAST_DOWNWARD) {
-        fact = stubborn_sets::find_unsatisfied_condition(facts, state);
+        for (const FactPair &condition : facts) {
+            if (!is_satisfied(condition)) {
+                fact = condition;
+                break;
+            }
+        }
     } else if (atom_selection_strategy == AtomSelectionStrategy::QUICK_SKIP) {
         /*
           If there is an unsatisfied fact whose producers are already marked,
           choose it. Otherwise, choose the first unsatisfied fact.
         */
         for (const FactPair &condition : facts) {
-            if (state[condition.var].get_value() != condition.value) {
-                if (marked_producers[condition.var][condition.value]) {
+            if (!is_satisfied(condition)) {
+                if (producer_marks[get_fact_id(condition)] == generation) {
                     fact = condition;
                     break;
                 } else if (fact == FactPair::no_fact) {
@@ -147,8 +244,9 @@ FactPair StubbornSetsAtomCentric::select_fact(
     } else if (atom_selection_strategy == AtomSelectionStrategy::STATIC_SMALL) {
         int min_count = numeric_limits<int>::max();
         for (const FactPair &condition : facts) {
-            if (state[condition.var].get_value() != condition.value) {
-                int count = achievers[condition.var][condition.value].size();
+            if (!is_satisfied(condition)) {
+                int fact_id = get_fact_id(condition);
+                int count = producer_starts[fact_id + 1] - producer_starts[fact_id];
                 if (count < min_count) {
                     fact = condition;
                     min_count = count;
@@ -158,10 +256,12 @@ FactPair StubbornSetsAtomCentric::select_fact(
     } else if (atom_selection_strategy == AtomSelectionStrategy::DYNAMIC_SMALL) {
         int min_count = numeric_limits<int>::max();
         for (const FactPair &condition : facts) {
-            if (state[condition.var].get_value() != condition.value) {
-                const vector<int> &ops = achievers[condition.var][condition.value];
+            if (!is_satisfied(condition)) {
+                int fact_id = get_fact_id(condition);
                 int count = count_if(
-                    ops.begin(), ops.end(), [&](int op) {return !stubborn[op];});
+                    producer_ops.begin() + producer_starts[fact_id],
+                    producer_ops.begin() + producer_starts[fact_id + 1],
+                    [&](int op) {return !stubborn[op];});
                 if (count < min_count) {
                     fact = condition;
                     min_count = count;
@@ -175,8 +275,8 @@ FactPair StubbornSetsAtomCentric::select_fact(
     return fact;
 }
 
-void StubbornSetsAtomCentric::enqueue_nes(int op, const State &state) {
-    FactPair fact = select_fact(sorted_op_preconditions[op], state);
+void StubbornSetsAtomCentric::enqueue_nes(int op) {
+    FactPair fact = select_fact(sorted_op_preconditions[op]);
     enqueue_producers(fact);
 }
 
@@ -194,54 +294,136 @@ void StubbornSetsAtomCentric::enqueue_interferers(int op) {
     }
 }
 
-void StubbornSetsAtomCentric::initialize_stubborn_set(const State &state) {
+void StubbornSetsAtomCentric::compute_stubborn_set(const State &state) {
     assert(producer_queue.empty());
     assert(consumer_queue.empty());
-    // Reset data structures from previous call.
-    for (auto &facts : marked_producers) {
-        facts.assign(facts.size(), false);
-    }
-    for (auto &facts : marked_consumers) {
-        facts.assign(facts.size(), false);
-    }
-    if (use_sibling_shortcut) {
-        int num_variables = state.size();
-        marked_producer_variables.assign(num_variables, MARKED_VALUES_NONE);
-        marked_consumer_variables.assign(num_variables, MARKED_VALUES_NONE);
-    }
-
-    FactPair unsatisfied_goal = select_fact(sorted_goals, state);
+    FactPair unsatisfied_goal = select_fact(sorted_goals);
     assert(unsatisfied_goal != FactPair::no_fact);
     enqueue_producers(unsatisfied_goal);
 
     while (!producer_queue.empty() || !consumer_queue.empty()) {
+        const vector<int> *starts;
+        const vector<int> *ops;
+        FactPair fact = FactPair::no_fact;
         if (!producer_queue.empty()) {
-            FactPair fact = producer_queue.back();
+            fact = producer_queue.back();
             producer_queue.pop_back();
-            for (int op : achievers[fact.var][fact.value]) {
-                handle_stubborn_operator(state, op);
-            }
+            starts = &producer_starts;
+            ops = &producer_ops;
         } else {
-            FactPair fact = consumer_queue.back();
+            fact = consumer_queue.back();
             consumer_queue.pop_back();
-            for (int op : consumers[fact.var][fact.value]) {
-                handle_stubborn_operator(state, op);
+            starts = &consumer_starts;
+            ops = &consumer_ops;
+        }
+        int fact_id = get_fact_id(fact);
+        for (int i = (*starts)[fact_id]; i < (*starts)[fact_id + 1]; ++i) {
+            handle_stubborn_operator(state, (*ops)[i]);
+        }
+    }
+}
+
+bool StubbornSetsAtomCentric::load_from_cache(CacheBucket &bucket) {
+    const vector<int> &values = *state_values;
+    for (const CacheEntry &entry : bucket.entries) {
+        bool matches = all_of(
+            entry.read_facts.begin(), entry.read_facts.end(),
+            [&](const FactPair &fact) {return values[fact.var] == fact.value;});
+        if (matches) {
+            for (int op : entry.stubborn_ops) {
+                stubborn[op] = true;
             }
+            stubborn_ops = entry.stubborn_ops;
+            return true;
+        }
+    }
+    return false;
+}
+
+void StubbornSetsAtomCentric::store_in_cache(CacheBucket &bucket) {
+    // Each bucket keeps a few entries and replaces them round-robin.
+    const int max_entries_per_bucket = 4;
+    if (static_cast<int>(bucket.entries.size()) < max_entries_per_bucket) {
+        bucket.entries.emplace_back();
+        ++num_cached_stubborn_sets;
+        CacheEntry &entry = bucket.entries.back();
+        entry.read_facts = read_facts;
+        entry.stubborn_ops = stubborn_ops;
+    } else {
+        CacheEntry &entry = bucket.entries[bucket.next_replaced];
+        bucket.next_replaced = (bucket.next_replaced + 1) % max_entries_per_bucket;
+        entry.read_facts.assign(read_facts.begin(), read_facts.end());
+        entry.stubborn_ops.assign(stubborn_ops.begin(), stubborn_ops.end());
+    }
+}
+
+void StubbornSetsAtomCentric::initialize_stubborn_set(const State &state) {
+    state.unpack();
+    state_values = &state.get_unpacked_values();
+    start_new_generation();
+    assert(stubborn_ops.empty());
+
+    if (!use_cache) {
+        compute_stubborn_set(state);
+        return;
+    }
+    if (num_cache_hits + num_cache_misses == CACHE_LOOKUPS_BEFORE_CHECKING_HIT_RATIO &&
+        num_cache_hits < MIN_CACHE_HIT_RATIO * CACHE_LOOKUPS_BEFORE_CHECKING_HIT_RATIO) {
+        utils::g_log << "Stubborn set cache hit ratio is too low -> "
+                     << "switching off caching" << endl;
+        use_cache = false;
+        utils::HashMap<vector<int>, CacheBucket>().swap(cache);
+        compute_stubborn_set(state);
+        return;
+    }
+
+    unsatisfied_goals.clear();
+    for (int i = 0; i < static_cast<int>(sorted_goals.size()); ++i) {
+        const FactPair &goal = sorted_goals[i];
+        if ((*state_values)[goal.var] != goal.value)
+            unsatisfied_goals.push_back(i);
+    }
+    auto it = cache.find(unsatisfied_goals);
+    if (it != cache.end() && load_from_cache(it->second)) {
+        ++num_cache_hits;
+        return;
+    }
+    ++num_cache_misses;
+
+    read_facts.clear();
+    compute_stubborn_set(state);
+
+    if (it == cache.end()) {
+        if (num_cached_stubborn_sets >= max_cached_stubborn_sets) {
+            cache.clear();
+            num_cached_stubborn_sets = 0;
         }
+        it = cache.emplace(unsatisfied_goals, CacheBucket()).first;
     }
+    store_in_cache(it->second);
 }
 
-void StubbornSetsAtomCentric::handle_stubborn_operator(const State &state, int op) {
+void StubbornSetsAtomCentric::handle_stubborn_operator(const State &, int op) {
+    // The state is accessed through state_values, see get_value().
     if (!stubborn[op]) {
         stubborn[op] = true;
-        if (operator_is_applicable(op, state)) {
+        stubborn_ops.push_back(op);
+        if (operator_is_applicable(op)) {
             enqueue_interferers(op);
         } else {
-            enqueue_nes(op, state);
+            enqueue_nes(op);
         }
     }
 }
 
+void StubbornSetsAtomCentric::print_statistics() const {
+    StubbornSets::print_statistics();
+    if (num_cache_hits + num_cache_misses > 0) {
+        utils::g_log << "Stubborn set cache hits: " << num_cache_hits << endl
+                     << "Stubborn set cache misses: " << num_cache_misses << endl;
+    }
+}
+
 
 static shared_ptr<PruningMethod> _parse(OptionParser &parser) {
     parser.document_synopsis(
@@ -288,6 +470,19 @@ static shared_ptr<PruningMethod> _parse(OptionParser &parser) {
         "breaking ties.",
         "quick_skip",
         strategies_docs);
+    parser.add_option<int>(
+        "max_cached_stubborn_sets",
+        "maximum number of cached stubborn sets; the cache is cleared when "
+        "it is full (0 disables caching)",
+        "1000",
+        Bounds("0", "infinity"));
+    parser.document_note(
+        "Caching",
+        "A stubborn set only depends on the values of the state variables "
+        "read while computing it. Computed stubborn sets are cached together "
+        "with these values and reused for later states that agree on them. "
+        "The result is the same as without caching. Caching is switched off "
+        "automatically if less than 10% of the first 1000 lookups are hits.");
 
     Options opts = parser.parse();
 
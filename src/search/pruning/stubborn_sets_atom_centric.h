@@ -3,6 +3,8 @@
 
 #include "stubborn_sets.h"
 
+#include "../utils/hash.h"
+
 namespace stubborn_sets_atom_centric {
 static const int MARKED_VALUES_NONE = -2;
 static const int MARKED_VALUES_ALL = -1;
@@ -15,39 +17,102 @@ enum class AtomSelectionStrategy {
     DYNAMIC_SMALL
 };
 
+/*
+  All per-fact and per-variable data is stored in flat arrays indexed by
+  fact IDs (fact_id_offsets[var] + value). Producers and consumers of a
+  fact are stored in compressed sparse row form. Marks are generation
+  stamps, so nothing has to be cleared between two states.
+
+  Computed stubborn sets can be cached. The computation only depends on
+  the values of the state variables it reads, so we store these values
+  together with the stubborn set and reuse the set for every later state
+  that agrees with them. Cache entries are grouped by the set of
+  unsatisfied goals, which is cheap to compute for each state.
+*/
 class StubbornSetsAtomCentric : public stubborn_sets::StubbornSets {
+    struct CacheEntry {
+        std::vector<FactPair> read_facts;
+        std::vector<int> stubborn_ops;
+    };
+
+    struct CacheBucket {
+        std::vector<CacheEntry> entries;
+        int next_replaced;
+
+        CacheBucket() : next_replaced(0) {
+        }
+    };
+
     const bool use_sibling_shortcut;
     const AtomSelectionStrategy atom_selection_strategy;
+    const int max_cached_stubborn_sets;
+    bool use_cache;
+
+    std::vector<int> fact_id_offsets;
+    std::vector<int> domain_sizes;
+
+    // Operators achieving (producers) and requiring (consumers) each fact.
+    std::vector<int> producer_starts;
+    std::vector<int> producer_ops;
+    std::vector<int> consumer_starts;
+    std::vector<int> consumer_ops;
 
-    // consumers[v][d] contains the ID of operator o if pre(o) contains the fact v=d.
-    std::vector<std::vector<std::vector<int>>> consumers;
     /*
-      Marked producer and consumer facts.
-      marked_{producers,consumers}[v][d] is true iff fact v=d is marked.
+      Fact f is marked as producer (consumer) fact iff
+      {producer,consumer}_marks[f] == generation.
     */
-    std::vector<std::vector<bool>> marked_producers;
-    std::vector<std::vector<bool>> marked_consumers;
+    int generation;
+    std::vector<int> producer_marks;
+    std::vector<int> consumer_marks;
     /*
-      Data structures for shortcut handling of siblings.
+      Data structures for shortcut handling of siblings. They are only
+      valid for variable v if *_variable_marks[v] == generation.
       marked_*_variables[v] = d iff all sibling facts v=d' with d'!=d are marked
       marked_*_variables[v] = MARKED_VALUES_ALL iff all facts for v are marked
       marked_*_variables[v] = MARKED_VALUES_NONE iff we have no such information
     */
     std::vector<int> marked_producer_variables;
     std::vector<int> marked_consumer_variables;
+    std::vector<int> producer_variable_marks;
+    std::vector<int> consumer_variable_marks;
 
     std::vector<FactPair> producer_queue;
     std::vector<FactPair> consumer_queue;
 
-    void compute_consumers(const TaskProxy &task_proxy);
-    bool operator_is_applicable(int op, const State &state) const;
+    // Values of the state that is currently handled.
+    const std::vector<int> *state_values;
+
+    // Variables read by the current computation (only if caching).
+    std::vector<int> read_variable_marks;
+    std::vector<FactPair> read_facts;
+    utils::HashMap<std::vector<int>, CacheBucket> cache;
+    std::vector<int> unsatisfied_goals;
+    int num_cached_stubborn_sets;
+    long num_cache_hits;
+    long num_cache_misses;
+
+    int get_fact_id(const FactPair &fact) const {
+        return fact_id_offsets[fact.var] + fact.value;
+    }
+    int get_value(int var);
+    bool is_satisfied(const FactPair &fact) {
+        return get_value(fact.var) == fact.value;
+    }
+    int &get_variable_mark(
+        std::vector<int> &marked_variables, std::vector<int> &marks, int var);
+    void start_new_generation();
+    void compute_producers_and_consumers(const TaskProxy &task_proxy);
+    bool operator_is_applicable(int op);
     void enqueue_producers(const FactPair &fact);
     void enqueue_consumers(const FactPair &fact);
     void enqueue_sibling_consumers(const FactPair &fact);
     void enqueue_sibling_producers(const FactPair &fact);
-    FactPair select_fact(const std::vector<FactPair> &facts, const State &state) const;
-    void enqueue_nes(int op, const State &state);
+    FactPair select_fact(const std::vector<FactPair> &facts);
+    void enqueue_nes(int op);
     void enqueue_interferers(int op);
+    void compute_stubborn_set(const State &state);
+    bool load_from_cache(CacheBucket &bucket);
+    void store_in_cache(CacheBucket &bucket);
 protected:
     virtual void initialize_stubborn_set(const State &state) override;
     virtual void handle_stubborn_operator(const State &state, int op) override;
@@ -55,6 +120,7 @@ public:
     explicit StubbornSetsAtomCentric(const options::Options &opts);
 
     virtual void initialize(const std::shared_ptr<AbstractTask> &task) override;
+    virtual void print_statistics() const override;
 };
 }
 
@@ -4,6 +4,7 @@
 
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
+#include "utils/profiling.h"
 
 #include <cassert>
 
@@ -23,6 +24,7 @@ void PruningMethod::initialize(const shared_ptr<AbstractTask> &task_) {
 void PruningMethod::prune_operators(
     const State &state, vector<OperatorID> &op_ids) {
     assert(!task_properties::is_goal_state(TaskProxy(*task), state));
+    PROFILE_SCOPE("pruning");
     timer.resume();
     int num_ops_before_pruning = op_ids.size();
     prune(state, op_ids);
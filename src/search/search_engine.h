@@ -53,6 +53,8 @@ protected:
     OperatorCost cost_type;
     bool is_unit_cost;
     double max_time;
+    // Set by engines that stop searching early when reaching the memory limit.
+    bool memory_limit_reached = false;
 
     virtual void initialize() {}
     virtual SearchStatus step() = 0;
@@ -68,6 +70,7 @@ public:
     virtual void save_plan_if_necessary();
     bool found_solution() const;
     SearchStatus get_status() const;
+    bool reached_memory_limit() const {return memory_limit_reached;}
     const Plan &get_plan() const;
     virtual void search();
     const SearchStatistics &get_statistics() const {return statistics;}
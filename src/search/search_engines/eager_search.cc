@@ -11,6 +11,7 @@
 #include "../tasks/root_task.h"
 
 #include "../utils/logging.h"
+#include "../utils/profiling.h"
 #include "../structural_symmetries/group.h"
 #include "../task_utils/task_properties.h"
 
@@ -136,6 +137,21 @@ void EagerSearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
     pruning_method->print_statistics();
+
+    vector<Evaluator *> evals;
+    open_list->get_involved_evaluators(evals);
+    for (const shared_ptr<Evaluator> &evaluator : preferred_operator_evaluators) {
+        evaluator->get_involved_evaluators(evals);
+    }
+    if (f_evaluator) {
+        f_evaluator->get_involved_evaluators(evals);
+    }
+    if (lazy_evaluator) {
+        lazy_evaluator->get_involved_evaluators(evals);
+    }
+    for (Evaluator *evaluator : evals) {
+        evaluator->print_statistics();
+    }
 }
 
 SearchStatus EagerSearch::step() {
@@ -145,7 +161,11 @@ SearchStatus EagerSearch::step() {
             log << "Completely explored state space -- no solution!" << endl;
             return FAILED;
         }
-        StateID id = open_list->remove_min();
+        StateID id = StateID::no_state;
+        {
+            PROFILE_SCOPE("open list removal");
+            id = open_list->remove_min();
+        }
         State s = state_registry.lookup_state(id);
         node.emplace(search_space.get_node(s));
 
@@ -265,6 +265,15 @@ void EnforcedHillClimbingSearch::print_statistics() const {
             << " - Avg. Expansions: "
             << static_cast<double>(total_expansions) / phases << endl;
     }
+
+    vector<Evaluator *> evals;
+    evaluator->get_involved_evaluators(evals);
+    for (const shared_ptr<Evaluator> &eval : preferred_operator_evaluators) {
+        eval->get_involved_evaluators(evals);
+    }
+    for (Evaluator *eval : evals) {
+        eval->print_statistics();
+    }
 }
 
 static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
@@ -215,5 +215,14 @@ void LazySearch::reward_progress() {
 void LazySearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
+
+    vector<Evaluator *> evals;
+    open_list->get_involved_evaluators(evals);
+    for (const shared_ptr<Evaluator> &evaluator : preferred_operator_evaluators) {
+        evaluator->get_involved_evaluators(evals);
+    }
+    for (Evaluator *evaluator : evals) {
+        evaluator->print_statistics();
+    }
 }
 }
@@ -10,6 +10,7 @@
 #include "../open_lists/alternation_open_list.h"
 #include "../open_lists/best_first_open_list.h"
 #include "../open_lists/tiebreaking_open_list.h"
+#include "../open_lists/two_level_bucket_open_list.h"
 
 #include <memory>
 
@@ -125,4 +126,20 @@ create_astar_open_list_factory_and_f_eval(const Options &opts) {
         make_shared<tiebreaking_open_list::TieBreakingOpenListFactory>(options);
     return make_pair(open, f);
 }
+
+pair<shared_ptr<OpenListFactory>, const shared_ptr<Evaluator>>
+create_astar_bucket_open_list_factory_and_f_eval(const Options &opts) {
+    shared_ptr<GEval> g = make_shared<GEval>();
+    shared_ptr<Evaluator> h = opts.get<shared_ptr<Evaluator>>("eval");
+    shared_ptr<Evaluator> f = make_shared<SumEval>(vector<shared_ptr<Evaluator>>({g, h}));
+
+    Options options;
+    options.set("primary", f);
+    options.set("secondary", h);
+    options.set("pref_only", false);
+    options.set("unsafe_pruning", false);
+    shared_ptr<OpenListFactory> open =
+        make_shared<two_level_bucket_open_list::TwoLevelBucketOpenListFactory>(options);
+    return make_pair(open, f);
+}
 }
@@ -77,6 +77,14 @@ extern std::shared_ptr<OpenListFactory> create_wastar_open_list_factory(
 */
 extern std::pair<std::shared_ptr<OpenListFactory>, const std::shared_ptr<Evaluator>>
 create_astar_open_list_factory_and_f_eval(const options::Options &opts);
+
+/*
+  Like create_astar_open_list_factory_and_f_eval, but the open list
+  factory produces a two-level bucket open list with the same order,
+  which avoids the map lookups of the tie-breaking open list.
+*/
+extern std::pair<std::shared_ptr<OpenListFactory>, const std::shared_ptr<Evaluator>>
+create_astar_bucket_open_list_factory_and_f_eval(const options::Options &opts);
 }
 
 #endif
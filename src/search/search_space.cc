@@ -166,18 +166,12 @@ void SearchSpace::surrogate_trace_to_plan(const vector<StateID>& surrogate_trace
     OperatorsProxy operators = task_proxy.get_operators();
 
     /*
-      For DKS, we need to use a separate registry to generate successor states
-      to avoid generating the symmetrical successor state, which could equal
-      the current_state of the state trace.
-
-      For OSS; we can use the regular registry, as it works directly on
-      canonical representatives.
+      Successor states are not registered. For DKS, registering them could
+      map them to a symmetrical state, which could equal the current_state of
+      the state trace. Not registering them also makes this method safe to
+      call from several threads while the registry is not modified, unless
+      the task has axioms (the axiom evaluator is shared).
     */
-    StateRegistry dks_successor_state_registry(task_proxy);
-
-    StateRegistry *successor_registry =
-        group->get_search_symmetries() == SearchSymmetries::DKS ?
-                &dks_successor_state_registry : &state_registry;
 
     // vector<RawPermutation> permutations;
     vector<PermutationTrace> permutation_traces;
@@ -187,19 +181,21 @@ void SearchSpace::surrogate_trace_to_plan(const vector<StateID>& surrogate_trace
     // Going backwards on the sequence of states, finding the permutation for each step. 
     // Keep also the permutation as a sequence of generators (and their inverses).
     for (int i = surrogate_trace.size() - 1; i>=0; --i) {
-        State current_state = successor_registry->lookup_state(surrogate_trace[i]);
+        State current_state = state_registry.lookup_state(surrogate_trace[i]);
+        current_state.unpack();
         // state_trace.push_back(current_state);
 
-        State new_state = state_registry.get_initial_state();
+        State new_state = task_proxy.get_initial_state();
         if (i>0) {
-            State parent_state = successor_registry->lookup_state(surrogate_trace[i-1]);
+            State parent_state = state_registry.lookup_state(surrogate_trace[i-1]);
+            parent_state.unpack();
             OperatorID op_id = surrogate_plan[i-1];
-            new_state = successor_registry->get_successor_state(parent_state, operators[op_id]);
+            new_state = parent_state.get_unregistered_successor(operators[op_id]);
         }
 
         RawPermutation p;
         PermutationTrace tr;
-        if (new_state.get_id() != current_state.get_id()){
+        if (new_state.get_unpacked_values() != current_state.get_unpacked_values()){
             p = group->create_permutation_from_state_to_state(current_state, new_state, tr);
         // } else {
         //     p = group->new_identity_raw_permutation();
@@ -39,6 +39,10 @@ public:
     bool operator!=(const StateID &other) const {
         return !(*this == other);
     }
+
+    int hash() const {
+        return value;
+    }
 };
 
 
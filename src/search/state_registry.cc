@@ -8,6 +8,7 @@
 
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
+#include "utils/profiling.h"
 
 using namespace std;
 
@@ -35,6 +36,7 @@ void StateRegistry::set_group(const shared_ptr<Group> &group_) {
 }
 
 StateID StateRegistry::insert_id_or_pop_state() {
+    PROFILE_SCOPE("state registry insertion");
     if (has_symmetries_and_uses_dks) {
         return insert_id_or_pop_state_dks();
     }
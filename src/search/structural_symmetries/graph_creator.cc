@@ -6,13 +6,16 @@
 #include "../task_proxy.h"
 
 #include "../utils/collections.h"
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/timer.h"
 
 #include "../bliss/graph.h"
 
+#include <algorithm>
 #include <fstream>
 #include <map>
+#include <numeric>
 
 
 using namespace std;
@@ -36,8 +39,25 @@ static void out_of_memory_handler() {
 }
 
 // Function that is called from the graph automorphism tool.
-void add_permutation_to_group(void *group, unsigned int, const unsigned int *permutation) {
-    static_cast<Group *>(group)->add_raw_generator(permutation);
+void add_permutation_to_group(void *graph_creator, unsigned int, const unsigned int *permutation) {
+    static_cast<GraphCreator *>(graph_creator)->add_bliss_generator(permutation);
+}
+
+void GraphCreator::initialize_group(const TaskProxy &task_proxy, Group *group) {
+    VariablesProxy vars = task_proxy.get_variables();
+    int num_vertices_so_far = vars.size();
+    for (VariableProxy var : vars) {
+        int var_id = var.get_id();
+        group->add_to_dom_sum_by_var(num_vertices_so_far);
+        num_vertices_so_far += var.get_domain_size();
+        for(int num_of_value = 0; num_of_value < var.get_domain_size(); num_of_value++){
+            group->add_to_var_by_val(var_id);
+        }
+    }
+
+    group->set_permutation_num_variables(vars.size());
+    group->set_permutation_num_operators(task_proxy.get_operators().size());
+    group->set_permutation_length(num_vertices_so_far);
 }
 
 bool GraphCreator::compute_symmetries(
@@ -48,6 +68,7 @@ bool GraphCreator::compute_symmetries(
     const int time_bound,
     const bool dump_symmetry_graph,
     Group *group) {
+    this->group = group;
     bool success = false;
     new_handler original_new_handler = set_new_handler(out_of_memory_handler);
     try {
@@ -60,14 +81,16 @@ bool GraphCreator::compute_symmetries(
             stabilize_goal,
             use_color_for_stabilizing_goal,
             dump_symmetry_graph,
-            group,
             bliss_graph);
-        group->set_graph_size(bliss_graph.get_nof_vertices());
+        group->set_graph_size(num_full_vertices);
+        utils::g_log << "Size of the bliss graph: "
+                     << bliss_graph.get_nof_vertices() << endl;
         bliss_graph.set_splitting_heuristic(bliss::Digraph::shs_flm);
         bliss_graph.set_time_limit(time_bound);
         bliss::Stats stats1;
         utils::g_log << "Using Bliss to find group generators" << endl;
-        bliss_graph.canonical_form(stats1,&(add_permutation_to_group),group);
+        bliss_graph.canonical_form(stats1,&(add_permutation_to_group),this);
+        add_operator_class_generators();
         utils::g_log << "Done initializing symmetries: " << timer << endl;
         group->statistics();
         success = true;
@@ -135,38 +158,84 @@ struct DotGraph {
     }
 };
 
+int GraphCreator::add_vertex(bliss::Digraph &bliss_graph, int color) {
+    int vertex = bliss_graph.add_vertex(color);
+    assert(vertex == static_cast<int>(full_vertex.size()));
+    full_vertex.push_back(num_full_vertices++);
+    operator_class.push_back(-1);
+    return vertex;
+}
+
+void GraphCreator::collapse_operators(
+    const TaskProxy &task_proxy,
+    vector<int> &class_size,
+    vector<int> &representative) const {
+    OperatorsProxy operators = task_proxy.get_operators();
+    class_size.assign(operators.size(), 0);
+    representative.resize(operators.size());
+    utils::HashMap<vector<int>, int> representative_by_key;
+    vector<FactPair> facts;
+    vector<int> key;
+    for (OperatorProxy op : operators) {
+        int op_id = op.get_id();
+        representative[op_id] = op_id;
+        EffectsProxy effects = op.get_effects();
+        bool has_conditions = false;
+        for (EffectProxy effect : effects) {
+            if (!effect.get_conditions().empty())
+                has_conditions = true;
+        }
+        if (has_conditions) {
+            class_size[op_id] = 1;
+            continue;
+        }
+
+        key.clear();
+        key.push_back(op.get_cost());
+        for (int part = 0; part < 2; ++part) {
+            facts.clear();
+            if (part == 0) {
+                for (FactProxy fact : op.get_preconditions())
+                    facts.push_back(fact.get_pair());
+            } else {
+                for (EffectProxy effect : effects)
+                    facts.push_back(effect.get_fact().get_pair());
+            }
+            sort(facts.begin(), facts.end());
+            key.push_back(facts.size());
+            for (const FactPair &fact : facts) {
+                key.push_back(fact.var);
+                key.push_back(fact.value);
+            }
+        }
+        representative[op_id] =
+            representative_by_key.insert(make_pair(key, op_id)).first->second;
+        ++class_size[representative[op_id]];
+    }
+}
+
 void GraphCreator::create_bliss_directed_graph(
     const TaskProxy &task_proxy,
     const bool stabilize_initial_state,
     const bool stabilize_goal,
     const bool use_color_for_stabilizing_goal,
     const bool dump_symmetry_graph,
-    Group *group,
-    bliss::Digraph &bliss_graph) const {
+    bliss::Digraph &bliss_graph) {
     // Differ from create_bliss_graph() in (a) having one node per action (incoming arcs from pre, outgoing to eff),
     //                                 and (b) not having a node for goal, recoloring the respective values.
 
     // initialization
     VariablesProxy vars = task_proxy.get_variables();
-    int num_vertices_so_far = vars.size();
-    for (VariableProxy var : vars) {
-        int var_id = var.get_id();
-        group->add_to_dom_sum_by_var(num_vertices_so_far);
-        num_vertices_so_far += var.get_domain_size();
-        for(int num_of_value = 0; num_of_value < var.get_domain_size(); num_of_value++){
-            group->add_to_var_by_val(var_id);
-        }
-    }
-
-    group->set_permutation_num_variables(vars.size());
-    group->set_permutation_num_operators(task_proxy.get_operators().size());
-    group->set_permutation_length(num_vertices_so_far);
+    num_full_vertices = 0;
+    full_vertex.clear();
+    operator_class.clear();
+    operator_class_vertices.clear();
 
     DotGraph dot_graph;
     int vertex = 0;
     // add vertex for each variable
     for (size_t i = 0; i < vars.size(); ++i) {
-       vertex = bliss_graph.add_vertex(VARIABLE_VERTEX);
+       vertex = add_vertex(bliss_graph, VARIABLE_VERTEX);
 
        if (dump_symmetry_graph) {
            dot_graph.add_node(vertex, "var" + to_string(i), dot_colors[VARIABLE_VERTEX]);
@@ -177,7 +246,7 @@ void GraphCreator::create_bliss_directed_graph(
     for (VariableProxy var : vars) {
         int var_id = var.get_id();
         for (int value = 0; value < var.get_domain_size(); value++){
-            vertex = bliss_graph.add_vertex(VALUE_VERTEX);
+            vertex = add_vertex(bliss_graph, VALUE_VERTEX);
             bliss_graph.add_edge(vertex, var_id);
 
             if (dump_symmetry_graph) {
@@ -187,10 +256,40 @@ void GraphCreator::create_bliss_directed_graph(
         }
     }
 
-    // now add vertices for operators
+    // now add vertices for operators, one for each class of interchangeable operators
+    vector<int> class_size;
+    vector<int> representative;
+    collapse_operators(task_proxy, class_size, representative);
+    int max_cost = 0;
     for (OperatorProxy op : task_proxy.get_operators()) {
+        max_cost = max(max_cost, op.get_cost());
+    }
+    // Colors for classes by cost and size, after the colors of single operators.
+    map<pair<int, int>, int> class_colors;
+    vector<int> class_by_representative(representative.size(), -1);
+    int num_collapsed_operators = 0;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        int op_id = op.get_id();
+        if (representative[op_id] != op_id) {
+            // Only reserve the vertex of the operator in the full graph.
+            int class_id = class_by_representative[representative[op_id]];
+            operator_class_vertices[class_id].push_back(num_full_vertices++);
+            ++num_collapsed_operators;
+            continue;
+        }
+
         int color = OPERATOR_VERTEX + op.get_cost();
-        vertex = bliss_graph.add_vertex(color);
+        if (class_size[op_id] > 1) {
+            int new_color = OPERATOR_VERTEX + max_cost + 1 + class_colors.size();
+            color = class_colors.insert(
+                make_pair(make_pair(op.get_cost(), class_size[op_id]), new_color)).first->second;
+        }
+        vertex = add_vertex(bliss_graph, color);
+        if (class_size[op_id] > 1) {
+            class_by_representative[op_id] = operator_class_vertices.size();
+            operator_class[vertex] = class_by_representative[op_id];
+            operator_class_vertices.push_back({full_vertex[vertex]});
+        }
 
         if (dump_symmetry_graph) {
             dot_graph.add_node(
@@ -199,13 +298,16 @@ void GraphCreator::create_bliss_directed_graph(
                 dot_colors[OPERATOR_VERTEX]);
         }
 
-        add_operator_directed_graph(dump_symmetry_graph, group, bliss_graph, dot_graph, op, vertex);
+        add_operator_directed_graph(dump_symmetry_graph, bliss_graph, dot_graph, op, vertex);
     }
+    utils::g_log << "Collapsed " << num_collapsed_operators
+                 << " interchangeable operators into "
+                 << operator_class_vertices.size() << " vertices" << endl;
 
     // now add vertices for axioms
     for (OperatorProxy ax : task_proxy.get_axioms()) {
         int color = AXIOM_VERTEX;  //Assuming 0 cost for axioms
-        vertex = bliss_graph.add_vertex(color);
+        vertex = add_vertex(bliss_graph, color);
 
         if (dump_symmetry_graph) {
             dot_graph.add_node(
@@ -214,7 +316,7 @@ void GraphCreator::create_bliss_directed_graph(
                 dot_colors[AXIOM_VERTEX]);
         }
 
-        add_operator_directed_graph(dump_symmetry_graph, group, bliss_graph, dot_graph, ax, vertex);
+        add_operator_directed_graph(dump_symmetry_graph, bliss_graph, dot_graph, ax, vertex);
     }
 
     if (stabilize_initial_state) {
@@ -225,7 +327,7 @@ void GraphCreator::create_bliss_directed_graph(
           the vertex and either not stabilizing the initial state or the goal
           state, depending on the order of coloring.
         */
-        vertex = bliss_graph.add_vertex(INIT_VERTEX);
+        vertex = add_vertex(bliss_graph, INIT_VERTEX);
 
         if (dump_symmetry_graph) {
             dot_graph.add_node(vertex, "init", dot_colors[INIT_VERTEX]);
@@ -255,7 +357,7 @@ void GraphCreator::create_bliss_directed_graph(
                 }
             }
         } else {
-            vertex = bliss_graph.add_vertex(GOAL_VERTEX);
+            vertex = add_vertex(bliss_graph, GOAL_VERTEX);
 
             if (dump_symmetry_graph) {
                 dot_graph.add_node(vertex, "goal", dot_colors[GOAL_VERTEX]);
@@ -280,11 +382,10 @@ void GraphCreator::create_bliss_directed_graph(
 
 void GraphCreator::add_operator_directed_graph(
     const bool dump_symmetry_graph,
-    Group *group,
     bliss::Digraph &bliss_graph,
     DotGraph &dot_graph,
     const OperatorProxy& op,
-    int op_vertex) const {
+    int op_vertex) {
     PreconditionsProxy preconditions = op.get_preconditions();
     for (FactProxy prec_fact : preconditions) {
         int var_id = prec_fact.get_pair().var;
@@ -320,7 +421,7 @@ void GraphCreator::add_operator_directed_graph(
             if (effect_can_be_overwritten(effect_id, effects)) {
                 effect_color = CONDITIONAL_DELETE_EFFECT_VERTEX;
             }
-            int cond_op_vertex = bliss_graph.add_vertex(effect_color);
+            int cond_op_vertex = add_vertex(bliss_graph, effect_color);
             bliss_graph.add_edge(op_vertex, cond_op_vertex); // Edge from operator to conditional effect
             bliss_graph.add_edge(cond_op_vertex, effect_vertex); // Edge from conditional effect to effect
 
@@ -346,6 +447,44 @@ void GraphCreator::add_operator_directed_graph(
         }
     }
 }
+void GraphCreator::add_bliss_generator(const unsigned int *permutation) {
+    full_permutation.resize(num_full_vertices);
+    for (size_t vertex = 0; vertex < full_vertex.size(); ++vertex) {
+        int image = permutation[vertex];
+        int class_id = operator_class[vertex];
+        if (class_id == -1) {
+            full_permutation[full_vertex[vertex]] = full_vertex[image];
+        } else {
+            // Classes are only mapped to classes of the same size (color).
+            const vector<int> &from = operator_class_vertices[class_id];
+            const vector<int> &to = operator_class_vertices[operator_class[image]];
+            assert(from.size() == to.size());
+            for (size_t i = 0; i < from.size(); ++i) {
+                full_permutation[from[i]] = to[i];
+            }
+        }
+    }
+    group->add_raw_generator(full_permutation.data());
+}
+
+void GraphCreator::add_operator_class_generators() {
+    // A transposition and a cycle generate all permutations of a class.
+    for (const vector<int> &vertices : operator_class_vertices) {
+        int class_size = vertices.size();
+        full_permutation.resize(num_full_vertices);
+        iota(full_permutation.begin(), full_permutation.end(), 0);
+        swap(full_permutation[vertices[0]], full_permutation[vertices[1]]);
+        group->add_raw_generator(full_permutation.data());
+        if (class_size > 2) {
+            iota(full_permutation.begin(), full_permutation.end(), 0);
+            for (int i = 0; i < class_size; ++i) {
+                full_permutation[vertices[i]] = vertices[(i + 1) % class_size];
+            }
+            group->add_raw_generator(full_permutation.data());
+        }
+    }
+}
+
 bool GraphCreator::is_fact_none_of_those(FactProxy fact) const {
     /* Previous implementation!!!
     VariableProxy var = fact.get_variable();
@@ -16,31 +16,58 @@ class TaskProxy;
 /**
  * This class will create a bliss graph which will be used to find the
  * automorphism groups
+ *
+ * The symmetry graph has a vertex for every variable, value, operator,
+ * axiom and conditional effect. Operators without conditional effects
+ * that have the same cost, preconditions and effects are interchangeable,
+ * so the bliss graph only contains one vertex for each class of such
+ * operators, colored by the cost and the size of the class. Generators
+ * found by bliss are lifted to the full graph before they are added to
+ * the group, mapping the i-th operator of a class to the i-th operator of
+ * its image class. The transpositions of interchangeable operators are
+ * added as separate generators.
  */
 
 class GraphCreator  {
+    Group *group;
+    // Number of vertices of the full symmetry graph.
+    int num_full_vertices;
+    // Vertex of the full graph for each vertex of the bliss graph.
+    std::vector<int> full_vertex;
+    // Class of interchangeable operators for each vertex of the bliss graph (or -1).
+    std::vector<int> operator_class;
+    // Vertices of the full graph for each class of interchangeable operators.
+    std::vector<std::vector<int>> operator_class_vertices;
+    std::vector<unsigned int> full_permutation;
+
+    int add_vertex(bliss::Digraph &bliss_graph, int color);
+    void collapse_operators(
+        const TaskProxy &task_proxy,
+        std::vector<int> &class_size,
+        std::vector<int> &representative) const;
     void create_bliss_directed_graph(
         const TaskProxy &task_proxy,
         const bool stabilize_initial_state,
         const bool stabilize_goal,
         const bool use_color_for_stabilizing_goal,
         const bool dump_symmetry_graph,
-        Group *group,
-        bliss::Digraph &bliss_graph) const;
+        bliss::Digraph &bliss_graph);
     void add_operator_directed_graph(
         const bool dump_symmetry_graph,
-        Group *group,
         bliss::Digraph &bliss_graph,
         DotGraph &dot_graph,
         const OperatorProxy &op,
-        int op_vertex) const;
+        int op_vertex);
     bool effect_can_be_overwritten(
         int effect_id,
         const EffectsProxy &effects) const;
     bool is_fact_none_of_those(FactProxy fact) const;
+    void add_operator_class_generators();
 public:
     GraphCreator() = default;
     ~GraphCreator() = default;
+    // Set the sizes and the variable-value layout of the permutations in the group.
+    static void initialize_group(const TaskProxy &task_proxy, Group *group);
     bool compute_symmetries(
         const TaskProxy &task_proxy,
         const bool stabilize_initial_state,
@@ -49,6 +76,7 @@ public:
         const int time_bound,
         const bool dump_symmetry_graph,
         Group *group);
+    void add_bliss_generator(const unsigned int *permutation);
 };
 
 #endif
@@ -9,10 +9,14 @@
 #include "../plugin.h"
 #include "../state_registry.h"
 #include "../task_proxy.h"
-#include "../utils/memory.h"
+#include "../task_utils/task_properties.h"
 #include "../tasks/root_task.h"
+#include "../utils/hash.h"
+#include "../utils/memory.h"
+#include "../utils/timer.h"
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <numeric>
@@ -22,6 +26,9 @@
 using namespace std;
 using namespace utils;
 
+static const char GENERATORS_FILE_MAGIC[8] = {
+    'S', 'Y', 'M', 'G', 'E', 'N', '1', '\0'};
+
 Group::Group(const options::Options &opts)
     : stabilize_initial_state(opts.get<bool>("stabilize_initial_state")),
       stabilize_goal(opts.get<bool>("stabilize_goal")),
@@ -34,6 +41,8 @@ Group::Group(const options::Options &opts)
       write_all_generators(opts.get<bool>("write_all_generators")),
       keep_operator_symmetries(opts.get<bool>("keep_operator_symmetries")),
       keep_state_identity_operator_symmetries(opts.get<bool>("keep_state_identity_operator_symmetries")),
+      generators_file(opts.contains("generators_file") ?
+                      opts.get<string>("generators_file") : string()),
       num_vars(0),
       num_operators(0),
       permutation_length(0),
@@ -71,15 +80,28 @@ void Group::compute_symmetries(const TaskProxy &task_proxy) {
         cerr << "Already computed symmetries" << endl;
         exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
     }
-    GraphCreator graph_creator;
-    bool success = graph_creator.compute_symmetries(
-        task_proxy,
-        stabilize_initial_state,
-        stabilize_goal,
-        use_color_for_stabilizing_goal,
-        time_bound,
-        dump_symmetry_graph,
-        this);
+    GraphCreator::initialize_group(task_proxy, this);
+    uint64_t fingerprint = 0;
+    bool success = false;
+    if (!generators_file.empty()) {
+        fingerprint = compute_fingerprint(task_proxy);
+        success = load_generators(fingerprint);
+    }
+    if (!success) {
+        GraphCreator graph_creator;
+        success = graph_creator.compute_symmetries(
+            task_proxy,
+            stabilize_initial_state,
+            stabilize_goal,
+            use_color_for_stabilizing_goal,
+            time_bound,
+            dump_symmetry_graph,
+            this);
+        if (success && !generators_file.empty()) {
+            save_generators(fingerprint);
+        }
+    }
+    cached_generators.clear();
     if (!success) {
         generators.clear();
     }
@@ -94,6 +116,102 @@ void Group::compute_symmetries(const TaskProxy &task_proxy) {
     }
 }
 
+/*
+  Hash everything that influences the generators: the task and the
+  options of the symmetry graph.
+*/
+uint64_t Group::compute_fingerprint(const TaskProxy &task_proxy) const {
+    utils::HashState hash_state;
+    task_properties::feed_task(hash_state, task_proxy);
+    utils::feed(hash_state, stabilize_initial_state);
+    utils::feed(hash_state, stabilize_goal);
+    utils::feed(hash_state, use_color_for_stabilizing_goal);
+    return hash_state.get_hash64();
+}
+
+static bool read_int(istream &in, int &value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+static void write_int(ostream &out, int value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+bool Group::load_generators(uint64_t fingerprint) {
+    utils::Timer timer;
+    ifstream file(generators_file, ios::binary);
+    char magic[sizeof(GENERATORS_FILE_MAGIC)];
+    uint64_t file_fingerprint;
+    int file_graph_size;
+    int num_generators;
+    if (!file.read(magic, sizeof(magic)) ||
+        memcmp(magic, GENERATORS_FILE_MAGIC, sizeof(magic)) != 0 ||
+        !file.read(reinterpret_cast<char *>(&file_fingerprint),
+                   sizeof(file_fingerprint)) ||
+        file_fingerprint != fingerprint ||
+        !read_int(file, file_graph_size) ||
+        file_graph_size < permutation_length + num_operators ||
+        !read_int(file, num_generators) || num_generators < 0) {
+        return false;
+    }
+
+    // Read and validate everything before changing the group.
+    vector<vector<unsigned int>> raw_generators;
+    vector<bool> is_image(file_graph_size);
+    for (int i = 0; i < num_generators; ++i) {
+        int num_moved;
+        if (!read_int(file, num_moved) || num_moved < 0 ||
+            num_moved > file_graph_size)
+            return false;
+        vector<unsigned int> raw_generator(file_graph_size);
+        iota(raw_generator.begin(), raw_generator.end(), 0);
+        vector<int> images;
+        for (int j = 0; j < num_moved; ++j) {
+            int from;
+            int to;
+            if (!read_int(file, from) || !read_int(file, to) ||
+                from < 0 || from >= file_graph_size ||
+                to < 0 || to >= file_graph_size)
+                return false;
+            raw_generator[from] = to;
+        }
+        // Check that the generator is a permutation.
+        fill(is_image.begin(), is_image.end(), false);
+        for (unsigned int to : raw_generator) {
+            if (is_image[to])
+                return false;
+            is_image[to] = true;
+        }
+        raw_generators.push_back(move(raw_generator));
+    }
+
+    graph_size = file_graph_size;
+    for (const vector<unsigned int> &raw_generator : raw_generators) {
+        add_raw_generator(raw_generator.data());
+    }
+    utils::g_log << "Loaded " << num_generators << " generators from "
+                 << generators_file << ": " << timer << endl;
+    statistics();
+    return true;
+}
+
+void Group::save_generators(uint64_t fingerprint) const {
+    ofstream file(generators_file, ios::binary);
+    file.write(GENERATORS_FILE_MAGIC, sizeof(GENERATORS_FILE_MAGIC));
+    file.write(reinterpret_cast<const char *>(&fingerprint), sizeof(fingerprint));
+    write_int(file, graph_size);
+    write_int(file, cached_generators.size());
+    for (const vector<int> &moved : cached_generators) {
+        write_int(file, moved.size() / 2);
+        for (int vertex : moved) {
+            write_int(file, vertex);
+        }
+    }
+    if (!file) {
+        utils::g_log << "Failed to write generators to " << generators_file << endl;
+    }
+}
+
 void Group::write_generators() const {
     assert(write_search_generators || write_all_generators);
 
@@ -150,6 +268,17 @@ void Group::add_to_be_written_generator(const unsigned int *generator) {
 }
 
 void Group::add_raw_generator(const unsigned int *generator) {
+    if (!generators_file.empty()) {
+        vector<int> moved;
+        for (int from = 0; from < graph_size; ++from) {
+            int to = generator[from];
+            if (from != to) {
+                moved.push_back(from);
+                moved.push_back(to);
+            }
+        }
+        cached_generators.push_back(move(moved));
+    }
     Permutation permutation(*this, generator);
     if (permutation.identity()) {
         ++num_identity_generators;
@@ -440,6 +569,13 @@ static shared_ptr<Group> _parse(OptionParser &parser) {
         "Write all symmetry group generators to a file, including those that "
         "do not affect variables, and stop afterwards.",
         "false");
+    parser.add_option<string>(
+        "generators_file",
+        "binary file for reusing symmetries across runs. If the file "
+        "contains generators for the same task and symmetry graph options, "
+        "they are loaded instead of running Bliss. Otherwise, the computed "
+        "generators are written to the file (unless Bliss fails).",
+        OptionParser::NONE);
 
     Options opts = parser.parse();
 
@@ -1,7 +1,9 @@
 #ifndef STRUCTURAL_SYMMETRIES_GROUP_H
 #define STRUCTURAL_SYMMETRIES_GROUP_H
 
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -38,6 +40,7 @@ class Group {
     const bool write_all_generators;
     const bool keep_operator_symmetries;
     const bool keep_state_identity_operator_symmetries;
+    const std::string generators_file;
 
     // Group properties
     int num_vars;
@@ -55,6 +58,12 @@ class Group {
     std::vector<OperatorPermutation> operator_state_identity_generators;
     std::vector<std::unordered_map<int, int>> to_be_written_generators;
     std::vector<OperatorPermutation> operator_inverse_generators;
+    /*
+      All raw generators in the order in which they were found, as flat
+      lists of (vertex, image) pairs for the moved vertices. Only used
+      for writing generators_file.
+    */
+    std::vector<std::vector<int>> cached_generators;
 
     // Path tracing
     void compute_permutation_trace_to_canonical_representative(const State& state, std::vector<int>&) const;
@@ -63,6 +72,10 @@ class Group {
 
     void write_generators() const;
     void add_to_be_written_generator(const unsigned int *generator);
+
+    uint64_t compute_fingerprint(const TaskProxy &task_proxy) const;
+    bool load_generators(uint64_t fingerprint);
+    void save_generators(uint64_t fingerprint) const;
 public:
     explicit Group(const options::Options &opts);
     ~Group() = default;
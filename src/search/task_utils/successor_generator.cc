@@ -5,6 +5,8 @@
 
 #include "../abstract_task.h"
 
+#include "../utils/profiling.h"
+
 using namespace std;
 
 namespace successor_generator {
@@ -16,6 +18,7 @@ SuccessorGenerator::~SuccessorGenerator() = default;
 
 void SuccessorGenerator::generate_applicable_ops(
     const State &state, vector<OperatorID> &applicable_ops) const {
+    PROFILE_SCOPE("successor generation");
     state.unpack();
     root->generate_applicable_ops(state.get_unpacked_values(), applicable_ops);
 }
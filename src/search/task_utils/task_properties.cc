@@ -1,5 +1,6 @@
 #include "task_properties.h"
 
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
 #include "../utils/system.h"
@@ -100,6 +101,38 @@ int get_num_total_effects(const TaskProxy &task_proxy) {
     return num_effects;
 }
 
+static void feed_operator(utils::HashState &hash_state, const OperatorProxy &op) {
+    utils::feed(hash_state, op.get_cost());
+    for (FactProxy fact : op.get_preconditions())
+        utils::feed(hash_state, fact.get_pair());
+    utils::feed(hash_state, -1);
+    for (EffectProxy effect : op.get_effects()) {
+        for (FactProxy condition : effect.get_conditions())
+            utils::feed(hash_state, condition.get_pair());
+        utils::feed(hash_state, -1);
+        utils::feed(hash_state, effect.get_fact().get_pair());
+    }
+    utils::feed(hash_state, -1);
+}
+
+void feed_task(utils::HashState &hash_state, const TaskProxy &task_proxy) {
+    for (VariableProxy var : task_proxy.get_variables()) {
+        utils::feed(hash_state, var.get_domain_size());
+        utils::feed(hash_state, var.get_axiom_layer());
+        utils::feed(hash_state, var.get_default_axiom_value());
+    }
+    for (OperatorProxy op : task_proxy.get_operators())
+        feed_operator(hash_state, op);
+    utils::feed(hash_state, -1);
+    for (OperatorProxy axiom : task_proxy.get_axioms())
+        feed_operator(hash_state, axiom);
+    utils::feed(hash_state, -1);
+    for (FactProxy goal : task_proxy.get_goals())
+        utils::feed(hash_state, goal.get_pair());
+    utils::feed(hash_state, -1);
+    utils::feed(hash_state, task_proxy.get_initial_state().get_unpacked_values());
+}
+
 void print_variable_statistics(const TaskProxy &task_proxy) {
     const int_packer::IntPacker &state_packer = g_state_packers[task_proxy];
 
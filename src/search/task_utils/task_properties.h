@@ -7,6 +7,10 @@
 #include "../algorithms/int_packer.h"
 #include "../plan_manager.h"
 
+namespace utils {
+class HashState;
+}
+
 namespace task_properties {
 inline bool is_applicable(OperatorProxy op, const State &state) {
     for (FactProxy precondition : op.get_preconditions()) {
@@ -77,6 +81,14 @@ std::vector<FactPair> get_fact_pairs(const FactProxyCollection &facts) {
     return fact_pairs;
 }
 
+/*
+  Feed the variables, operators, axioms, goals and initial state of the
+  task into the hash state. This is used to recognize files that store
+  results computed for the same task.
+  Runtime: O(n), where n is the size of the task.
+*/
+extern void feed_task(utils::HashState &hash_state, const TaskProxy &task_proxy);
+
 extern void print_variable_statistics(const TaskProxy &task_proxy);
 extern void dump_pddl(const State &state);
 extern void dump_fdr(const State &state);
@@ -0,0 +1,135 @@
+#include "binary_task_file.h"
+
+#include "../utils/system.h"
+
+#include <cassert>
+#include <cstring>
+#include <iterator>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using utils::ExitCode;
+
+namespace tasks {
+static const char MAGIC[] = "FDSASBIN";
+static const size_t MAGIC_LENGTH = 8;
+static const size_t SECTION_TABLE_START =
+    MAGIC_LENGTH + BinaryTaskFile::NUM_HEADER_VALUES * sizeof(int32_t);
+static const size_t HEADER_SIZE =
+    SECTION_TABLE_START + BinaryTaskFile::NUM_SECTIONS * sizeof(int64_t);
+
+static void input_error(const string &msg) {
+    cerr << "Invalid binary task: " << msg << endl;
+    utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+}
+
+int BinaryTaskFile::Reader::read_int() {
+    if (pos + sizeof(int32_t) > file->size)
+        input_error("unexpected end of data");
+    int32_t value;
+    memcpy(&value, file->data + pos, sizeof(value));
+    pos += sizeof(value);
+    return value;
+}
+
+int64_t BinaryTaskFile::Reader::read_int64() {
+    if (pos + sizeof(int64_t) > file->size)
+        input_error("unexpected end of data");
+    int64_t value;
+    memcpy(&value, file->data + pos, sizeof(value));
+    pos += sizeof(value);
+    return value;
+}
+
+BinaryTaskFile::BinaryTaskFile(istream &in)
+    : data(nullptr),
+      size(0),
+      mapped_data(nullptr) {
+    uint32_t byte_order_test = 1;
+    if (*reinterpret_cast<char *>(&byte_order_test) != 1)
+        input_error("binary tasks can only be read on little-endian systems");
+
+    map_or_read(in);
+    if (size < HEADER_SIZE || memcmp(data, MAGIC, MAGIC_LENGTH) != 0)
+        input_error("missing header");
+    int version = get_header_value(VERSION);
+    if (version != BINARY_TASK_FORMAT_VERSION) {
+        input_error("expected format version " +
+                    to_string(BINARY_TASK_FORMAT_VERSION) + ", got " +
+                    to_string(version));
+    }
+
+    num_names = get_header_value(NUM_NAMES);
+    names_offsets_start = get_section(NAMES).get_position();
+    names_data_start = names_offsets_start + (num_names + 1) * sizeof(int64_t);
+    if (num_names < 0 || names_data_start > static_cast<int64_t>(size))
+        input_error("invalid name table");
+}
+
+BinaryTaskFile::~BinaryTaskFile() {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    if (mapped_data)
+        munmap(mapped_data, size);
+#endif
+}
+
+void BinaryTaskFile::map_or_read(istream &in) {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    /*
+      The planner reads its input from stdin, which is usually redirected
+      from the task file. In this case, we map the file instead of reading
+      it. The mapping does not depend on the position of the stream.
+    */
+    struct stat file_status;
+    if (&in == &cin && fstat(STDIN_FILENO, &file_status) == 0 &&
+        S_ISREG(file_status.st_mode) && file_status.st_size > 0) {
+        void *mapping = mmap(nullptr, file_status.st_size, PROT_READ,
+                             MAP_PRIVATE, STDIN_FILENO, 0);
+        if (mapping != MAP_FAILED) {
+            mapped_data = mapping;
+            data = static_cast<const char *>(mapping);
+            size = file_status.st_size;
+            return;
+        }
+    }
+#endif
+    buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+}
+
+bool BinaryTaskFile::is_binary_task(istream &in) {
+    return in.peek() == MAGIC[0];
+}
+
+int BinaryTaskFile::get_header_value(HeaderValue value) const {
+    assert(value >= 0 && value < NUM_HEADER_VALUES);
+    return Reader(*this, MAGIC_LENGTH + value * sizeof(int32_t)).read_int();
+}
+
+BinaryTaskFile::Reader BinaryTaskFile::get_section(Section section) const {
+    int64_t offset = Reader(
+        *this, SECTION_TABLE_START + section * sizeof(int64_t)).read_int64();
+    if (offset < static_cast<int64_t>(HEADER_SIZE) ||
+        offset > static_cast<int64_t>(size)) {
+        input_error("invalid section offset");
+    }
+    return Reader(*this, offset);
+}
+
+string BinaryTaskFile::get_name(int name_id) const {
+    if (name_id < 0 || name_id >= num_names)
+        input_error("invalid name ID " + to_string(name_id));
+    Reader reader(*this, names_offsets_start + name_id * sizeof(int64_t));
+    int64_t begin = names_data_start + reader.read_int64();
+    int64_t end = names_data_start + reader.read_int64();
+    if (begin > end || end > static_cast<int64_t>(size))
+        input_error("invalid name table");
+    return string(data + begin, end - begin);
+}
+}
@@ -0,0 +1,125 @@
+#ifndef TASKS_BINARY_TASK_FILE_H
+#define TASKS_BINARY_TASK_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace tasks {
+/*
+  Binary alternative to the textual translator output format. It is
+  written by the translator and the h2 preprocessor with --binary-output
+  and read by the search component, which detects the format by the magic
+  bytes at the start of its input.
+
+  All numbers are little-endian. Unless stated otherwise, numbers are
+  32-bit signed integers.
+
+  Header (96 bytes):
+    8 bytes   magic "FDSASBIN"
+    version (BINARY_TASK_FORMAT_VERSION), metric (0 or 1),
+    number of variables, mutex groups, operators, axioms and names,
+    one integer that must be 0
+    seven 64-bit offsets from the start of the file to the sections below
+
+  Sections:
+    variables:     per variable: name ID, axiom layer, domain size and one
+                   name ID per value
+    mutex groups:  per group: number of facts, then (var, value) per fact
+    initial state: one value per variable
+    goal:          number of facts, then (var, value) per fact
+    operators:     per operator: name ID, cost, number of prevail
+                   conditions, (var, value) per prevail condition, number of
+                   effects, then per effect: number of effect conditions,
+                   (var, value) per condition, var, value before (or -1)
+                   and value after
+    axioms:        per axiom: number of conditions, (var, value) per
+                   condition, var, value before and value after
+    names:         64-bit offsets of the names 0, ..., n (name i consists of
+                   the bytes between offsets i and i + 1, where offsets are
+                   relative to the end of the offset table), then the bytes
+                   of all names
+
+  Names are stored once, so identical fact names share an ID.
+*/
+static const int BINARY_TASK_FORMAT_VERSION = 1;
+
+/*
+  The bytes of a binary task. If the input is a regular file on a POSIX
+  system, it is memory-mapped, otherwise it is copied into memory. The
+  data is kept alive as long as the object exists, so names can be looked
+  up lazily.
+*/
+class BinaryTaskFile {
+    const char *data;
+    std::size_t size;
+    void *mapped_data;
+    std::vector<char> buffer;
+
+    int64_t names_offsets_start;
+    int64_t names_data_start;
+    int num_names;
+
+    void map_or_read(std::istream &in);
+public:
+    enum HeaderValue {
+        VERSION,
+        METRIC,
+        NUM_VARIABLES,
+        NUM_MUTEX_GROUPS,
+        NUM_OPERATORS,
+        NUM_AXIOMS,
+        NUM_NAMES,
+        RESERVED,
+        NUM_HEADER_VALUES
+    };
+
+    enum Section {
+        VARIABLES,
+        MUTEXES,
+        INITIAL_STATE,
+        GOAL,
+        OPERATORS,
+        AXIOMS,
+        NAMES,
+        NUM_SECTIONS
+    };
+
+    /*
+      Sequential reader for the integers of one section. All reads are
+      bounds-checked and exit with an input error if the data is truncated.
+    */
+    class Reader {
+        const BinaryTaskFile *file;
+        std::size_t pos;
+    public:
+        Reader(const BinaryTaskFile &file, std::size_t pos)
+            : file(&file), pos(pos) {
+        }
+        int read_int();
+        int64_t read_int64();
+        std::size_t get_position() const {
+            return pos;
+        }
+    };
+
+    explicit BinaryTaskFile(std::istream &in);
+    ~BinaryTaskFile();
+    BinaryTaskFile(const BinaryTaskFile &) = delete;
+    BinaryTaskFile &operator=(const BinaryTaskFile &) = delete;
+
+    // Return true iff the next character of the stream starts the magic bytes.
+    static bool is_binary_task(std::istream &in);
+
+    int get_header_value(HeaderValue value) const;
+    Reader get_section(Section section) const;
+    std::string get_name(int name_id) const;
+    int get_num_names() const {
+        return num_names;
+    }
+};
+}
+
+#endif
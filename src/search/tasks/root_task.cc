@@ -1,10 +1,13 @@
 #include "root_task.h"
 
+#include "binary_task_file.h"
+
 #include "../option_parser.h"
 #include "../plugin.h"
 #include "../state_registry.h"
 
 #include "../utils/collections.h"
+#include "../utils/memory.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
@@ -28,10 +31,15 @@ struct ExplicitVariable {
     vector<string> fact_names;
     int axiom_layer;
     int axiom_default_value;
+    // Name IDs of binary tasks (-1 and no fact name IDs for textual input).
+    int name_id;
+    vector<int> fact_name_ids;
 
     explicit ExplicitVariable(istream &in);
-    // Empty variable
-    ExplicitVariable() {}
+    explicit ExplicitVariable(BinaryTaskFile::Reader &reader);
+    // Variable that is not part of the input (no axiom layer).
+    ExplicitVariable(
+        const string &name, vector<string> &&fact_names, int axiom_default_value);
 };
 
 
@@ -48,16 +56,42 @@ struct ExplicitOperator {
     vector<ExplicitEffect> effects;
     int cost;
     string name;
+    // Name ID of binary tasks (-1 for textual input and axioms).
+    int name_id;
     bool is_an_axiom;
 
     void read_pre_post(istream &in);
+    void read_pre_post(BinaryTaskFile::Reader &reader);
     ExplicitOperator(istream &in, bool is_an_axiom, bool use_metric);
-    // Empty operator
-    ExplicitOperator() {};
+    ExplicitOperator(
+        BinaryTaskFile::Reader &reader, bool is_an_axiom, bool use_metric);
+    // Operator that is not part of the input (no preconditions and effects).
+    ExplicitOperator(const string &name, int cost);
 };
 
 
+/*
+  K* needs a task with a single goal state, so the root task reformulates
+  the task read from the input after reading it:
+
+  - Every variable gets an extra value "goal value", which is the last
+    value of its domain.
+  - An extra binary variable (the last variable) is 0 in the initial state
+    and 1 in the goal.
+  - Every operator gets the extra precondition that the extra variable
+    is 0. This precondition comes last.
+  - An extra operator with cost 0 (the last operator) has the goal of the
+    input task and the extra variable being 0 as preconditions and sets
+    all variables to their goal value.
+  - The goal assigns the goal value to every variable.
+
+  The added parts are stored like the rest of the task, so queries cost
+  the same as for the input task. UndoSingeGoalTask reverts this
+  reformulation.
+*/
 class RootTask : public AbstractTask {
+    // Only set for binary input. Names are looked up in it on demand.
+    unique_ptr<BinaryTaskFile> binary_file;
     vector<ExplicitVariable> variables;
     // TODO: think about using hash sets here.
     vector<vector<set<FactPair>>> mutexes;
@@ -70,8 +104,11 @@ class RootTask : public AbstractTask {
     const ExplicitEffect &get_effect(int op_id, int effect_id, bool is_axiom) const;
     const ExplicitOperator &get_operator_or_axiom(int index, bool is_axiom) const;
 
+    void add_single_goal_reformulation();
+
 public:
     explicit RootTask(istream &in);
+    explicit RootTask(unique_ptr<BinaryTaskFile> binary_file);
 
     virtual int get_num_variables() const override;
     virtual string get_variable_name(int var) const override;
@@ -153,6 +190,18 @@ void check_magic(istream &in, const string &magic) {
     }
 }
 
+vector<FactPair> read_facts(BinaryTaskFile::Reader &reader) {
+    int count = reader.read_int();
+    vector<FactPair> facts;
+    facts.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        int var = reader.read_int();
+        int value = reader.read_int();
+        facts.emplace_back(var, value);
+    }
+    return facts;
+}
+
 vector<FactPair> read_facts(istream &in) {
     int count;
     in >> count;
@@ -166,7 +215,8 @@ vector<FactPair> read_facts(istream &in) {
     return conditions;
 }
 
-ExplicitVariable::ExplicitVariable(istream &in) {
+ExplicitVariable::ExplicitVariable(istream &in)
+    : name_id(-1) {
     check_magic(in, "begin_variable");
     in >> name;
     in >> axiom_layer;
@@ -178,6 +228,29 @@ ExplicitVariable::ExplicitVariable(istream &in) {
     check_magic(in, "end_variable");
 }
 
+ExplicitVariable::ExplicitVariable(
+    const string &name, vector<string> &&fact_names, int axiom_default_value)
+    : domain_size(fact_names.size()),
+      name(name),
+      fact_names(move(fact_names)),
+      axiom_layer(-1),
+      axiom_default_value(axiom_default_value),
+      name_id(-1) {
+}
+
+ExplicitVariable::ExplicitVariable(BinaryTaskFile::Reader &reader) {
+    name_id = reader.read_int();
+    axiom_layer = reader.read_int();
+    domain_size = reader.read_int();
+    if (domain_size < 1) {
+        cerr << "Invalid domain size: " << domain_size << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    fact_name_ids.resize(domain_size);
+    for (int i = 0; i < domain_size; ++i)
+        fact_name_ids[i] = reader.read_int();
+}
+
 
 ExplicitEffect::ExplicitEffect(
     int var, int value, vector<FactPair> &&conditions)
@@ -195,8 +268,20 @@ void ExplicitOperator::read_pre_post(istream &in) {
     effects.emplace_back(var, value_post, move(conditions));
 }
 
+void ExplicitOperator::read_pre_post(BinaryTaskFile::Reader &reader) {
+    vector<FactPair> conditions = read_facts(reader);
+    int var = reader.read_int();
+    int value_pre = reader.read_int();
+    int value_post = reader.read_int();
+    if (value_pre != -1) {
+        preconditions.emplace_back(var, value_pre);
+    }
+    effects.emplace_back(var, value_post, move(conditions));
+}
+
 ExplicitOperator::ExplicitOperator(istream &in, bool is_an_axiom, bool use_metric)
-    : is_an_axiom(is_an_axiom) {
+    : name_id(-1),
+      is_an_axiom(is_an_axiom) {
     if (!is_an_axiom) {
         check_magic(in, "begin_operator");
         in >> ws;
@@ -223,6 +308,38 @@ ExplicitOperator::ExplicitOperator(istream &in, bool is_an_axiom, bool use_metri
     assert(cost >= 0);
 }
 
+ExplicitOperator::ExplicitOperator(
+    BinaryTaskFile::Reader &reader, bool is_an_axiom, bool use_metric)
+    : name_id(-1),
+      is_an_axiom(is_an_axiom) {
+    if (!is_an_axiom) {
+        name_id = reader.read_int();
+        int op_cost = reader.read_int();
+        cost = use_metric ? op_cost : 1;
+        preconditions = read_facts(reader);
+        int count = reader.read_int();
+        effects.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            read_pre_post(reader);
+        }
+    } else {
+        name = "<axiom>";
+        cost = 0;
+        read_pre_post(reader);
+    }
+    if (cost < 0) {
+        cerr << "Invalid operator cost: " << cost << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+ExplicitOperator::ExplicitOperator(const string &name, int cost)
+    : cost(cost),
+      name(name),
+      name_id(-1),
+      is_an_axiom(false) {
+}
+
 void read_and_verify_version(istream &in) {
     int version;
     check_magic(in, "begin_version");
@@ -255,6 +372,27 @@ vector<ExplicitVariable> read_variables(istream &in) {
     return variables;
 }
 
+void add_mutex_group(const vector<FactPair> &invariant_group,
+                     vector<vector<set<FactPair>>> &inconsistent_facts) {
+    for (const FactPair &fact1 : invariant_group) {
+        for (const FactPair &fact2 : invariant_group) {
+            if (fact1.var != fact2.var) {
+                /* The "different variable" test makes sure we
+                   don't mark a fact as mutex with itself
+                   (important for correctness) and don't include
+                   redundant mutexes (important to conserve
+                   memory). Note that the translator (at least
+                   with default settings) removes mutex groups
+                   that contain *only* redundant mutexes, but it
+                   can of course generate mutex groups which lead
+                   to *some* redundant mutexes, where some but not
+                   all facts talk about the same variable. */
+                inconsistent_facts[fact1.var][fact1.value].insert(fact2);
+            }
+        }
+    }
+}
+
 vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<ExplicitVariable> &variables) {
     vector<vector<set<FactPair>>> inconsistent_facts(variables.size());
     for (size_t i = 0; i < variables.size(); ++i)
@@ -283,27 +421,26 @@ vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<ExplicitVar
             invariant_group.emplace_back(var, value);
         }
         check_magic(in, "end_mutex_group");
-        for (const FactPair &fact1 : invariant_group) {
-            for (const FactPair &fact2 : invariant_group) {
-                if (fact1.var != fact2.var) {
-                    /* The "different variable" test makes sure we
-                       don't mark a fact as mutex with itself
-                       (important for correctness) and don't include
-                       redundant mutexes (important to conserve
-                       memory). Note that the translator (at least
-                       with default settings) removes mutex groups
-                       that contain *only* redundant mutexes, but it
-                       can of course generate mutex groups which lead
-                       to *some* redundant mutexes, where some but not
-                       all facts talk about the same variable. */
-                    inconsistent_facts[fact1.var][fact1.value].insert(fact2);
-                }
-            }
-        }
+        add_mutex_group(invariant_group, inconsistent_facts);
     }
     return inconsistent_facts;
 }
 
+vector<vector<set<FactPair>>> read_mutexes(
+    BinaryTaskFile::Reader &reader, int num_mutex_groups,
+    const vector<ExplicitVariable> &variables) {
+    vector<vector<set<FactPair>>> inconsistent_facts(variables.size());
+    for (size_t i = 0; i < variables.size(); ++i)
+        inconsistent_facts[i].resize(variables[i].domain_size);
+    for (int i = 0; i < num_mutex_groups; ++i) {
+        vector<FactPair> invariant_group = read_facts(reader);
+        check_facts(invariant_group, variables);
+        add_mutex_group(invariant_group, inconsistent_facts);
+    }
+    return inconsistent_facts;
+}
+
+
 vector<FactPair> read_goal(istream &in) {
     check_magic(in, "begin_goal");
     vector<FactPair> goals = read_facts(in);
@@ -355,65 +492,104 @@ RootTask::RootTask(istream &in) {
     /* TODO: We should be stricter here and verify that we
        have reached the end of "in". */
 
-    /* Adding the extra variable and the extra action to make the task into a single goal state task
-       Extra variable is binary, changes from in the initial state 0 to 1 in the goal.
-       Extra action has the old goal as a precondition, sets all non-goal variable values to an extra value.
-       All actions have another precondition extra var in 0, extra actions sets it to 1.
+    add_single_goal_reformulation();
+
+    /*
+      HACK: We use a TaskProxy to access g_axiom_evaluators here which assumes
+      that this task is completely constructed.
     */
+    AxiomEvaluator &axiom_evaluator = g_axiom_evaluators[TaskProxy(*this)];
+    axiom_evaluator.evaluate(initial_state_values);
+}
 
-    // Variables
-    // Add value to the domain, for all original variables
+RootTask::RootTask(unique_ptr<BinaryTaskFile> binary_file_)
+    : binary_file(move(binary_file_)) {
+    bool use_metric = binary_file->get_header_value(BinaryTaskFile::METRIC);
+    int num_variables = binary_file->get_header_value(BinaryTaskFile::NUM_VARIABLES);
+
+    BinaryTaskFile::Reader reader = binary_file->get_section(BinaryTaskFile::VARIABLES);
+    variables.reserve(num_variables);
     for (int i = 0; i < num_variables; ++i) {
-        variables[i].domain_size++;
-        variables[i].fact_names.push_back("Atom __goal_value()");
-    }
-    variables.push_back(ExplicitVariable());
-    variables[variables.size() - 1].domain_size = 2;
-    variables[variables.size() - 1].name = "__extra_goal_var";
-    variables[variables.size() - 1].axiom_layer = -1;
-    variables[variables.size() - 1].fact_names.push_back("NegatedAtom __goal_reached()");
-    variables[variables.size() - 1].fact_names.push_back("Atom __goal_reached()");
-    variables[variables.size() - 1].axiom_default_value = 0;
-    initial_state_values.push_back(0);
+        variables.emplace_back(reader);
+    }
 
-    // Assigning new goal values
-    std::vector<int> new_goal_values;
-    for (auto var : variables) {
-        new_goal_values.push_back(var.domain_size - 1);
+    reader = binary_file->get_section(BinaryTaskFile::MUTEXES);
+    mutexes = read_mutexes(
+        reader, binary_file->get_header_value(BinaryTaskFile::NUM_MUTEX_GROUPS),
+        variables);
+
+    reader = binary_file->get_section(BinaryTaskFile::INITIAL_STATE);
+    initial_state_values.resize(num_variables);
+    for (int i = 0; i < num_variables; ++i) {
+        initial_state_values[i] = reader.read_int();
+        check_fact(FactPair(i, initial_state_values[i]), variables);
+        variables[i].axiom_default_value = initial_state_values[i];
     }
-    // // Rewriting for old goals
-    // for (auto fact : goals) {
-    //     new_goal_values[fact.var] = fact.value;
-    // }
 
-    // Operators
-    for (ExplicitOperator &op : operators) {
-        // Adding the precondition on the extra variable to all original actions  
-        op.preconditions.push_back(FactPair(num_variables, 0));
-    }
-
-    // Adding an extra operator, preconditioned by original goal, and changing the value of all 
-    // variables to the extra value
-    operators.push_back(ExplicitOperator());
-    operators[operators.size() - 1].cost = 0;
-    operators[operators.size() - 1].name = "__extra_goal_operator";
-    operators[operators.size() - 1].is_an_axiom = false;
-    operators[operators.size() - 1].preconditions = move(goals);
-    operators[operators.size() - 1].preconditions.push_back(FactPair(num_variables, 0));
-    goals.clear(); // Assigning new goal values
-    for (int i = 0; i <= num_variables; ++i) {
-        int goal_val = new_goal_values[i];
-        operators[operators.size() - 1].effects.push_back(ExplicitEffect(i, goal_val, vector<FactPair>()));
-        goals.push_back(FactPair(i, goal_val));
+    reader = binary_file->get_section(BinaryTaskFile::GOAL);
+    goals = read_facts(reader);
+    if (goals.empty()) {
+        cerr << "Task has no goal condition!" << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
     }
-    /*
-      HACK: We use a TaskProxy to access g_axiom_evaluators here which assumes
-      that this task is completely constructed.
-    */
+    check_facts(goals, variables);
+
+    for (bool is_axiom : {false, true}) {
+        vector<ExplicitOperator> &actions = is_axiom ? axioms : operators;
+        int count = binary_file->get_header_value(
+            is_axiom ? BinaryTaskFile::NUM_AXIOMS : BinaryTaskFile::NUM_OPERATORS);
+        reader = binary_file->get_section(
+            is_axiom ? BinaryTaskFile::AXIOMS : BinaryTaskFile::OPERATORS);
+        actions.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            actions.emplace_back(reader, is_axiom, use_metric);
+            check_facts(actions.back(), variables);
+        }
+    }
+
+    add_single_goal_reformulation();
+
+    // See above.
     AxiomEvaluator &axiom_evaluator = g_axiom_evaluators[TaskProxy(*this)];
     axiom_evaluator.evaluate(initial_state_values);
 }
 
+void RootTask::add_single_goal_reformulation() {
+    int num_variables = variables.size();
+    FactPair extra_precondition(num_variables, 0);
+
+    for (int var = 0; var < num_variables; ++var) {
+        ExplicitVariable &variable = variables[var];
+        // Binary tasks only store the names of the values in the input.
+        variable.fact_names.resize(variable.domain_size);
+        variable.fact_names.push_back("Atom __goal_value()");
+        ++variable.domain_size;
+        // We know no mutexes for the goal values.
+        mutexes[var].emplace_back();
+    }
+    variables.emplace_back(
+        "__extra_goal_var",
+        vector<string>{"NegatedAtom __goal_reached()", "Atom __goal_reached()"},
+        0);
+    mutexes.emplace_back(2);
+    initial_state_values.push_back(0);
+
+    for (ExplicitOperator &op : operators) {
+        op.preconditions.push_back(extra_precondition);
+    }
+
+    ExplicitOperator goal_operator("__extra_goal_operator", 0);
+    goal_operator.preconditions = move(goals);
+    goal_operator.preconditions.push_back(extra_precondition);
+    goals.clear();
+    for (int var = 0; var <= num_variables; ++var) {
+        FactPair goal(var, variables[var].domain_size - 1);
+        goal_operator.effects.emplace_back(goal.var, goal.value, vector<FactPair>());
+        goals.push_back(goal);
+    }
+    operators.push_back(move(goal_operator));
+}
+
 const ExplicitVariable &RootTask::get_variable(int var) const {
     assert(utils::in_bounds(var, variables));
     return variables[var];
@@ -442,7 +618,10 @@ int RootTask::get_num_variables() const {
 }
 
 string RootTask::get_variable_name(int var) const {
-    return get_variable(var).name;
+    const ExplicitVariable &variable = get_variable(var);
+    if (variable.name_id != -1)
+        return binary_file->get_name(variable.name_id);
+    return variable.name;
 }
 
 int RootTask::get_variable_domain_size(int var) const {
@@ -458,8 +637,12 @@ int RootTask::get_variable_default_axiom_value(int var) const {
 }
 
 string RootTask::get_fact_name(const FactPair &fact) const {
-    assert(utils::in_bounds(fact.value, get_variable(fact.var).fact_names));
-    return get_variable(fact.var).fact_names[fact.value];
+    const ExplicitVariable &variable = get_variable(fact.var);
+    // Only the values in the input have name IDs.
+    if (utils::in_bounds(fact.value, variable.fact_name_ids))
+        return binary_file->get_name(variable.fact_name_ids[fact.value]);
+    assert(utils::in_bounds(fact.value, variable.fact_names));
+    return variable.fact_names[fact.value];
 }
 
 bool RootTask::are_facts_mutex(const FactPair &fact1, const FactPair &fact2) const {
@@ -477,7 +660,10 @@ int RootTask::get_operator_cost(int index, bool is_axiom) const {
 }
 
 string RootTask::get_operator_name(int index, bool is_axiom) const {
-    return get_operator_or_axiom(index, is_axiom).name;
+    const ExplicitOperator &op = get_operator_or_axiom(index, is_axiom);
+    if (op.name_id != -1)
+        return binary_file->get_name(op.name_id);
+    return op.name;
 }
 
 int RootTask::get_num_operators() const {
@@ -550,7 +736,10 @@ void RootTask::convert_ancestor_state_values(
 
 void read_root_task(istream &in) {
     assert(!g_root_task);
-    g_root_task = make_shared<RootTask>(in);
+    if (BinaryTaskFile::is_binary_task(in))
+        g_root_task = make_shared<RootTask>(utils::make_unique_ptr<BinaryTaskFile>(in));
+    else
+        g_root_task = make_shared<RootTask>(in);
 }
 
 static shared_ptr<AbstractTask> _parse(OptionParser &parser) {
@@ -20,7 +20,7 @@ void continuing_out_of_memory_handler() {
 
 void reserve_extra_memory_padding(int memory_in_mb) {
     assert(!extra_memory_padding);
-    extra_memory_padding = new char[memory_in_mb * 1024 * 1024];
+    extra_memory_padding = new char[static_cast<size_t>(memory_in_mb) * 1024 * 1024];
     standard_out_of_memory_handler = set_new_handler(continuing_out_of_memory_handler);
 }
 
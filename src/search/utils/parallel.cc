@@ -0,0 +1,85 @@
+#include "parallel.h"
+
+#include "logging.h"
+#include "system.h"
+
+#include "../options/option_parser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace utils {
+void add_num_threads_option_to_parser(options::OptionParser &parser) {
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads used for independent preprocessing computations. "
+        "Set to 0 to use all hardware threads. Results do not depend on the "
+        "number of threads.",
+        "1",
+        options::Bounds("0", "infinity"));
+}
+
+int get_num_threads_from_options(const options::Options &options) {
+    int num_threads = options.get<int>("num_threads");
+    if (num_threads == 0) {
+        num_threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+    return num_threads;
+}
+
+ParallelForStatus try_parallel_for(
+    int num_threads, int num_tasks, const function<void(int)> &task) {
+    num_threads = min(num_threads, num_tasks);
+
+    /*
+      The regular out-of-memory handler exits the planner, which must not
+      happen on a worker thread. Without a handler, operator new throws
+      std::bad_alloc, which we catch and report to the calling thread.
+    */
+    new_handler previous_handler = set_new_handler(nullptr);
+    atomic<int> next_task(0);
+    atomic<bool> out_of_memory(false);
+    auto work = [&]() {
+        try {
+            for (int i = next_task++; i < num_tasks && !out_of_memory;
+                 i = next_task++) {
+                task(i);
+            }
+        } catch (const bad_alloc &) {
+            out_of_memory = true;
+        }
+    };
+
+    if (num_threads <= 1) {
+        work();
+    } else {
+        vector<thread> workers;
+        workers.reserve(num_threads - 1);
+        for (int i = 0; i < num_threads - 1; ++i) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (thread &worker : workers) {
+            worker.join();
+        }
+    }
+    set_new_handler(previous_handler);
+
+    return out_of_memory ? ParallelForStatus::OUT_OF_MEMORY
+           : ParallelForStatus::FINISHED;
+}
+
+void parallel_for(
+    int num_threads, int num_tasks, const function<void(int)> &task) {
+    if (try_parallel_for(num_threads, num_tasks, task) ==
+        ParallelForStatus::OUT_OF_MEMORY) {
+        g_log << "Failed to allocate memory in parallel tasks." << endl;
+        exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+}
+}
@@ -0,0 +1,56 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <functional>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace utils {
+// Add num_threads option to parser.
+extern void add_num_threads_option_to_parser(options::OptionParser &parser);
+
+/*
+  Return the number of worker threads requested via "num_threads". A value
+  of 0 selects the number of hardware threads. Only use this together with
+  "add_num_threads_option_to_parser()".
+*/
+extern int get_num_threads_from_options(const options::Options &options);
+
+enum class ParallelForStatus {
+    FINISHED,
+    OUT_OF_MEMORY
+};
+
+/*
+  Call task(i) for all i in [0, num_tasks), distributing the calls over at
+  most num_threads threads. The calling thread participates in the work and
+  the function returns once all calls have finished. With num_threads <= 1
+  the calls are made sequentially in increasing order of i.
+
+  Tasks must not depend on each other and must only write to memory owned
+  by their index (e.g., slot i of a preallocated vector). Results are
+  therefore independent of the number of threads, which keeps callers
+  deterministic as long as they combine the per-index results in index
+  order afterwards.
+
+  Tasks must not throw and must not use the global RNG or the global log.
+  While the tasks run, failed allocations throw std::bad_alloc instead of
+  exiting the planner. If this happens, no further tasks are started and
+  the function returns OUT_OF_MEMORY after all threads have finished. The
+  per-index results are then incomplete.
+*/
+extern ParallelForStatus try_parallel_for(
+    int num_threads, int num_tasks, const std::function<void(int)> &task);
+
+/*
+  Like try_parallel_for, but exit the planner from the calling thread if
+  the tasks run out of memory.
+*/
+extern void parallel_for(
+    int num_threads, int num_tasks, const std::function<void(int)> &task);
+}
+
+#endif
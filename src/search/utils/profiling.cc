@@ -0,0 +1,94 @@
+#include "profiling.h"
+
+#include "logging.h"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+
+using namespace std;
+
+namespace utils {
+ProfilingComponent::ProfilingComponent(const string &name)
+    : name(name),
+      count(0),
+      total_ns(0) {
+    buckets.fill(0);
+}
+
+int ProfilingComponent::get_bucket(uint64_t ns) {
+    if (ns < 4)
+        return ns;
+    int most_significant_bit = 0;
+    for (uint64_t value = ns; value > 1; value >>= 1)
+        ++most_significant_bit;
+    int sub_bucket = (ns >> (most_significant_bit - 2)) & 3;
+    return 4 * (most_significant_bit - 1) + sub_bucket;
+}
+
+uint64_t ProfilingComponent::get_bucket_upper_bound(int bucket) {
+    if (bucket < 4)
+        return bucket + 1;
+    int most_significant_bit = bucket / 4 + 1;
+    uint64_t width = uint64_t(1) << (most_significant_bit - 2);
+    uint64_t lower_bound = (4 + bucket % 4) * width;
+    if (lower_bound > numeric_limits<uint64_t>::max() - width)
+        return numeric_limits<uint64_t>::max();
+    return lower_bound + width;
+}
+
+double ProfilingComponent::get_total_time() const {
+    return total_ns / 1e9;
+}
+
+double ProfilingComponent::get_percentile(double p) const {
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+        seen += buckets[bucket];
+        if (seen > 0 && seen >= p * count)
+            return get_bucket_upper_bound(bucket) / 1e9;
+    }
+    return 0;
+}
+
+// The deque keeps references to components valid when it grows.
+static deque<ProfilingComponent> &get_all_components() {
+    static deque<ProfilingComponent> components;
+    return components;
+}
+
+ProfilingComponent &get_profiling_component(const string &name) {
+    static unordered_map<string, ProfilingComponent *> components_by_name;
+    ProfilingComponent *&component = components_by_name[name];
+    if (!component) {
+        get_all_components().emplace_back(name);
+        component = &get_all_components().back();
+    }
+    return *component;
+}
+
+vector<const ProfilingComponent *> get_profiling_components() {
+    vector<const ProfilingComponent *> components;
+    for (const ProfilingComponent &component : get_all_components()) {
+        if (component.get_count() > 0)
+            components.push_back(&component);
+    }
+    sort(components.begin(), components.end(),
+         [](const ProfilingComponent *a, const ProfilingComponent *b) {
+             return a->get_name() < b->get_name();
+         });
+    return components;
+}
+
+void print_profiling_statistics() {
+    for (const ProfilingComponent *component : get_profiling_components()) {
+        g_log << "Profile " << component->get_name() << ": "
+              << component->get_count() << " calls, "
+              << "total " << component->get_total_time() << "s, "
+              << "p50 " << component->get_percentile(0.5) * 1e6 << "us, "
+              << "p99 " << component->get_percentile(0.99) * 1e6 << "us"
+              << endl;
+    }
+}
+}
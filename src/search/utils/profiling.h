@@ -0,0 +1,113 @@
+#ifndef UTILS_PROFILING_H
+#define UTILS_PROFILING_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+  Lightweight instrumentation of hot code paths. A profiling scope measures
+  the time from its start to the end of the enclosing block and adds it to
+  the latency histogram of a named component:
+
+    void SuccessorGenerator::generate_applicable_ops(...) const {
+        PROFILE_SCOPE("successor generation");
+        ...
+    }
+
+  Scopes are only compiled in if the planner is built with the CMake option
+  USE_PROFILING. Otherwise, the macros expand to nothing and have no cost.
+  Times of nested scopes are included in the times of the enclosing scopes.
+  The histograms are not synchronized, so scopes must only be entered by
+  the main thread.
+*/
+
+namespace utils {
+class ProfilingComponent {
+    /*
+      Durations are counted in logarithmic buckets with four sub-buckets
+      per power of two, so percentiles have a relative error of at most
+      25%. Durations below 4 ns have their own buckets.
+    */
+    static const int NUM_BUCKETS = 4 * 63;
+
+    std::string name;
+    uint64_t count;
+    uint64_t total_ns;
+    std::array<uint64_t, NUM_BUCKETS> buckets;
+
+    static int get_bucket(uint64_t ns);
+    static uint64_t get_bucket_upper_bound(int bucket);
+public:
+    explicit ProfilingComponent(const std::string &name);
+
+    void add(uint64_t ns) {
+        ++count;
+        total_ns += ns;
+        ++buckets[get_bucket(ns)];
+    }
+
+    const std::string &get_name() const {
+        return name;
+    }
+
+    uint64_t get_count() const {
+        return count;
+    }
+
+    // Total time in seconds.
+    double get_total_time() const;
+
+    // Smallest bucket bound in seconds below which fraction p of the durations lie.
+    double get_percentile(double p) const;
+};
+
+class ProfilingScope {
+    ProfilingComponent &component;
+    std::chrono::steady_clock::time_point start;
+public:
+    explicit ProfilingScope(ProfilingComponent &component)
+        : component(component),
+          start(std::chrono::steady_clock::now()) {
+    }
+
+    ~ProfilingScope() {
+        component.add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - start).count());
+    }
+
+    ProfilingScope(const ProfilingScope &) = delete;
+    ProfilingScope &operator=(const ProfilingScope &) = delete;
+};
+
+/*
+  Return the component with the given name, creating it on first use.
+  References stay valid until the program ends.
+*/
+extern ProfilingComponent &get_profiling_component(const std::string &name);
+
+// All components that were entered at least once, sorted by name.
+extern std::vector<const ProfilingComponent *> get_profiling_components();
+
+extern void print_profiling_statistics();
+}
+
+#ifdef USE_PROFILING
+#define UTILS_PROFILING_CONCAT_(a, b) a ## b
+#define UTILS_PROFILING_CONCAT(a, b) UTILS_PROFILING_CONCAT_(a, b)
+
+#define PROFILE_COMPONENT_SCOPE(component) \
+    utils::ProfilingScope UTILS_PROFILING_CONCAT(profiling_scope_, __LINE__)(component)
+
+#define PROFILE_SCOPE(name) \
+    static utils::ProfilingComponent &UTILS_PROFILING_CONCAT(profiling_component_, __LINE__) = \
+        utils::get_profiling_component(name); \
+    PROFILE_COMPONENT_SCOPE(UTILS_PROFILING_CONCAT(profiling_component_, __LINE__))
+#else
+#define PROFILE_COMPONENT_SCOPE(component)
+#define PROFILE_SCOPE(name)
+#endif
+
+#endif
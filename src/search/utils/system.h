@@ -38,6 +38,7 @@ enum class ExitCode {
     */
     // 0-9: exit codes denoting a plan was found
     SUCCESS = 0,
+    SEARCH_PLAN_FOUND_AND_OUT_OF_MEMORY = 1,
 
     // 10-19: exit codes denoting no plan was found (without any error)
     SEARCH_UNSOLVABLE = 11,  // Task is provably unsolvable with given bound.
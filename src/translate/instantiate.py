@@ -2,12 +2,22 @@
 
 
 from collections import defaultdict
+import gc
+import multiprocessing
+import os
 
 import build_model
+import options
 import pddl_to_prolog
 import pddl
 import timers
 
+# Below this number of action and axiom atoms, starting worker processes
+# costs more than it saves.
+MIN_ATOMS_FOR_PARALLEL_GROUNDING = 1000
+# Use several chunks per worker to balance the load between the workers.
+CHUNKS_PER_WORKER = 4
+
 def get_fluent_facts(task, model):
     fluent_predicates = set()
     for action in task.actions:
@@ -29,6 +39,82 @@ def get_objects_by_type(typed_objects, types):
             result[type].append(obj.name)
     return result
 
+def _instantiate_atoms(task, atoms, init_facts, init_assignments,
+                       fluent_facts, type_to_objects):
+    instantiated_actions = []
+    instantiated_axioms = []
+    for atom in atoms:
+        if isinstance(atom.predicate, pddl.Action):
+            action = atom.predicate
+            variable_mapping = {par.name: arg
+                                for par, arg in zip(action.parameters, atom.args)}
+            inst_action = action.instantiate(
+                variable_mapping, init_facts, init_assignments,
+                fluent_facts, type_to_objects,
+                task.use_min_cost_metric)
+            if inst_action:
+                instantiated_actions.append(inst_action)
+        elif isinstance(atom.predicate, pddl.Axiom):
+            axiom = atom.predicate
+            variable_mapping = {par.name: arg
+                                for par, arg in zip(axiom.parameters, atom.args)}
+            inst_axiom = axiom.instantiate(variable_mapping, init_facts, fluent_facts)
+            if inst_axiom:
+                instantiated_axioms.append(inst_axiom)
+    return instantiated_actions, instantiated_axioms
+
+# Arguments of _instantiate_atoms for the worker processes. Workers are
+# forked, so they inherit the task and the model instead of unpickling them.
+_worker_arguments = None
+
+def _instantiate_chunk(chunk):
+    # The workers only allocate objects that they return, so collecting
+    # garbage would only cost time.
+    gc.disable()
+    task, atoms, *other_arguments = _worker_arguments
+    start, end = chunk
+    return _instantiate_atoms(task, atoms[start:end], *other_arguments)
+
+def _get_num_workers():
+    if options.grounding_workers == 1:
+        return 1
+    if "fork" not in multiprocessing.get_all_start_methods():
+        print("Parallel grounding needs the 'fork' start method, "
+              "grounding sequentially")
+        return 1
+    return options.grounding_workers or os.cpu_count() or 1
+
+def _instantiate_in_parallel(num_workers, task, atoms, *other_arguments):
+    """Instantiate the atoms in contiguous chunks on num_workers
+    processes. Concatenating the results in the order of the chunks
+    gives the same result as the sequential instantiation."""
+    global _worker_arguments
+    num_chunks = min(len(atoms), num_workers * CHUNKS_PER_WORKER)
+    bounds = [len(atoms) * i // num_chunks for i in range(num_chunks + 1)]
+    _worker_arguments = (task, atoms) + other_arguments
+    # Unpickling the results allocates many objects, which triggers
+    # frequent garbage collections that can take longer than the
+    # instantiation itself.
+    gc_was_enabled = gc.isenabled()
+    gc.disable()
+    try:
+        with multiprocessing.get_context("fork").Pool(num_workers) as pool:
+            results = pool.map(_instantiate_chunk, zip(bounds, bounds[1:]))
+    finally:
+        _worker_arguments = None
+        if gc_was_enabled:
+            # Without freezing, the garbage collector repeatedly scans
+            # the unpickled objects in the following translation steps.
+            # They are needed until the end of the translation anyway.
+            gc.freeze()
+            gc.enable()
+    instantiated_actions = []
+    instantiated_axioms = []
+    for actions, axioms in results:
+        instantiated_actions.extend(actions)
+        instantiated_axioms.extend(axioms)
+    return instantiated_actions, instantiated_axioms
+
 def instantiate(task, model):
     relaxed_reachable = False
     fluent_facts = get_fluent_facts(task, model)
@@ -42,8 +128,7 @@ def instantiate(task, model):
 
     type_to_objects = get_objects_by_type(task.objects, task.types)
 
-    instantiated_actions = []
-    instantiated_axioms = []
+    atoms_to_instantiate = []
     reachable_action_parameters = defaultdict(list)
     for atom in model:
         if isinstance(atom.predicate, pddl.Action):
@@ -56,24 +141,23 @@ def instantiate(task, model):
             # actions with the same name after normalization, and we
             # want to distinguish their instantiations.
             reachable_action_parameters[action].append(inst_parameters)
-            variable_mapping = {par.name: arg
-                                for par, arg in zip(parameters, atom.args)}
-            inst_action = action.instantiate(
-                variable_mapping, init_facts, init_assignments,
-                fluent_facts, type_to_objects,
-                task.use_min_cost_metric)
-            if inst_action:
-                instantiated_actions.append(inst_action)
+            atoms_to_instantiate.append(atom)
         elif isinstance(atom.predicate, pddl.Axiom):
-            axiom = atom.predicate
-            variable_mapping = {par.name: arg
-                                for par, arg in zip(axiom.parameters, atom.args)}
-            inst_axiom = axiom.instantiate(variable_mapping, init_facts, fluent_facts)
-            if inst_axiom:
-                instantiated_axioms.append(inst_axiom)
+            atoms_to_instantiate.append(atom)
         elif atom.predicate == "@goal-reachable":
             relaxed_reachable = True
 
+    num_workers = _get_num_workers()
+    arguments = (task, atoms_to_instantiate, init_facts, init_assignments,
+                 fluent_facts, type_to_objects)
+    if (num_workers > 1 and
+            len(atoms_to_instantiate) >= MIN_ATOMS_FOR_PARALLEL_GROUNDING):
+        instantiated_actions, instantiated_axioms = _instantiate_in_parallel(
+            num_workers, *arguments)
+    else:
+        instantiated_actions, instantiated_axioms = _instantiate_atoms(
+            *arguments)
+
     return (relaxed_reachable, fluent_facts, instantiated_actions,
             sorted(instantiated_axioms), reachable_action_parameters)
 
@@ -28,6 +28,16 @@ def parse_args():
     argparser.add_argument(
         "--sas-file", default="output.sas",
         help="path to the SAS output file (default: %(default)s)")
+    argparser.add_argument(
+        "--binary-output", action="store_true",
+        help="write the SAS file in a binary format that the search "
+        "component loads much faster than the textual format (the h2 "
+        "preprocessor only reads the textual format)")
+    argparser.add_argument(
+        "--grounding-workers", default=1, type=int,
+        help="number of processes for instantiating the reachable actions "
+        "and axioms (default: %(default)d, 0: one per CPU). The result does "
+        "not depend on the number of processes.")
     argparser.add_argument(
         "--invariant-generation-max-time", default=300, type=int,
         help="max time for invariant generation (default: %(default)ds)")
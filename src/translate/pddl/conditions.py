@@ -232,6 +232,10 @@ class Literal(Condition):
                 self.args == other.args)
     def __ne__(self, other):
         return not self == other
+    def __reduce__(self):
+        # Pickle literals compactly (e.g. for parallel grounding). The
+        # hash is recomputed when unpickling.
+        return (self.__class__, (self.predicate, self.args))
     @property
     def key(self):
         return str(self.predicate), self.args
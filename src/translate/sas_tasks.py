@@ -1,5 +1,13 @@
+import array
+import struct
+import sys
+
 SAS_FILE_VERSION = 3
 
+# See src/search/tasks/binary_task_file.h for a description of the format.
+SAS_BINARY_MAGIC = b"FDSASBIN"
+SAS_BINARY_FORMAT_VERSION = 1
+
 DEBUG = False
 
 
@@ -95,6 +103,33 @@ class SASTask:
         for axiom in self.axioms:
             axiom.output(stream)
 
+    def output_binary(self, stream):
+        """Write the task in the binary format, which the search
+        component reads much faster than the textual format."""
+        names = BinaryNameTable()
+        sections = []
+        for items in ([self.variables], self.mutexes, [self.init],
+                      [self.goal], self.operators, self.axioms):
+            ints = array.array("i")
+            for item in items:
+                item.output_binary(ints, names)
+            sections.append(_to_little_endian(ints).tobytes())
+        sections.append(names.to_bytes())
+
+        header = SAS_BINARY_MAGIC + struct.pack(
+            "<8i", SAS_BINARY_FORMAT_VERSION, int(self.metric),
+            len(self.variables.ranges), len(self.mutexes),
+            len(self.operators), len(self.axioms), len(names.names), 0)
+        offset = len(header) + 8 * len(sections)
+        offsets = []
+        for section in sections:
+            offsets.append(offset)
+            offset += len(section)
+        stream.write(header)
+        stream.write(struct.pack("<%dq" % len(offsets), *offsets))
+        for section in sections:
+            stream.write(section)
+
     def get_encoding_size(self):
         task_size = 0
         task_size += self.variables.get_encoding_size()
@@ -168,6 +203,13 @@ class SASVariables:
                 print(value, file=stream)
             print("end_variable", file=stream)
 
+    def output_binary(self, ints, names):
+        for var, (rang, axiom_layer, values) in enumerate(zip(
+                self.ranges, self.axiom_layers, self.value_names)):
+            assert rang == len(values), (rang, values)
+            ints.extend([names.get_id("var%d" % var), axiom_layer, rang])
+            ints.extend(names.get_id(value) for value in values)
+
     def get_encoding_size(self):
         # A variable with range k has encoding size k + 1 to also give the
         # variable itself some weight.
@@ -196,6 +238,9 @@ class SASMutexGroup:
             print(var, val, file=stream)
         print("end_mutex_group", file=stream)
 
+    def output_binary(self, ints, names):
+        _extend_with_facts(ints, self.facts)
+
     def get_encoding_size(self):
         return len(self.facts)
 
@@ -225,6 +270,9 @@ class SASInit:
             print(val, file=stream)
         print("end_state", file=stream)
 
+    def output_binary(self, ints, names):
+        ints.extend(self.values)
+
 
 class SASGoal:
     def __init__(self, pairs):
@@ -246,6 +294,9 @@ class SASGoal:
             print(var, val, file=stream)
         print("end_goal", file=stream)
 
+    def output_binary(self, ints, names):
+        _extend_with_facts(ints, self.pairs)
+
     def get_encoding_size(self):
         return len(self.pairs)
 
@@ -371,6 +422,14 @@ class SASOperator:
         print(self.cost, file=stream)
         print("end_operator", file=stream)
 
+    def output_binary(self, ints, names):
+        ints.extend([names.get_id(self.name[1:-1]), self.cost])
+        _extend_with_facts(ints, self.prevail)
+        ints.append(len(self.pre_post))
+        for var, pre, post, cond in self.pre_post:
+            _extend_with_facts(ints, cond)
+            ints.extend([var, pre, post])
+
     def get_encoding_size(self):
         size = 1 + len(self.prevail)
         for var, pre, post, cond in self.pre_post:
@@ -473,5 +532,44 @@ class SASAxiom:
         print(var, 1 - val, val, file=stream)
         print("end_rule", file=stream)
 
+    def output_binary(self, ints, names):
+        _extend_with_facts(ints, self.condition)
+        var, val = self.effect
+        ints.extend([var, 1 - val, val])
+
     def get_encoding_size(self):
         return 1 + len(self.condition)
+
+
+class BinaryNameTable:
+    """Interned names of the binary output format."""
+    def __init__(self):
+        self.names = []
+        self.ids = {}
+
+    def get_id(self, name):
+        name_id = self.ids.get(name)
+        if name_id is None:
+            name_id = len(self.names)
+            self.ids[name] = name_id
+            self.names.append(name)
+        return name_id
+
+    def to_bytes(self):
+        encoded_names = [name.encode("utf-8") for name in self.names]
+        offsets = array.array("q", [0])
+        for name in encoded_names:
+            offsets.append(offsets[-1] + len(name))
+        return _to_little_endian(offsets).tobytes() + b"".join(encoded_names)
+
+
+def _extend_with_facts(ints, facts):
+    ints.append(len(facts))
+    for var, val in facts:
+        ints.extend([var, val])
+
+
+def _to_little_endian(numbers):
+    if sys.byteorder == "big":
+        numbers.byteswap()
+    return numbers